@@ -0,0 +1,607 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <crux/adt/ring_buffer.hpp>
+
+namespace ia
+{
+  // Single-Producer Multi-Consumer broadcast ring: every attached reader sees every packet.
+  //
+  // One data region is shared by all readers, each of which owns a cache-line-padded cursor slot in the
+  // ControlBlock. The producer never overwrites data the slowest active reader has not consumed yet.
+  //
+  // Readers attach by posting a request that the producer accepts on its next write, starting the reader
+  // at the producer's published write cursor. This way the producer never has to guess the starting point
+  // of a reader it has not seen yet.
+  class BroadcastRingBufferView
+  {
+public:
+    using PacketHeader = RingBufferView::PacketHeader;
+    using PacketView = RingBufferView::PacketView;
+
+    static constexpr const u16 PACKET_ID_SKIP = RingBufferView::PACKET_ID_SKIP;
+    static constexpr const u32 MAX_CONSUMERS = 16;
+    static constexpr const u32 RECORD_ALIGNMENT = sizeof(PacketHeader);
+
+    static constexpr const u32 SLOT_STATE_FREE = 0;
+    static constexpr const u32 SLOT_STATE_PENDING = 1;
+    static constexpr const u32 SLOT_STATE_ACTIVE = 2;
+
+    struct alignas(64) ConsumerSlot
+    {
+      Mut<std::atomic<u64>> read_cursor{0};
+      Mut<std::atomic<u32>> state{SLOT_STATE_FREE};
+      Mut<u64> cached_write_cursor{0};
+    };
+
+    struct ControlBlock
+    {
+      struct alignas(64)
+      {
+        Mut<std::atomic<u64>> write_cursor{0};
+        Mut<u64> cached_min_read_cursor{0};
+        Mut<std::atomic<u32>> attach_requests{0};
+        Mut<u32> capacity{0};
+      } producer;
+
+      Mut<ConsumerSlot> consumers[MAX_CONSUMERS];
+    };
+
+    static_assert(offsetof(ControlBlock, consumers) == 64, "False sharing detected in ControlBlock");
+    static_assert(sizeof(ConsumerSlot) == 64, "False sharing detected in ConsumerSlot");
+    static_assert(MAX_CONSUMERS <= 32, "attach_requests is a 32 bit mask");
+
+    // Owns its consumer slot: move-only, and the slot is released when the Reader is destroyed. A Reader must
+    // not outlive the memory of the ring it was attached to.
+    class Reader
+    {
+  public:
+      Reader() = default;
+      ~Reader();
+
+      Reader(const Reader &) = delete;
+      Reader &operator=(const Reader &) = delete;
+
+      Reader(Reader &&other);
+      Reader &operator=(Reader &&other);
+
+      // Returns:
+      // - nullopt if empty (or not accepted by the producer yet)
+      // - bytes_read if success
+      // - Error if buffer too small
+      auto pop(MutRef<PacketHeader> out_header, Ref<Span<u8>> out_buffer) -> Result<Option<usize>>;
+
+      auto peek() -> Option<PacketView>;
+      auto consume() -> void;
+
+      template<typename Fn>
+      auto consume_all(ForwardRef<Fn> callback, const usize max_packets = std::numeric_limits<usize>::max())
+          -> usize;
+
+      // Releases the slot; the producer stops waiting for this reader
+      auto detach() -> void;
+
+      [[nodiscard]] auto is_active() -> bool;
+      [[nodiscard]] auto get_slot_index() const -> u32;
+
+  private:
+      friend class BroadcastRingBufferView;
+
+      Reader(Ref<BroadcastRingBufferView> ring, const u32 slot_index);
+
+      Mut<u8 *> m_data_ptr{};
+      Mut<u32> m_capacity{};
+      Mut<ConsumerSlot *> m_slot{};
+      Mut<ControlBlock *> m_control_block{};
+      Mut<u32> m_slot_index{};
+      Mut<bool> m_is_active{false};
+
+      Mut<bool> m_has_pending_read{false};
+      Mut<u64> m_pending_read_cursor{0};
+
+  private:
+      auto get_local_read_cursor() const -> u64;
+      auto reload_write_cursor() -> u64;
+      auto read_next_header(MutRef<u64> read, const u64 write, MutRef<PacketHeader> out_header) const -> bool;
+      auto release(const u64 read) -> void;
+    };
+
+public:
+    static auto default_instance() -> BroadcastRingBufferView;
+
+    static auto create(Ref<Span<u8>> buffer, const bool is_owner) -> Result<BroadcastRingBufferView>;
+    static auto create(ControlBlock *control_block, Ref<Span<u8>> buffer, const bool is_owner)
+        -> Result<BroadcastRingBufferView>;
+
+    // Producer side
+    auto push(const u16 packet_id, Ref<Span<const u8>> data) -> Result<void>;
+    auto reserve(const u16 packet_id, const usize size) -> Result<Span<u8>>;
+    auto commit() -> void;
+
+    // Consumer side. Claims a free slot; the reader receives every packet published after the
+    // producer accepts it.
+    auto attach() -> Result<Reader>;
+
+    auto get_control_block() -> ControlBlock *;
+
+    [[nodiscard]] auto is_valid() const -> bool;
+
+protected:
+    BroadcastRingBufferView(ControlBlock *control_block, u8 *data, const u32 capacity, const bool is_owner);
+
+private:
+    Mut<u8 *> m_data_ptr{};
+    Mut<u32> m_capacity{};
+    Mut<ControlBlock *> m_control_block{};
+
+    Mut<bool> m_has_pending_write{false};
+    Mut<u64> m_pending_write_cursor{0};
+
+private:
+    auto get_local_write_cursor() const -> u64;
+    auto accept_pending_readers() -> void;
+    auto reload_min_read_cursor() -> u64;
+
+    [[nodiscard]] static auto get_record_size(const usize payload_size) -> u32;
+  };
+
+  inline auto BroadcastRingBufferView::default_instance() -> BroadcastRingBufferView
+  {
+    return BroadcastRingBufferView(nullptr, nullptr, 0, false);
+  }
+
+  inline auto BroadcastRingBufferView::create(Ref<Span<u8>> buffer, const bool is_owner)
+      -> Result<BroadcastRingBufferView>
+  {
+    if (buffer.size() <= sizeof(ControlBlock) + RECORD_ALIGNMENT)
+    {
+      return fail("Buffer too small for ControlBlock");
+    }
+
+    return create(reinterpret_cast<ControlBlock *>(buffer.data()), buffer.subspan(sizeof(ControlBlock)), is_owner);
+  }
+
+  inline auto BroadcastRingBufferView::create(ControlBlock *control_block, Ref<Span<u8>> buffer, const bool is_owner)
+      -> Result<BroadcastRingBufferView>
+  {
+    if (control_block == nullptr)
+    {
+      return fail("ControlBlock is null");
+    }
+
+    const u32 capacity = static_cast<u32>(buffer.size()) & ~(RECORD_ALIGNMENT - 1);
+    if (capacity == 0)
+    {
+      return fail("Buffer is empty");
+    }
+
+    if (!is_owner && control_block->producer.capacity != capacity)
+    {
+      return fail("Capacity mismatch");
+    }
+
+    return BroadcastRingBufferView(control_block, buffer.data(), capacity, is_owner);
+  }
+
+  inline BroadcastRingBufferView::BroadcastRingBufferView(ControlBlock *control_block, u8 *data, const u32 capacity,
+                                                          const bool is_owner)
+  {
+    m_control_block = control_block;
+    m_data_ptr = data;
+    m_capacity = capacity;
+
+    if (is_owner)
+    {
+      m_control_block->producer.capacity = m_capacity;
+      m_control_block->producer.cached_min_read_cursor = 0;
+      m_control_block->producer.attach_requests.store(0, std::memory_order_relaxed);
+
+      for (auto &slot : m_control_block->consumers)
+      {
+        slot.read_cursor.store(0, std::memory_order_relaxed);
+        slot.cached_write_cursor = 0;
+        slot.state.store(SLOT_STATE_FREE, std::memory_order_relaxed);
+      }
+
+      m_control_block->producer.write_cursor.store(0, std::memory_order_release);
+    }
+  }
+
+  inline auto BroadcastRingBufferView::push(const u16 packet_id, Ref<Span<const u8>> data) -> Result<void>
+  {
+    const auto payload = reserve(packet_id, data.size());
+    if (!payload)
+    {
+      return fail("{}", payload.error());
+    }
+
+    if (!data.empty())
+    {
+      std::memcpy(payload->data(), data.data(), data.size());
+    }
+
+    commit();
+
+    return {};
+  }
+
+  inline auto BroadcastRingBufferView::reserve(const u16 packet_id, const usize size) -> Result<Span<u8>>
+  {
+    if (packet_id == PACKET_ID_SKIP)
+    {
+      return fail("Packet id {} is reserved", packet_id);
+    }
+
+    if (size > std::numeric_limits<u16>::max())
+    {
+      return fail("Data size exceeds u16 limit");
+    }
+
+    accept_pending_readers();
+
+    const u64 cap = m_capacity;
+    const u32 record_size = get_record_size(size);
+
+    Mut<u64> write = get_local_write_cursor();
+
+    // Records never straddle the end of the buffer, the tail is padded with a skip record instead
+    const u64 tail = cap - (write % cap);
+    const u64 padding = (tail < record_size) ? tail : 0;
+    const u64 end = write + padding + record_size;
+
+    if (end - m_control_block->producer.cached_min_read_cursor > cap && end - reload_min_read_cursor() > cap)
+    {
+      return fail("RingBuffer full");
+    }
+
+    if (padding > 0)
+    {
+      const PacketHeader skip_header{PACKET_ID_SKIP, static_cast<u16>(padding - sizeof(PacketHeader))};
+      std::memcpy(m_data_ptr + (write % cap), &skip_header, sizeof(PacketHeader));
+      write += padding;
+    }
+
+    const u64 offset = write % cap;
+    const PacketHeader header{packet_id, static_cast<u16>(size)};
+    std::memcpy(m_data_ptr + offset, &header, sizeof(PacketHeader));
+
+    m_pending_write_cursor = end;
+    m_has_pending_write = true;
+
+    return Span<u8>(m_data_ptr + offset + sizeof(PacketHeader), size);
+  }
+
+  inline auto BroadcastRingBufferView::commit() -> void
+  {
+    if (!m_has_pending_write)
+    {
+      return;
+    }
+
+    m_control_block->producer.write_cursor.store(m_pending_write_cursor, std::memory_order_release);
+    m_has_pending_write = false;
+  }
+
+  inline auto BroadcastRingBufferView::attach() -> Result<Reader>
+  {
+    for (Mut<u32> i = 0; i < MAX_CONSUMERS; i++)
+    {
+      Mut<u32> expected = SLOT_STATE_FREE;
+      if (m_control_block->consumers[i].state.compare_exchange_strong(expected, SLOT_STATE_PENDING,
+                                                                      std::memory_order_acq_rel))
+      {
+        m_control_block->producer.attach_requests.fetch_or(1u << i, std::memory_order_release);
+        return Reader(*this, i);
+      }
+    }
+
+    return fail("All {} consumer slots are in use", MAX_CONSUMERS);
+  }
+
+  inline auto BroadcastRingBufferView::get_control_block() -> ControlBlock *
+  {
+    return m_control_block;
+  }
+
+  inline auto BroadcastRingBufferView::get_local_write_cursor() const -> u64
+  {
+    if (m_has_pending_write)
+    {
+      return m_pending_write_cursor;
+    }
+
+    return m_control_block->producer.write_cursor.load(std::memory_order_relaxed);
+  }
+
+  inline auto BroadcastRingBufferView::accept_pending_readers() -> void
+  {
+    if (m_control_block->producer.attach_requests.load(std::memory_order_relaxed) == 0)
+    {
+      return;
+    }
+
+    const u32 requests = m_control_block->producer.attach_requests.exchange(0, std::memory_order_acquire);
+
+    // New readers start at the last published packet, which is never behind cached_min_read_cursor
+    const u64 write = m_control_block->producer.write_cursor.load(std::memory_order_relaxed);
+
+    for (Mut<u32> i = 0; i < MAX_CONSUMERS; i++)
+    {
+      if ((requests & (1u << i)) == 0)
+      {
+        continue;
+      }
+
+      auto &slot = m_control_block->consumers[i];
+      slot.read_cursor.store(write, std::memory_order_relaxed);
+      slot.cached_write_cursor = write;
+
+      Mut<u32> expected = SLOT_STATE_PENDING;
+      slot.state.compare_exchange_strong(expected, SLOT_STATE_ACTIVE, std::memory_order_release);
+    }
+  }
+
+  inline auto BroadcastRingBufferView::reload_min_read_cursor() -> u64
+  {
+    Mut<u64> min_read = get_local_write_cursor();
+
+    for (const auto &slot : m_control_block->consumers)
+    {
+      if (slot.state.load(std::memory_order_acquire) == SLOT_STATE_ACTIVE)
+      {
+        min_read = std::min(min_read, slot.read_cursor.load(std::memory_order_acquire));
+      }
+    }
+
+    m_control_block->producer.cached_min_read_cursor = min_read;
+    return min_read;
+  }
+
+  inline auto BroadcastRingBufferView::get_record_size(const usize payload_size) -> u32
+  {
+    const u32 size = sizeof(PacketHeader) + static_cast<u32>(payload_size);
+    return (size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+  }
+
+  [[nodiscard]] inline auto BroadcastRingBufferView::is_valid() const -> bool
+  {
+    return m_control_block && m_data_ptr && m_capacity;
+  }
+
+  inline BroadcastRingBufferView::Reader::Reader(Ref<BroadcastRingBufferView> ring, const u32 slot_index)
+  {
+    m_data_ptr = ring.m_data_ptr;
+    m_capacity = ring.m_capacity;
+    m_control_block = ring.m_control_block;
+    m_slot = &ring.m_control_block->consumers[slot_index];
+    m_slot_index = slot_index;
+  }
+
+  inline BroadcastRingBufferView::Reader::~Reader()
+  {
+    detach();
+  }
+
+  inline BroadcastRingBufferView::Reader::Reader(Reader &&other)
+  {
+    *this = std::move(other);
+  }
+
+  inline BroadcastRingBufferView::Reader &BroadcastRingBufferView::Reader::operator=(Reader &&other)
+  {
+    if (this != &other)
+    {
+      detach();
+
+      m_data_ptr = other.m_data_ptr;
+      m_capacity = other.m_capacity;
+      m_slot = std::exchange(other.m_slot, nullptr);
+      m_control_block = other.m_control_block;
+      m_slot_index = other.m_slot_index;
+      m_is_active = std::exchange(other.m_is_active, false);
+      m_has_pending_read = std::exchange(other.m_has_pending_read, false);
+      m_pending_read_cursor = other.m_pending_read_cursor;
+    }
+    return *this;
+  }
+
+  inline auto BroadcastRingBufferView::Reader::pop(MutRef<PacketHeader> out_header, Ref<Span<u8>> out_buffer)
+      -> Result<Option<usize>>
+  {
+    const bool had_pending_read = m_has_pending_read;
+    const u64 previous_pending_read = m_pending_read_cursor;
+
+    const auto packet = peek();
+    if (!packet)
+    {
+      consume();
+      return std::nullopt;
+    }
+
+    out_header = packet->header;
+
+    if (out_header.payload_size > out_buffer.size())
+    {
+      m_has_pending_read = had_pending_read;
+      m_pending_read_cursor = previous_pending_read;
+      return fail("Buffer too small: needed {}, provided {}", out_header.payload_size, out_buffer.size());
+    }
+
+    if (!packet->first.empty())
+    {
+      std::memcpy(out_buffer.data(), packet->first.data(), packet->first.size());
+    }
+
+    consume();
+
+    return std::make_optional(static_cast<usize>(out_header.payload_size));
+  }
+
+  inline auto BroadcastRingBufferView::Reader::peek() -> Option<PacketView>
+  {
+    if (!is_active())
+    {
+      return std::nullopt;
+    }
+
+    const u64 initial_read = get_local_read_cursor();
+
+    Mut<u64> read = initial_read;
+    Mut<PacketView> packet;
+    if (!read_next_header(read, m_slot->cached_write_cursor, packet.header) &&
+        !read_next_header(read, reload_write_cursor(), packet.header))
+    {
+      // Skip records are released together with the next consume()
+      if (read != initial_read)
+      {
+        m_pending_read_cursor = read;
+        m_has_pending_read = true;
+      }
+      return std::nullopt;
+    }
+
+    const u64 offset = read % m_capacity;
+    packet.first = Span<const u8>(m_data_ptr + offset + sizeof(PacketHeader), packet.header.payload_size);
+
+    m_pending_read_cursor = read + get_record_size(packet.header.payload_size);
+    m_has_pending_read = true;
+
+    return packet;
+  }
+
+  inline auto BroadcastRingBufferView::Reader::consume() -> void
+  {
+    if (!m_has_pending_read)
+    {
+      return;
+    }
+
+    release(m_pending_read_cursor);
+  }
+
+  template<typename Fn>
+  inline auto BroadcastRingBufferView::Reader::consume_all(ForwardRef<Fn> callback, const usize max_packets) -> usize
+  {
+    if (!is_active())
+    {
+      return 0;
+    }
+
+    Mut<u64> write = m_slot->cached_write_cursor;
+    const u64 initial_read = get_local_read_cursor();
+
+    Mut<u64> read = initial_read;
+    Mut<usize> consumed = 0;
+    Mut<PacketView> packet;
+
+    while (consumed < max_packets)
+    {
+      // Only go back to the producer's cache line once the known packets run out
+      if (!read_next_header(read, write, packet.header))
+      {
+        write = reload_write_cursor();
+        if (!read_next_header(read, write, packet.header))
+        {
+          break;
+        }
+      }
+
+      const u64 offset = read % m_capacity;
+      packet.first = Span<const u8>(m_data_ptr + offset + sizeof(PacketHeader), packet.header.payload_size);
+      callback(static_cast<Ref<PacketView>>(packet));
+
+      read += get_record_size(packet.header.payload_size);
+      consumed++;
+    }
+
+    if (read != initial_read)
+    {
+      release(read);
+    }
+
+    return consumed;
+  }
+
+  inline auto BroadcastRingBufferView::Reader::detach() -> void
+  {
+    if (m_slot == nullptr)
+    {
+      return;
+    }
+
+    m_slot->state.store(SLOT_STATE_FREE, std::memory_order_release);
+    m_slot = nullptr;
+    m_is_active = false;
+    m_has_pending_read = false;
+  }
+
+  [[nodiscard]] inline auto BroadcastRingBufferView::Reader::is_active() -> bool
+  {
+    if (!m_is_active && m_slot != nullptr)
+    {
+      m_is_active = m_slot->state.load(std::memory_order_acquire) == SLOT_STATE_ACTIVE;
+    }
+
+    return m_is_active;
+  }
+
+  [[nodiscard]] inline auto BroadcastRingBufferView::Reader::get_slot_index() const -> u32
+  {
+    return m_slot_index;
+  }
+
+  inline auto BroadcastRingBufferView::Reader::get_local_read_cursor() const -> u64
+  {
+    if (m_has_pending_read)
+    {
+      return m_pending_read_cursor;
+    }
+
+    return m_slot->read_cursor.load(std::memory_order_relaxed);
+  }
+
+  inline auto BroadcastRingBufferView::Reader::reload_write_cursor() -> u64
+  {
+    const u64 write = m_control_block->producer.write_cursor.load(std::memory_order_acquire);
+    m_slot->cached_write_cursor = write;
+    return write;
+  }
+
+  inline auto BroadcastRingBufferView::Reader::read_next_header(MutRef<u64> read, const u64 write,
+                                                                MutRef<PacketHeader> out_header) const -> bool
+  {
+    while (read != write)
+    {
+      std::memcpy(&out_header, m_data_ptr + (read % m_capacity), sizeof(PacketHeader));
+
+      if (out_header.id != PACKET_ID_SKIP)
+      {
+        return true;
+      }
+
+      read += sizeof(PacketHeader) + out_header.payload_size;
+    }
+
+    return false;
+  }
+
+  inline auto BroadcastRingBufferView::Reader::release(const u64 read) -> void
+  {
+    m_slot->read_cursor.store(read, std::memory_order_release);
+    m_has_pending_read = false;
+  }
+} // namespace ia
@@ -0,0 +1,188 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <crux/adt/ring_buffer.hpp>
+
+#include <array>
+#include <new>
+#include <type_traits>
+
+namespace ia
+{
+  // Typed view over a RingBufferView that carries a fixed set of message types.
+  //
+  // Each type gets packet id (index in Msgs + 1). Messages are constructed in place in the ring and handed to the
+  // handlers by reference into the ring, dispatched through a constexpr table indexed by packet id.
+  //
+  // The channel keeps every record a multiple of 4 bytes, so it must be the only writer of its ring and the
+  // capacity must be a multiple of 4 (buffers from Vec or mmap are suitably aligned). Types aligned to more than 4
+  // bytes get a few bytes of slack to align the message inside the payload.
+  template<typename... Msgs> class Channel
+  {
+public:
+    static constexpr const usize MESSAGE_COUNT = sizeof...(Msgs);
+    static constexpr const usize RECORD_ALIGNMENT = alignof(RingBufferView::PacketHeader);
+
+    static_assert(MESSAGE_COUNT > 0, "Channel needs at least one message type");
+    static_assert(MESSAGE_COUNT < RingBufferView::PACKET_ID_FRAGMENT - 1, "Too many message types");
+    static_assert((std::is_trivially_copyable_v<Msgs> && ...), "Channel messages must be trivially copyable");
+
+    template<typename T> static constexpr auto get_id() -> u16;
+
+public:
+    static auto create(Ref<RingBufferView> ring) -> Result<Channel>;
+
+    // Constructs a T in place and publishes it
+    template<typename T, typename... Args> auto emplace(ForwardRef<Args>... args) -> Result<void>;
+
+    template<typename T> auto push(Ref<T> message) -> Result<void>;
+
+    // Calls handler(Ref<T>) for every pending message (up to max_messages), with T resolved through the jump table.
+    // Packets with ids outside the channel are skipped. Returns the number of packets consumed.
+    template<typename Handler>
+    auto dispatch(ForwardRef<Handler> handler, const usize max_messages = std::numeric_limits<usize>::max()) -> usize;
+
+    auto get_ring() -> RingBufferView &;
+
+protected:
+    Channel(Ref<RingBufferView> ring);
+
+private:
+    Mut<RingBufferView> m_ring;
+
+private:
+    template<typename T> static constexpr auto get_index() -> usize;
+
+    // Bytes reserved for a T: the slack needed to align it, rounded up to whole records
+    template<typename T> static constexpr auto get_payload_size() -> usize;
+
+    template<typename T> static auto align_payload(u8 *payload) -> u8 *;
+
+    template<typename Handler, typename T> static auto invoke(MutRef<Handler> handler, const u8 *payload) -> void;
+
+    template<typename Handler> using Thunk = void (*)(MutRef<Handler>, const u8 *);
+
+    template<typename Handler>
+    static constexpr const std::array<Thunk<Handler>, MESSAGE_COUNT> JUMP_TABLE = {&invoke<Handler, Msgs>...};
+  };
+
+  template<typename... Msgs> template<typename T> constexpr auto Channel<Msgs...>::get_index() -> usize
+  {
+    static_assert((std::is_same_v<T, Msgs> + ...) == 1, "Type must appear exactly once in the Channel");
+
+    constexpr std::array<bool, MESSAGE_COUNT> matches = {std::is_same_v<T, Msgs>...};
+    for (Mut<usize> i = 0; i < MESSAGE_COUNT; i++)
+    {
+      if (matches[i])
+      {
+        return i;
+      }
+    }
+    return MESSAGE_COUNT;
+  }
+
+  template<typename... Msgs> template<typename T> constexpr auto Channel<Msgs...>::get_id() -> u16
+  {
+    // 0 is PACKET_ID_SKIP
+    return static_cast<u16>(get_index<T>() + 1);
+  }
+
+  template<typename... Msgs> template<typename T> constexpr auto Channel<Msgs...>::get_payload_size() -> usize
+  {
+    const usize slack = alignof(T) > RECORD_ALIGNMENT ? alignof(T) - RECORD_ALIGNMENT : 0;
+    const usize size = sizeof(T) + slack;
+
+    // Header + payload stays a multiple of RECORD_ALIGNMENT, so every payload starts 4-byte aligned
+    return (size + RECORD_ALIGNMENT - 1) / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+  }
+
+  template<typename... Msgs> template<typename T> inline auto Channel<Msgs...>::align_payload(u8 *payload) -> u8 *
+  {
+    const usize address = reinterpret_cast<usize>(payload);
+    return payload + ((alignof(T) - address % alignof(T)) % alignof(T));
+  }
+
+  template<typename... Msgs>
+  template<typename Handler, typename T>
+  inline auto Channel<Msgs...>::invoke(MutRef<Handler> handler, const u8 *payload) -> void
+  {
+    const u8 *message = align_payload<T>(const_cast<u8 *>(payload));
+    handler(*std::launder(reinterpret_cast<const T *>(message)));
+  }
+
+  template<typename... Msgs> inline auto Channel<Msgs...>::create(Ref<RingBufferView> ring) -> Result<Channel>
+  {
+    if (!ring.is_valid())
+    {
+      return fail("RingBuffer is not valid");
+    }
+
+    if (ring.get_capacity() % RECORD_ALIGNMENT != 0)
+    {
+      return fail("Channel needs a capacity that is a multiple of {}, got {}", RECORD_ALIGNMENT, ring.get_capacity());
+    }
+
+    return Channel(ring);
+  }
+
+  template<typename... Msgs> inline Channel<Msgs...>::Channel(Ref<RingBufferView> ring) : m_ring(ring)
+  {
+  }
+
+  template<typename... Msgs>
+  template<typename T, typename... Args>
+  inline auto Channel<Msgs...>::emplace(ForwardRef<Args>... args) -> Result<void>
+  {
+    static_assert(get_payload_size<T>() <= std::numeric_limits<u16>::max(), "Message too large for one packet");
+
+    auto payload = m_ring.reserve(get_id<T>(), get_payload_size<T>());
+    if (!payload)
+    {
+      return fail("{}", payload.error());
+    }
+
+    new (align_payload<T>(payload->data())) T{std::forward<Args>(args)...};
+    m_ring.commit();
+
+    return {};
+  }
+
+  template<typename... Msgs> template<typename T> inline auto Channel<Msgs...>::push(Ref<T> message) -> Result<void>
+  {
+    return emplace<T>(message);
+  }
+
+  template<typename... Msgs>
+  template<typename Handler>
+  inline auto Channel<Msgs...>::dispatch(ForwardRef<Handler> handler, const usize max_messages) -> usize
+  {
+    return m_ring.consume_all(
+        [&](Ref<RingBufferView::PacketView> packet) {
+          const usize index = static_cast<usize>(packet.header.id) - 1;
+          if (index < MESSAGE_COUNT)
+          {
+            JUMP_TABLE<std::remove_reference_t<Handler>>[index](handler, packet.first.data());
+          }
+        },
+        max_messages);
+  }
+
+  template<typename... Msgs> inline auto Channel<Msgs...>::get_ring() -> RingBufferView &
+  {
+    return m_ring;
+  }
+} // namespace ia
@@ -0,0 +1,184 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <crux/crux.hpp>
+
+#include <atomic>
+#include <bit>
+#include <new>
+#include <type_traits>
+
+namespace ia
+{
+  // Bounded Multi-Producer Multi-Consumer queue of T, for handing objects between threads of one process.
+  //
+  // Every slot carries a sequence number that says whose turn it is: a producer at cursor c may fill the slot once
+  // its sequence is c, and publishes it by setting it to c + 1; a consumer takes it at c + 1 and hands it back to
+  // the next lap by setting it to c + N. Both cursors are claimed with a single CAS and sit on their own cache line.
+  template<typename T, usize N> class MpmcQueue
+  {
+public:
+    static constexpr const usize CAPACITY = N;
+
+    static_assert(N > 0 && std::has_single_bit(N), "MpmcQueue capacity must be a power of two");
+    static_assert(std::is_nothrow_move_constructible_v<T>, "MpmcQueue elements must be nothrow move constructible");
+
+public:
+    MpmcQueue();
+    ~MpmcQueue();
+
+    MpmcQueue(const MpmcQueue &) = delete;
+    MpmcQueue &operator=(const MpmcQueue &) = delete;
+
+    // Safe to call concurrently from any number of threads.
+    // Returns false (leaving the arguments untouched) if the queue is full.
+    template<typename... Args> auto emplace(ForwardRef<Args>... args) -> bool;
+    auto push(Ref<T> value) -> bool;
+    auto push(T &&value) -> bool;
+
+    // Safe to call concurrently from any number of threads. Returns nullopt if the queue is empty.
+    auto pop() -> Option<T>;
+
+    // Snapshots, approximate while other threads are pushing or popping
+    [[nodiscard]] auto get_size() const -> usize;
+    [[nodiscard]] auto is_empty() const -> bool;
+
+private:
+    static constexpr const u64 MASK = N - 1;
+
+    struct Slot
+    {
+      Mut<std::atomic<u64>> sequence{0};
+      alignas(T) Mut<u8> storage[sizeof(T)];
+    };
+
+    alignas(64) Mut<std::atomic<u64>> m_write_cursor{0};
+    alignas(64) Mut<std::atomic<u64>> m_read_cursor{0};
+
+    alignas(64) Mut<Slot> m_slots[N];
+  };
+
+  template<typename T, usize N> inline MpmcQueue<T, N>::MpmcQueue()
+  {
+    for (Mut<u64> i = 0; i < N; i++)
+    {
+      m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  template<typename T, usize N> inline MpmcQueue<T, N>::~MpmcQueue()
+  {
+    while (pop().has_value())
+    {
+    }
+  }
+
+  template<typename T, usize N>
+  template<typename... Args>
+  inline auto MpmcQueue<T, N>::emplace(ForwardRef<Args>... args) -> bool
+  {
+    Mut<u64> write = m_write_cursor.load(std::memory_order_relaxed);
+    Mut<Slot *> slot = nullptr;
+
+    while (true)
+    {
+      slot = &m_slots[write & MASK];
+      const u64 sequence = slot->sequence.load(std::memory_order_acquire);
+
+      if (sequence == write)
+      {
+        if (m_write_cursor.compare_exchange_weak(write, write + 1, std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if (sequence < write)
+      {
+        // The slot still holds the element from the previous lap
+        return false;
+      }
+      else
+      {
+        write = m_write_cursor.load(std::memory_order_relaxed);
+      }
+    }
+
+    new (slot->storage) T(std::forward<Args>(args)...);
+    slot->sequence.store(write + 1, std::memory_order_release);
+
+    return true;
+  }
+
+  template<typename T, usize N> inline auto MpmcQueue<T, N>::push(Ref<T> value) -> bool
+  {
+    return emplace(value);
+  }
+
+  template<typename T, usize N> inline auto MpmcQueue<T, N>::push(T &&value) -> bool
+  {
+    return emplace(std::move(value));
+  }
+
+  template<typename T, usize N> inline auto MpmcQueue<T, N>::pop() -> Option<T>
+  {
+    Mut<u64> read = m_read_cursor.load(std::memory_order_relaxed);
+    Mut<Slot *> slot = nullptr;
+
+    while (true)
+    {
+      slot = &m_slots[read & MASK];
+      const u64 sequence = slot->sequence.load(std::memory_order_acquire);
+
+      if (sequence == read + 1)
+      {
+        if (m_read_cursor.compare_exchange_weak(read, read + 1, std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if (sequence < read + 1)
+      {
+        // Not published yet
+        return std::nullopt;
+      }
+      else
+      {
+        read = m_read_cursor.load(std::memory_order_relaxed);
+      }
+    }
+
+    T *element = std::launder(reinterpret_cast<T *>(slot->storage));
+    Mut<Option<T>> value{std::move(*element)};
+    element->~T();
+
+    slot->sequence.store(read + N, std::memory_order_release);
+
+    return value;
+  }
+
+  template<typename T, usize N> inline auto MpmcQueue<T, N>::get_size() const -> usize
+  {
+    const u64 read = m_read_cursor.load(std::memory_order_acquire);
+    const u64 write = m_write_cursor.load(std::memory_order_acquire);
+    return write > read ? static_cast<usize>(write - read) : 0;
+  }
+
+  template<typename T, usize N> inline auto MpmcQueue<T, N>::is_empty() const -> bool
+  {
+    return get_size() == 0;
+  }
+} // namespace ia
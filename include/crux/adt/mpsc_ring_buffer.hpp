@@ -0,0 +1,387 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <crux/adt/ring_buffer.hpp>
+
+namespace ia
+{
+  // Multi-Producer Single-Consumer counterpart of RingBufferView, using the same PacketHeader framing.
+  //
+  // Producers claim space with a CAS on a monotonic 64-bit write cursor and then fill their record
+  // independently. Every record starts with a commit word that stays 0 until the record is fully written,
+  // so the consumer never observes a partially written packet. The consumer zeroes each record it
+  // releases, which guarantees that a non-zero commit word always belongs to a committed record.
+  class MpscRingBufferView
+  {
+public:
+    using PacketHeader = RingBufferView::PacketHeader;
+    using PacketView = RingBufferView::PacketView;
+
+    static constexpr const u16 PACKET_ID_SKIP = RingBufferView::PACKET_ID_SKIP;
+    static constexpr const u32 RECORD_ALIGNMENT = 8;
+
+    struct ControlBlock
+    {
+      struct alignas(64)
+      {
+        Mut<std::atomic<u64>> write_cursor{0};
+        Mut<std::atomic<u64>> cached_read_cursor{0};
+      } producer;
+
+      struct alignas(64)
+      {
+        Mut<std::atomic<u64>> read_cursor{0};
+        Mut<u32> capacity{0};
+      } consumer;
+    };
+
+    static_assert(offsetof(ControlBlock, consumer) == 64, "False sharing detected in ControlBlock");
+
+    struct RecordHeader
+    {
+      // Size of the whole record (header, payload and alignment padding), 0 while it is being written
+      Mut<u32> committed_size{};
+      Mut<PacketHeader> packet{};
+    };
+
+    static_assert(sizeof(RecordHeader) == RECORD_ALIGNMENT, "RecordHeader must keep records aligned");
+
+    struct Reservation
+    {
+      Mut<Span<u8>> payload{};
+      Mut<u32> offset{};
+      Mut<u32> record_size{};
+    };
+
+public:
+    static auto default_instance() -> MpscRingBufferView;
+
+    static auto create(Ref<Span<u8>> buffer, const bool is_owner) -> Result<MpscRingBufferView>;
+    static auto create(ControlBlock *control_block, Ref<Span<u8>> buffer, const bool is_owner)
+        -> Result<MpscRingBufferView>;
+
+    // Producer side, safe to call concurrently from any number of threads or processes
+    auto push(const u16 packet_id, Ref<Span<const u8>> data) -> Result<void>;
+
+    // Zero-copy producer path. The payload span is always contiguous, and the packet becomes visible
+    // to the consumer once commit() is called with the returned reservation.
+    auto reserve(const u16 packet_id, const usize size) -> Result<Reservation>;
+    auto commit(Ref<Reservation> reservation) -> void;
+
+    // Consumer side, single consumer only.
+    // A record that was claimed but not committed yet holds back every record behind it.
+    //
+    // Returns:
+    // - nullopt if empty
+    // - bytes_read if success
+    // - Error if buffer too small
+    auto pop(MutRef<PacketHeader> out_header, Ref<Span<u8>> out_buffer) -> Result<Option<usize>>;
+
+    // Hands every committed packet (up to max_packets) to callback(Ref<PacketView>) in place and
+    // releases them with a single store. Returns the number of packets consumed.
+    template<typename Fn>
+    auto consume_all(ForwardRef<Fn> callback, const usize max_packets = std::numeric_limits<usize>::max()) -> usize;
+
+    auto get_control_block() -> ControlBlock *;
+
+    [[nodiscard]] auto is_valid() const -> bool;
+
+protected:
+    MpscRingBufferView(ControlBlock *control_block, u8 *data, const u32 capacity, const bool is_owner);
+
+private:
+    Mut<u8 *> m_data_ptr{};
+    Mut<u32> m_capacity{};
+    Mut<ControlBlock *> m_control_block{};
+
+private:
+    // Claims record_size contiguous bytes, padding the tail of the buffer with a skip record if needed.
+    // Returns the cursor of the claimed record, or nullopt if the ring is full.
+    auto claim(const u32 record_size) -> Option<u64>;
+
+    auto commit_word(const u32 offset) -> std::atomic_ref<u32>;
+    auto get_record_size(const usize payload_size) const -> u32;
+  };
+
+  inline auto MpscRingBufferView::default_instance() -> MpscRingBufferView
+  {
+    return MpscRingBufferView(nullptr, nullptr, 0, false);
+  }
+
+  inline auto MpscRingBufferView::create(Ref<Span<u8>> buffer, const bool is_owner) -> Result<MpscRingBufferView>
+  {
+    if (buffer.size() <= sizeof(ControlBlock) + RECORD_ALIGNMENT)
+    {
+      return fail("Buffer too small for ControlBlock");
+    }
+
+    return create(reinterpret_cast<ControlBlock *>(buffer.data()), buffer.subspan(sizeof(ControlBlock)), is_owner);
+  }
+
+  inline auto MpscRingBufferView::create(ControlBlock *control_block, Ref<Span<u8>> buffer, const bool is_owner)
+      -> Result<MpscRingBufferView>
+  {
+    if (control_block == nullptr)
+    {
+      return fail("ControlBlock is null");
+    }
+    if (reinterpret_cast<usize>(buffer.data()) % RECORD_ALIGNMENT != 0)
+    {
+      return fail("Buffer must be {} byte aligned", RECORD_ALIGNMENT);
+    }
+
+    const u32 capacity = static_cast<u32>(buffer.size()) & ~(RECORD_ALIGNMENT - 1);
+    if (capacity == 0)
+    {
+      return fail("Buffer is empty");
+    }
+
+    if (!is_owner && control_block->consumer.capacity != capacity)
+    {
+      return fail("Capacity mismatch");
+    }
+
+    return MpscRingBufferView(control_block, buffer.data(), capacity, is_owner);
+  }
+
+  inline MpscRingBufferView::MpscRingBufferView(ControlBlock *control_block, u8 *data, const u32 capacity,
+                                                const bool is_owner)
+  {
+    m_control_block = control_block;
+    m_data_ptr = data;
+    m_capacity = capacity;
+
+    if (is_owner)
+    {
+      // Commit words are only meaningful on zeroed memory
+      std::memset(m_data_ptr, 0, m_capacity);
+
+      m_control_block->consumer.capacity = m_capacity;
+      m_control_block->producer.cached_read_cursor.store(0, std::memory_order_relaxed);
+      m_control_block->producer.write_cursor.store(0, std::memory_order_release);
+      m_control_block->consumer.read_cursor.store(0, std::memory_order_release);
+    }
+  }
+
+  inline auto MpscRingBufferView::push(const u16 packet_id, Ref<Span<const u8>> data) -> Result<void>
+  {
+    const auto reservation = reserve(packet_id, data.size());
+    if (!reservation)
+    {
+      return fail("{}", reservation.error());
+    }
+
+    if (!data.empty())
+    {
+      std::memcpy(reservation->payload.data(), data.data(), data.size());
+    }
+
+    commit(*reservation);
+
+    return {};
+  }
+
+  inline auto MpscRingBufferView::reserve(const u16 packet_id, const usize size) -> Result<Reservation>
+  {
+    if (packet_id == PACKET_ID_SKIP)
+    {
+      return fail("Packet id {} is reserved", packet_id);
+    }
+
+    if (size > std::numeric_limits<u16>::max())
+    {
+      return fail("Data size exceeds u16 limit");
+    }
+
+    const u32 record_size = get_record_size(size);
+
+    const auto cursor = claim(record_size);
+    if (!cursor)
+    {
+      return fail("RingBuffer full");
+    }
+
+    const u32 offset = static_cast<u32>(*cursor % m_capacity);
+
+    auto *record = reinterpret_cast<RecordHeader *>(m_data_ptr + offset);
+    record->packet = PacketHeader{packet_id, static_cast<u16>(size)};
+
+    return Reservation{
+        .payload = Span<u8>(m_data_ptr + offset + sizeof(RecordHeader), size),
+        .offset = offset,
+        .record_size = record_size,
+    };
+  }
+
+  inline auto MpscRingBufferView::commit(Ref<Reservation> reservation) -> void
+  {
+    commit_word(reservation.offset).store(reservation.record_size, std::memory_order_release);
+  }
+
+  inline auto MpscRingBufferView::pop(MutRef<PacketHeader> out_header, Ref<Span<u8>> out_buffer)
+      -> Result<Option<usize>>
+  {
+    const u64 initial_read = m_control_block->consumer.read_cursor.load(std::memory_order_relaxed);
+
+    Mut<u64> read = initial_read;
+    Mut<u32> offset = 0;
+    Mut<u32> record_size = 0;
+
+    while (true)
+    {
+      offset = static_cast<u32>(read % m_capacity);
+      record_size = commit_word(offset).load(std::memory_order_acquire);
+
+      if (record_size == 0)
+      {
+        if (read != initial_read)
+        {
+          m_control_block->consumer.read_cursor.store(read, std::memory_order_release);
+        }
+        return std::nullopt;
+      }
+
+      out_header = reinterpret_cast<const RecordHeader *>(m_data_ptr + offset)->packet;
+      if (out_header.id != PACKET_ID_SKIP)
+      {
+        break;
+      }
+
+      std::memset(m_data_ptr + offset, 0, record_size);
+      read += record_size;
+    }
+
+    if (out_header.payload_size > out_buffer.size())
+    {
+      if (read != initial_read)
+      {
+        m_control_block->consumer.read_cursor.store(read, std::memory_order_release);
+      }
+      return fail("Buffer too small: needed {}, provided {}", out_header.payload_size, out_buffer.size());
+    }
+
+    if (out_header.payload_size > 0)
+    {
+      std::memcpy(out_buffer.data(), m_data_ptr + offset + sizeof(RecordHeader), out_header.payload_size);
+    }
+
+    std::memset(m_data_ptr + offset, 0, record_size);
+    m_control_block->consumer.read_cursor.store(read + record_size, std::memory_order_release);
+
+    return std::make_optional(static_cast<usize>(out_header.payload_size));
+  }
+
+  template<typename Fn>
+  inline auto MpscRingBufferView::consume_all(ForwardRef<Fn> callback, const usize max_packets) -> usize
+  {
+    const u64 initial_read = m_control_block->consumer.read_cursor.load(std::memory_order_relaxed);
+
+    Mut<u64> read = initial_read;
+    Mut<usize> consumed = 0;
+    Mut<PacketView> packet;
+
+    while (consumed < max_packets)
+    {
+      const u32 offset = static_cast<u32>(read % m_capacity);
+      const u32 record_size = commit_word(offset).load(std::memory_order_acquire);
+
+      if (record_size == 0)
+      {
+        break;
+      }
+
+      packet.header = reinterpret_cast<const RecordHeader *>(m_data_ptr + offset)->packet;
+      if (packet.header.id != PACKET_ID_SKIP)
+      {
+        packet.first = Span<const u8>(m_data_ptr + offset + sizeof(RecordHeader), packet.header.payload_size);
+        callback(static_cast<Ref<PacketView>>(packet));
+        consumed++;
+      }
+
+      std::memset(m_data_ptr + offset, 0, record_size);
+      read += record_size;
+    }
+
+    if (read != initial_read)
+    {
+      m_control_block->consumer.read_cursor.store(read, std::memory_order_release);
+    }
+
+    return consumed;
+  }
+
+  inline auto MpscRingBufferView::get_control_block() -> ControlBlock *
+  {
+    return m_control_block;
+  }
+
+  inline auto MpscRingBufferView::claim(const u32 record_size) -> Option<u64>
+  {
+    const u64 cap = m_capacity;
+
+    Mut<u64> write = m_control_block->producer.write_cursor.load(std::memory_order_relaxed);
+    Mut<u64> read = m_control_block->producer.cached_read_cursor.load(std::memory_order_acquire);
+
+    while (true)
+    {
+      const u64 tail = cap - (write % cap);
+      const u64 padding = (tail < record_size) ? tail : 0;
+      const u64 end = write + padding + record_size;
+
+      // Only go back to the consumer's cache line once the shared copy says the ring is full
+      if (end - read > cap)
+      {
+        read = m_control_block->consumer.read_cursor.load(std::memory_order_acquire);
+        m_control_block->producer.cached_read_cursor.store(read, std::memory_order_release);
+
+        if (end - read > cap)
+        {
+          return std::nullopt;
+        }
+      }
+
+      if (m_control_block->producer.write_cursor.compare_exchange_weak(write, end, std::memory_order_relaxed))
+      {
+        if (padding > 0)
+        {
+          const u32 offset = static_cast<u32>(write % cap);
+          reinterpret_cast<RecordHeader *>(m_data_ptr + offset)->packet =
+              PacketHeader{PACKET_ID_SKIP, static_cast<u16>(padding - sizeof(RecordHeader))};
+          commit_word(offset).store(static_cast<u32>(padding), std::memory_order_release);
+        }
+
+        return write + padding;
+      }
+    }
+  }
+
+  inline auto MpscRingBufferView::commit_word(const u32 offset) -> std::atomic_ref<u32>
+  {
+    return std::atomic_ref<u32>(reinterpret_cast<RecordHeader *>(m_data_ptr + offset)->committed_size);
+  }
+
+  inline auto MpscRingBufferView::get_record_size(const usize payload_size) const -> u32
+  {
+    const u32 size = sizeof(RecordHeader) + static_cast<u32>(payload_size);
+    return (size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+  }
+
+  [[nodiscard]] inline auto MpscRingBufferView::is_valid() const -> bool
+  {
+    return m_control_block && m_data_ptr && m_capacity;
+  }
+} // namespace ia
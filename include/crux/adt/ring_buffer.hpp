@@ -16,8 +16,12 @@
 #pragma once
 
 #include <crux/crux.hpp>
+#include <crux/doorbell.hpp>
+#include <crux/utils.hpp>
 
 #include <atomic>
+#include <bit>
+#include <chrono>
 
 namespace ia
 {
@@ -26,21 +30,104 @@ namespace ia
 public:
     static constexpr const u16 PACKET_ID_SKIP = 0;
 
+    // Carries one piece of a push_large() message. Only pop_large() reassembles them, pop()/peek() return
+    // them like any other packet.
+    static constexpr const u16 PACKET_ID_FRAGMENT = 0xFFFF;
+
+    // Creation flags, stored in the ControlBlock by the owner
+    // - FLAG_WAITABLE: enables pop_wait()/push_wait() and push_large()/pop_large(). Every publish then costs one
+    //   extra fence, and a wake syscall only while the other side is parked.
+    // - FLAG_MONOTONIC: cursors count bytes forever instead of wrapping at the capacity, which must then be a
+    //   power of two. Offsets become a mask instead of a modulo, and the ring can be filled to the last byte.
+    // - FLAG_ALIGNED: every header and payload starts on an ALIGNED_RECORD_ALIGNMENT boundary (the header is
+    //   padded to that size), so payloads can be reinterpreted in place. Every write path then keeps payloads
+    //   contiguous like reserve() does. The capacity must be a multiple of ALIGNED_RECORD_ALIGNMENT.
+    // - FLAG_STREAMING_COPY: payloads of STREAMING_COPY_THRESHOLD bytes or more are written with non-temporal
+    //   stores (utils::copy_non_temporal), so large frames don't evict the consumer's working set.
+    // - FLAG_STATS: both sides keep traffic counters in the ControlBlock (see get_stats()). Every publish then
+    //   costs a clock read and a few stores to a line only that side writes.
+    static constexpr const u32 FLAG_WAITABLE = 1 << 0;
+    static constexpr const u32 FLAG_MONOTONIC = 1 << 1;
+    static constexpr const u32 FLAG_ALIGNED = 1 << 2;
+    static constexpr const u32 FLAG_STREAMING_COPY = 1 << 3;
+    static constexpr const u32 FLAG_STATS = 1 << 4;
+
+    static constexpr const u32 ALIGNED_RECORD_ALIGNMENT = 8;
+    static constexpr const u32 STREAMING_COPY_THRESHOLD = 4096;
+
+    // Iterations the blocking calls busy-wait before parking
+    static constexpr const u32 WAIT_SPIN_COUNT = 1024;
+
+    // Values of the ControlBlock waiting flags
+    static constexpr const u32 WAITER_NONE = 0;
+    static constexpr const u32 WAITER_PARKED = 1;
+    static constexpr const u32 WAITER_DOORBELL = 2;
+
     struct ControlBlock
     {
+      // Cursors are byte offsets in [0, capacity), or ever-increasing byte counts under FLAG_MONOTONIC.
+      //
+      // Each side keeps a private copy of the other side's cursor on its own cache line, and only
+      // reloads the shared one when that copy says the ring is full (producer) or empty (consumer).
+      //
+      // The waiting flags (WAITER_*) sit on the line the *other* side owns: a parked side writes it once before
+      // sleeping, while the publishing side checks it on every publish without leaving its own line.
       struct alignas(64)
       {
-        Mut<std::atomic<u32>> write_offset{0};
+        Mut<std::atomic<u64>> write_offset{0};
+        Mut<u64> cached_read_offset{0};
+        Mut<std::atomic<u32>> consumer_waiting{0};
       } producer;
 
       struct alignas(64)
       {
-        Mut<std::atomic<u32>> read_offset{0};
+        Mut<std::atomic<u64>> read_offset{0};
+        Mut<u64> cached_write_offset{0};
+        Mut<std::atomic<u32>> producer_waiting{0};
         Mut<u32> capacity{0};
+        Mut<u32> flags{0};
       } consumer;
+
+      // FLAG_STATS counters. Each side owns one line and is its only writer, so the counters are bumped with
+      // plain load/store pairs, and readers (a sidecar, the other side) never pull the cursor lines away.
+      // Byte counts are ring bytes: framing and padding included.
+      struct alignas(64)
+      {
+        Mut<std::atomic<u64>> packets{0};
+        Mut<std::atomic<u64>> bytes{0};
+        Mut<std::atomic<u64>> full_rejections{0};
+        Mut<std::atomic<u64>> high_water_mark{0};
+        Mut<std::atomic<u64>> last_activity_ns{0};
+      } producer_stats;
+
+      struct alignas(64)
+      {
+        Mut<std::atomic<u64>> packets{0};
+        Mut<std::atomic<u64>> bytes{0};
+        Mut<std::atomic<u64>> last_activity_ns{0};
+      } consumer_stats;
     };
 
     static_assert(offsetof(ControlBlock, consumer) == 64, "False sharing detected in ControlBlock");
+    static_assert(offsetof(ControlBlock, producer_stats) == 128 && offsetof(ControlBlock, consumer_stats) == 192,
+                  "False sharing detected in ControlBlock");
+
+    // Snapshot of the FLAG_STATS counters, all zero on rings created without the flag.
+    // - full_rejections: pushes/reservations that found the ring full (a blocking call counts once)
+    // - high_water_mark: peak bytes in use, measured against the producer's cached read cursor, so it can
+    //   overstate by what the consumer released since the producer last looked
+    // - last_*_ns: steady clock (CLOCK_MONOTONIC on Linux) time of the last publish, comparable across processes
+    struct Stats
+    {
+      Mut<u64> packets_pushed{};
+      Mut<u64> bytes_pushed{};
+      Mut<u64> packets_popped{};
+      Mut<u64> bytes_popped{};
+      Mut<u64> full_rejections{};
+      Mut<u64> high_water_mark{};
+      Mut<u64> last_push_ns{};
+      Mut<u64> last_pop_ns{};
+    };
 
     struct PacketHeader
     {
@@ -60,35 +147,250 @@ public:
       Mut<u16> payload_size{};
     };
 
+    struct PacketView
+    {
+      Mut<PacketHeader> header{};
+
+      // The payload, in place. `second` is only non-empty when the payload wraps around the end of the buffer
+      // (never on a mirrored view).
+      Mut<Span<const u8>> first{};
+      Mut<Span<const u8>> second{};
+    };
+
+    struct Packet
+    {
+      Mut<u16> id{};
+      Mut<Span<const u8>> data{};
+    };
+
+    // Payload prefix of a PACKET_ID_FRAGMENT packet
+    struct FragmentHeader
+    {
+      Mut<u16> packet_id{};
+      Mut<u16> reserved{};
+      Mut<u32> total_size{};
+      Mut<u32> offset{};
+    };
+
+    static_assert(sizeof(FragmentHeader) == 12, "FragmentHeader must be packed");
+
+    // A piece of a message handed out by pop_large(), in place
+    struct Fragment
+    {
+      Mut<u16> id{};
+      Mut<u32> total_size{};
+      Mut<u32> offset{};
+      Mut<Span<const u8>> data{};
+    };
+
 public:
     static auto default_instance() -> RingBufferView;
 
-    static auto create(Ref<Span<u8>> buffer, const bool is_owner) -> Result<RingBufferView>;
-    static auto create(ControlBlock *control_block, Ref<Span<u8>> buffer, const bool is_owner)
+    // `flags` (FLAG_*) are only used by the owner, other views pick them up from the ControlBlock
+    static auto create(Ref<Span<u8>> buffer, const bool is_owner, const u32 flags = 0) -> Result<RingBufferView>;
+    static auto create(ControlBlock *control_block, Ref<Span<u8>> buffer, const bool is_owner, const u32 flags = 0)
         -> Result<RingBufferView>;
 
+    // Like create(), for a buffer whose `capacity` bytes are mapped a second time right behind it (see
+    // SharedMemory::Options::mirrored). Any packet is then contiguous in virtual memory, so copies are never
+    // split and reserve() never pads. The mirror is a property of this view's mapping only: mirrored and
+    // plain views can share one ring.
+    static auto create_mirrored(ControlBlock *control_block, Ref<Span<u8>> buffer, const bool is_owner,
+                                const u32 flags = 0) -> Result<RingBufferView>;
+
     // Returns:
     // - nullopt if empty
     // - bytes_read if success
     // - Error if buffer too small
     auto pop(MutRef<PacketHeader> out_header, Ref<Span<u8>> out_buffer) -> Result<Option<usize>>;
 
+    // Every write path rejects PACKET_ID_SKIP and PACKET_ID_FRAGMENT, which the readers treat specially
     auto push(const u16 packet_id, Ref<Span<const u8>> data) -> Result<void>;
 
+    // Blocking variants (require FLAG_WAITABLE). They spin for WAIT_SPIN_COUNT iterations, then park on a
+    // futex in the ControlBlock until the other side publishes or timeout_ms expires.
+    // pop_wait() returns nullopt and push_wait() fails with "RingBuffer full" on timeout.
+    auto pop_wait(MutRef<PacketHeader> out_header, Ref<Span<u8>> out_buffer, const u64 timeout_ms)
+        -> Result<Option<usize>>;
+    auto push_wait(const u16 packet_id, Ref<Span<const u8>> data, const u64 timeout_ms) -> Result<void>;
+
+    // push_wait() for rings without FLAG_WAITABLE: busy-waits with utils::spin_pause() instead of parking.
+    // Invalid packets fail right away, and a blocked push counts as one full rejection however long it waits.
+    auto push_spin(const u16 packet_id, Ref<Span<const u8>> data, const u64 timeout_ms) -> Result<void>;
+
+    // Messages of up to 4 GiB (require FLAG_WAITABLE). push_large() streams `data` straight into the ring as
+    // PACKET_ID_FRAGMENT packets of at most half the capacity, publishing each one so the reader can start
+    // early. timeout_ms covers the whole message.
+    //
+    // pop_large() hands the next message to callback(Ref<Fragment>) piece by piece, in place, so no staging
+    // buffer of the full size is needed. Plain packets come through as a single message too.
+    // Returns the message size, nullopt if nothing arrived in time, or an error if the message was cut short
+    // (the remaining fragments of a cut message are dropped).
+    auto push_large(const u16 packet_id, Ref<Span<const u8>> data, const u64 timeout_ms) -> Result<void>;
+
+    template<typename Fn> auto pop_large(ForwardRef<Fn> callback, const u64 timeout_ms) -> Result<Option<u32>>;
+
+    // Pushes as many packets as fit and publishes them with a single store.
+    // Returns the number of packets pushed.
+    auto push_batch(Ref<Span<const Packet>> packets) -> Result<usize>;
+
+    // Hands every available packet (up to max_packets) to callback(Ref<PacketView>) in place and
+    // releases them with a single store. Returns the number of packets consumed.
+    template<typename Fn>
+    auto consume_all(ForwardRef<Fn> callback, const usize max_packets = std::numeric_limits<usize>::max()) -> usize;
+
+    // Zero-copy write path:
+    // - reserve() claims room for one packet and returns its payload span, which is always
+    //   contiguous (the tail of the buffer is padded with a PACKET_ID_SKIP record if needed)
+    // - commit() publishes every reservation made since the last commit (or push)
+    auto reserve(const u16 packet_id, const usize size) -> Result<Span<u8>>;
+    auto commit() -> void;
+
+    // Zero-copy read path:
+    // - peek() returns the next packet with its payload left in place (nullopt if empty)
+    // - consume() releases every packet returned by peek() since the last consume (or pop)
+    auto peek() -> Option<PacketView>;
+    auto consume() -> void;
+
+    // Readiness notification for event loops (requires FLAG_WAITABLE), see Doorbell.
+    // - set_doorbell() gives this view a non-owning eventfd; the producer's view signals it, the consumer's
+    //   view waits on it (-1 detaches)
+    // - the consumer calls arm_doorbell() once pop()/consume_all() come back empty. It returns false if
+    //   packets arrived meanwhile, in which case it should keep draining instead of waiting. It also returns
+    //   false on a ring without FLAG_WAITABLE, whose producer never checks for a waiting consumer.
+    // The producer then signals once, on the first publish after arming (the empty to non-empty transition).
+    auto set_doorbell(const i32 fd) -> Result<void>;
+    auto arm_doorbell() -> bool;
+
     auto get_control_block() -> ControlBlock *;
 
+    [[nodiscard]] auto get_capacity() const -> u32;
+    [[nodiscard]] auto get_flags() const -> u32;
+
+    // Largest payload push(), push_wait() and push_batch() accept: a larger one could never fit, even once the
+    // ring has drained. Under FLAG_ALIGNED a plain view keeps payloads contiguous, which caps it at about half
+    // the capacity (see get_max_fragment_payload()).
+    [[nodiscard]] auto get_max_payload() const -> u32;
+
+    // Reads the counters with relaxed loads and never writes, so any process holding a view of the ring (a
+    // non-owner view that is never pushed to or popped from will do) can poll it.
+    [[nodiscard]] auto get_stats() const -> Stats;
+
     [[nodiscard]] auto is_valid() const -> bool;
 
 protected:
-    RingBufferView(Ref<Span<u8>> buffer, const bool is_owner);
-    RingBufferView(ControlBlock *control_block, Ref<Span<u8>> buffer, const bool is_owner);
+    RingBufferView(Ref<Span<u8>> buffer, const bool is_owner, const u32 flags = 0);
+    RingBufferView(ControlBlock *control_block, Ref<Span<u8>> buffer, const bool is_owner, const u32 flags = 0);
 
 private:
     Mut<u8 *> m_data_ptr{};
     Mut<u32> m_capacity{};
     Mut<ControlBlock *> m_control_block{};
+    Mut<u32> m_flags{};
+    Mut<u32> m_mask{};
+    Mut<bool> m_mirrored{false};
+    Mut<i32> m_doorbell_fd{-1};
+
+    Mut<bool> m_has_pending_write{false};
+    Mut<u64> m_pending_write_offset{0};
+    Mut<u32> m_pending_write_packets{0};
+
+    Mut<bool> m_has_pending_read{false};
+    Mut<u64> m_pending_read_offset{0};
+    Mut<u32> m_pending_read_packets{0};
 
 private:
+    static auto validate_layout(const u32 capacity, const u32 flags) -> Result<void>;
+
+    auto get_local_write_offset() const -> u64;
+    auto get_local_read_offset() const -> u64;
+
+    auto init_control_block(const bool is_owner, const u32 flags) -> void;
+
+    // Reload the other side's cursor and refresh the cached copy in the ControlBlock
+    auto reload_read_offset() -> u64;
+    auto reload_write_offset() -> u64;
+
+    // Store a cursor and wake the other side if it is parked. `packets` counts the packets written (read) by
+    // the caller, on top of the pending reservations (peeks) that the store publishes (releases) too.
+    auto publish_write_offset(const u64 write, const u32 packets) -> void;
+    auto publish_read_offset(const u64 read, const u32 packets) -> void;
+
+    static auto is_reserved_id(const u16 packet_id) -> bool;
+
+    // Non-failing cores of push()/reserve(), for the blocking variants. The size must already be checked.
+    // They return false/nullopt if the ring is full.
+    auto try_push(const u16 packet_id, Ref<Span<const u8>> data) -> bool;
+    auto try_reserve(const u16 packet_id, const usize size) -> Option<Span<u8>>;
+
+    // FLAG_STATS bookkeeping, no-ops without the flag
+    auto record_push(const u64 write, const u32 packets) -> void;
+    auto record_pop(const u64 read, const u32 packets) -> void;
+    auto record_full() -> void;
+
+    // Single-writer increment, cheaper than fetch_add
+    static auto bump_counter(MutRef<std::atomic<u64>> counter, const u64 value) -> void;
+    static auto get_timestamp_ns() -> u64;
+
+    // Parks until `cursor` moves away from `observed` (or timeout_us expires)
+    static auto park(MutRef<std::atomic<u32>> waiting_flag, Ref<std::atomic<u64>> cursor, const u64 observed,
+                     const u64 timeout_us) -> void;
+    // Wakes a parked waiter. Returns the WAITER_* value it cleared.
+    static auto unpark(MutRef<std::atomic<u32>> waiting_flag) -> u32;
+
+    // One backoff round of the blocking calls, to run after a failed attempt: spins for WAIT_SPIN_COUNT rounds,
+    // then parks until the other side publishes. Returns false once `deadline` has passed.
+    auto wait_for_data(MutRef<u32> spins, const std::chrono::steady_clock::time_point deadline) -> bool;
+    auto wait_for_space(MutRef<u32> spins, const std::chrono::steady_clock::time_point deadline) -> bool;
+
+    static auto wait_step(MutRef<u32> spins, const std::chrono::steady_clock::time_point deadline,
+                          MutRef<std::atomic<u32>> waiting_flag, Ref<std::atomic<u64>> cursor, const u64 observed)
+        -> bool;
+
+    // reserve() that waits for room until `deadline`
+    auto reserve_wait(const u16 packet_id, const usize size, const std::chrono::steady_clock::time_point deadline)
+        -> Result<Span<u8>>;
+
+    // Largest payload push_large() puts in one packet, so that it always fits once the ring drains
+    [[nodiscard]] auto get_max_fragment_payload() const -> u32;
+
+    // Advances `read` past any PACKET_ID_SKIP records.
+    // Returns false if no packet is left before `write`.
+    auto read_next_header(MutRef<u64> read, const u64 write, MutRef<PacketHeader> out_header) -> bool;
+
+    // Fills the payload spans of a packet whose header sits at `read`. Returns the cursor past the packet.
+    auto read_payload_view(const u64 read, MutRef<PacketView> packet) const -> u64;
+
+    // Tail bytes a packet written at `write` must skip so its payload doesn't straddle the end of the buffer
+    // (0 on mirrored views). get_copy_padding() is the same for the copying write paths, which only keep
+    // payloads contiguous under FLAG_ALIGNED.
+    [[nodiscard]] auto get_wrap_padding(const u64 write, const usize size) const -> u32;
+    [[nodiscard]] auto get_copy_padding(const u64 write, const usize size) const -> u32;
+
+    // Writes one packet at `write` (behind a PACKET_ID_SKIP record covering `padding` bytes, if any) without
+    // publishing it. Returns the cursor past the packet.
+    auto write_packet(const u64 write, const u32 padding, const u16 packet_id, Ref<Span<const u8>> data) -> u64;
+
+    // Writes the PACKET_ID_SKIP record covering `padding` bytes at `write`. Returns the cursor past it.
+    auto write_skip_record(const u64 write, const u32 padding) -> u64;
+
+    // Framing: size of the header in front of a payload, and of a whole record with its payload
+    [[nodiscard]] auto get_header_size() const -> u32;
+    [[nodiscard]] auto get_record_size(const u32 payload_size) const -> u32;
+
+    // Cursor arithmetic, a mask under FLAG_MONOTONIC and a modulo otherwise
+    [[nodiscard]] auto get_index(const u64 cursor) const -> u32;
+    [[nodiscard]] auto advance(const u64 cursor, const u32 size) const -> u64;
+
+    // Bytes that can be written before catching up with `read`
+    [[nodiscard]] auto get_free_space(const u64 write, const u64 read) const -> u32;
+
+    // Bytes from cursor `from` forward to cursor `to`
+    [[nodiscard]] auto get_distance(const u64 from, const u64 to) const -> u32;
+
+    // memcpy into the ring, streaming large copies under FLAG_STREAMING_COPY
+    auto copy_in(u8 *dst, const void *src, const usize size) -> void;
+
     auto write_wrapped(const u32 offset, const void *data, const u32 size) -> void;
     auto read_wrapped(const u32 offset, void *out_data, const u32 size) -> void;
   };
@@ -98,28 +400,33 @@ private:
     return RingBufferView(nullptr, {}, false);
   }
 
-  inline auto RingBufferView::create(Ref<Span<u8>> buffer, const bool is_owner) -> Result<RingBufferView>
+  inline auto RingBufferView::create(Ref<Span<u8>> buffer, const bool is_owner, const u32 flags)
+      -> Result<RingBufferView>
   {
     if (buffer.size() <= sizeof(ControlBlock))
     {
       return fail("Buffer too small for ControlBlock");
     }
 
-    if (!is_owner)
+    const ControlBlock *cb = reinterpret_cast<ControlBlock *>(buffer.data());
+    const u32 capacity = static_cast<u32>(buffer.size()) - sizeof(ControlBlock);
+
+    if (!is_owner && cb->consumer.capacity != capacity)
     {
-      const ControlBlock *cb = reinterpret_cast<ControlBlock *>(buffer.data());
-      const u32 capacity = static_cast<u32>(buffer.size()) - sizeof(ControlBlock);
-      if (cb->consumer.capacity != capacity)
-      {
-        return fail("Capacity mismatch");
-      }
+      return fail("Capacity mismatch");
+    }
+
+    auto layout_valid = validate_layout(capacity, is_owner ? flags : cb->consumer.flags);
+    if (!layout_valid)
+    {
+      return fail("{}", layout_valid.error());
     }
 
-    return RingBufferView(buffer, is_owner);
+    return RingBufferView(buffer, is_owner, flags);
   }
 
-  inline auto RingBufferView::create(ControlBlock *control_block, Ref<Span<u8>> buffer, const bool is_owner)
-      -> Result<RingBufferView>
+  inline auto RingBufferView::create(ControlBlock *control_block, Ref<Span<u8>> buffer, const bool is_owner,
+                                     const u32 flags) -> Result<RingBufferView>
   {
     if (control_block == nullptr)
     {
@@ -130,51 +437,115 @@ private:
       return fail("Buffer is empty");
     }
 
-    return RingBufferView(control_block, buffer, is_owner);
+    auto layout_valid =
+        validate_layout(static_cast<u32>(buffer.size()), is_owner ? flags : control_block->consumer.flags);
+    if (!layout_valid)
+    {
+      return fail("{}", layout_valid.error());
+    }
+
+    return RingBufferView(control_block, buffer, is_owner, flags);
   }
 
-  inline RingBufferView::RingBufferView(Ref<Span<u8>> buffer, const bool is_owner)
+  inline auto RingBufferView::create_mirrored(ControlBlock *control_block, Ref<Span<u8>> buffer, const bool is_owner,
+                                              const u32 flags) -> Result<RingBufferView>
+  {
+    auto view = create(control_block, buffer, is_owner, flags);
+    if (!view)
+    {
+      return view;
+    }
+
+    view->m_mirrored = true;
+    return view;
+  }
+
+  inline RingBufferView::RingBufferView(Ref<Span<u8>> buffer, const bool is_owner, const u32 flags)
   {
     m_control_block = reinterpret_cast<ControlBlock *>(buffer.data());
     m_data_ptr = buffer.data() + sizeof(ControlBlock);
 
     m_capacity = static_cast<u32>(buffer.size()) - sizeof(ControlBlock);
 
-    if (is_owner)
-    {
-      m_control_block->consumer.capacity = m_capacity;
-      m_control_block->producer.write_offset.store(0, std::memory_order_release);
-      m_control_block->consumer.read_offset.store(0, std::memory_order_release);
-    }
+    init_control_block(is_owner, flags);
   }
 
-  inline RingBufferView::RingBufferView(ControlBlock *control_block, Ref<Span<u8>> buffer, const bool is_owner)
+  inline RingBufferView::RingBufferView(ControlBlock *control_block, Ref<Span<u8>> buffer, const bool is_owner,
+                                        const u32 flags)
   {
     m_control_block = control_block;
     m_data_ptr = buffer.data();
     m_capacity = static_cast<u32>(buffer.size());
 
+    init_control_block(is_owner, flags);
+  }
+
+  inline auto RingBufferView::validate_layout(const u32 capacity, const u32 flags) -> Result<void>
+  {
+    if ((flags & FLAG_MONOTONIC) && !std::has_single_bit(capacity))
+    {
+      return fail("FLAG_MONOTONIC requires a power-of-two capacity, got {}", capacity);
+    }
+
+    if ((flags & FLAG_ALIGNED) && capacity % ALIGNED_RECORD_ALIGNMENT != 0)
+    {
+      return fail("FLAG_ALIGNED requires a capacity that is a multiple of {}, got {}", ALIGNED_RECORD_ALIGNMENT,
+                  capacity);
+    }
+
+    return {};
+  }
+
+  inline auto RingBufferView::init_control_block(const bool is_owner, const u32 flags) -> void
+  {
+    if (m_control_block == nullptr)
+    {
+      return;
+    }
+
     if (is_owner)
     {
       m_control_block->consumer.capacity = m_capacity;
+      m_control_block->consumer.flags = flags;
+      m_control_block->producer.cached_read_offset = 0;
+      m_control_block->consumer.cached_write_offset = 0;
+      m_control_block->producer.consumer_waiting.store(WAITER_NONE, std::memory_order_relaxed);
+      m_control_block->consumer.producer_waiting.store(WAITER_NONE, std::memory_order_relaxed);
       m_control_block->producer.write_offset.store(0, std::memory_order_release);
       m_control_block->consumer.read_offset.store(0, std::memory_order_release);
+
+      MutRef<decltype(ControlBlock::producer_stats)> producer_stats = m_control_block->producer_stats;
+      producer_stats.packets.store(0, std::memory_order_relaxed);
+      producer_stats.bytes.store(0, std::memory_order_relaxed);
+      producer_stats.full_rejections.store(0, std::memory_order_relaxed);
+      producer_stats.high_water_mark.store(0, std::memory_order_relaxed);
+      producer_stats.last_activity_ns.store(0, std::memory_order_relaxed);
+
+      MutRef<decltype(ControlBlock::consumer_stats)> consumer_stats = m_control_block->consumer_stats;
+      consumer_stats.packets.store(0, std::memory_order_relaxed);
+      consumer_stats.bytes.store(0, std::memory_order_relaxed);
+      consumer_stats.last_activity_ns.store(0, std::memory_order_relaxed);
     }
+
+    m_flags = m_control_block->consumer.flags;
+    m_mask = (m_flags & FLAG_MONOTONIC) ? m_capacity - 1 : 0;
   }
 
   inline auto RingBufferView::pop(MutRef<PacketHeader> out_header, Ref<Span<u8>> out_buffer) -> Result<Option<usize>>
   {
-    const u32 write = m_control_block->producer.write_offset.load(std::memory_order_acquire);
-    const u32 read = m_control_block->consumer.read_offset.load(std::memory_order_relaxed);
-    const u32 cap = m_capacity;
+    const u64 initial_read = get_local_read_offset();
 
-    if (read == write)
+    Mut<u64> read = initial_read;
+    if (!read_next_header(read, m_control_block->consumer.cached_write_offset, out_header) &&
+        !read_next_header(read, reload_write_offset(), out_header))
     {
+      if (read != initial_read)
+      {
+        publish_read_offset(read, 0);
+      }
       return std::nullopt;
     }
 
-    read_wrapped(read, &out_header, sizeof(PacketHeader));
-
     if (out_header.payload_size > out_buffer.size())
     {
       return fail("Buffer too small: needed {}, provided {}", out_header.payload_size, out_buffer.size());
@@ -182,79 +553,1007 @@ private:
 
     if (out_header.payload_size > 0)
     {
-      const u32 data_read_offset = (read + sizeof(PacketHeader)) % cap;
-      read_wrapped(data_read_offset, out_buffer.data(), out_header.payload_size);
+      const u64 data_read_offset = advance(read, get_header_size());
+      read_wrapped(get_index(data_read_offset), out_buffer.data(), out_header.payload_size);
     }
 
-    const u32 new_read_offset = (read + sizeof(PacketHeader) + out_header.payload_size) % cap;
-    m_control_block->consumer.read_offset.store(new_read_offset, std::memory_order_release);
+    publish_read_offset(advance(read, get_record_size(out_header.payload_size)), 1);
 
     return std::make_optional(static_cast<usize>(out_header.payload_size));
   }
 
+  inline auto RingBufferView::is_reserved_id(const u16 packet_id) -> bool
+  {
+    return packet_id == PACKET_ID_SKIP || packet_id == PACKET_ID_FRAGMENT;
+  }
+
   inline auto RingBufferView::push(const u16 packet_id, Ref<Span<const u8>> data) -> Result<void>
   {
-    if (data.size() > std::numeric_limits<u16>::max())
+    if (is_reserved_id(packet_id))
     {
-      return fail("Data size exceeds u16 limit");
+      return fail("Packet id {} is reserved", packet_id);
     }
 
-    const u32 total_size = sizeof(PacketHeader) + static_cast<u32>(data.size());
+    if (data.size() > get_max_payload())
+    {
+      return fail("Data size {} exceeds the ring's limit of {}", data.size(), get_max_payload());
+    }
 
-    const u32 read = m_control_block->consumer.read_offset.load(std::memory_order_acquire);
-    const u32 write = m_control_block->producer.write_offset.load(std::memory_order_relaxed);
-    const u32 cap = m_capacity;
+    if (!try_push(packet_id, data))
+    {
+      record_full();
+      return fail("RingBuffer full");
+    }
 
-    const u32 free_space = (read <= write) ? (m_capacity - write) + read : (read - write);
+    return {};
+  }
 
-    // Leave 1 byte empty (prevent ambiguities)
-    if (free_space <= total_size)
+  inline auto RingBufferView::pop_wait(MutRef<PacketHeader> out_header, Ref<Span<u8>> out_buffer,
+                                       const u64 timeout_ms) -> Result<Option<usize>>
+  {
+    if ((m_flags & FLAG_WAITABLE) == 0)
     {
-      return fail("RingBuffer full");
+      return fail("RingBuffer was not created with FLAG_WAITABLE");
     }
 
-    const PacketHeader header{packet_id, static_cast<u16>(data.size())};
-    write_wrapped(write, &header, sizeof(PacketHeader));
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    Mut<u32> spins = 0;
 
-    const u32 data_write_offset = (write + sizeof(PacketHeader)) % cap;
+    while (true)
+    {
+      auto result = pop(out_header, out_buffer);
+      if (!result || result->has_value())
+      {
+        return result;
+      }
 
-    if (!data.empty())
+      if (!wait_for_data(spins, deadline))
+      {
+        return std::nullopt;
+      }
+    }
+  }
+
+  inline auto RingBufferView::push_wait(const u16 packet_id, Ref<Span<const u8>> data, const u64 timeout_ms)
+      -> Result<void>
+  {
+    if ((m_flags & FLAG_WAITABLE) == 0)
+    {
+      return fail("RingBuffer was not created with FLAG_WAITABLE");
+    }
+
+    if (is_reserved_id(packet_id))
+    {
+      return fail("Packet id {} is reserved", packet_id);
+    }
+
+    if (data.size() > get_max_payload())
+    {
+      return fail("Data size {} exceeds the ring's limit of {}", data.size(), get_max_payload());
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    Mut<u32> spins = 0;
+    Mut<bool> blocked = false;
+
+    while (true)
+    {
+      if (try_push(packet_id, data))
+      {
+        return {};
+      }
+
+      if (!blocked)
+      {
+        record_full();
+        blocked = true;
+      }
+
+      if (!wait_for_space(spins, deadline))
+      {
+        return fail("RingBuffer full");
+      }
+    }
+  }
+
+  inline auto RingBufferView::push_spin(const u16 packet_id, Ref<Span<const u8>> data, const u64 timeout_ms)
+      -> Result<void>
+  {
+    if (is_reserved_id(packet_id))
+    {
+      return fail("Packet id {} is reserved", packet_id);
+    }
+
+    if (data.size() > get_max_payload())
     {
-      write_wrapped(data_write_offset, data.data(), static_cast<u32>(data.size()));
+      return fail("Data size {} exceeds the ring's limit of {}", data.size(), get_max_payload());
     }
 
-    const u32 new_write_offset = (data_write_offset + data.size()) % cap;
-    m_control_block->producer.write_offset.store(new_write_offset, std::memory_order_release);
+    if (try_push(packet_id, data))
+    {
+      return {};
+    }
+
+    record_full();
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (!try_push(packet_id, data))
+    {
+      if (std::chrono::steady_clock::now() >= deadline)
+      {
+        return fail("RingBuffer full");
+      }
+      utils::spin_pause();
+    }
 
     return {};
   }
 
-  inline auto RingBufferView::get_control_block() -> ControlBlock *
+  inline auto RingBufferView::push_large(const u16 packet_id, Ref<Span<const u8>> data, const u64 timeout_ms)
+      -> Result<void>
   {
-    return m_control_block;
+    if ((m_flags & FLAG_WAITABLE) == 0)
+    {
+      return fail("RingBuffer was not created with FLAG_WAITABLE");
+    }
+
+    if (is_reserved_id(packet_id))
+    {
+      return fail("Packet id {} is reserved", packet_id);
+    }
+
+    if (data.size() > std::numeric_limits<u32>::max())
+    {
+      return fail("Data size exceeds u32 limit");
+    }
+
+    const u32 max_payload = get_max_fragment_payload();
+    if (max_payload <= sizeof(FragmentHeader))
+    {
+      return fail("RingBuffer too small for large packets");
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+
+    // Small enough to go out as a plain packet
+    if (data.size() <= max_payload)
+    {
+      auto payload = reserve_wait(packet_id, data.size(), deadline);
+      if (!payload)
+      {
+        return fail("{}", payload.error());
+      }
+
+      copy_in(payload->data(), data.data(), data.size());
+      commit();
+      return {};
+    }
+
+    const usize chunk_capacity = max_payload - sizeof(FragmentHeader);
+
+    for (Mut<usize> offset = 0; offset < data.size(); offset += chunk_capacity)
+    {
+      const usize chunk_size = std::min(chunk_capacity, data.size() - offset);
+
+      auto payload = reserve_wait(PACKET_ID_FRAGMENT, sizeof(FragmentHeader) + chunk_size, deadline);
+      if (!payload)
+      {
+        return fail("{} after {} of {} bytes", payload.error(), offset, data.size());
+      }
+
+      const FragmentHeader fragment{packet_id, 0, static_cast<u32>(data.size()), static_cast<u32>(offset)};
+      std::memcpy(payload->data(), &fragment, sizeof(FragmentHeader));
+      copy_in(payload->data() + sizeof(FragmentHeader), data.data() + offset, chunk_size);
+      commit();
+    }
+
+    return {};
   }
 
-  inline auto RingBufferView::write_wrapped(const u32 offset, const void *data, const u32 size) -> void
+  template<typename Fn>
+  inline auto RingBufferView::pop_large(ForwardRef<Fn> callback, const u64 timeout_ms) -> Result<Option<u32>>
   {
-    if (offset + size <= m_capacity)
+    if ((m_flags & FLAG_WAITABLE) == 0)
     {
-      std::memcpy(m_data_ptr + offset, data, size);
+      return fail("RingBuffer was not created with FLAG_WAITABLE");
     }
-    else
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    Mut<u32> spins = 0;
+
+    Mut<bool> in_message = false;
+    Mut<Fragment> fragment;
+
+    while (true)
     {
-      const u32 first_chunk = m_capacity - offset;
-      const u32 second_chunk = size - first_chunk;
+      const auto packet = peek();
+      if (!packet)
+      {
+        if (!wait_for_data(spins, deadline))
+        {
+          if (in_message)
+          {
+            return fail("Timed out after {} of {} bytes", fragment.offset, fragment.total_size);
+          }
+          return std::nullopt;
+        }
+        continue;
+      }
 
-      const u8 *src = static_cast<const u8 *>(data);
+      if (packet->header.id != PACKET_ID_FRAGMENT)
+      {
+        if (in_message)
+        {
+          // Leave the packet for the next call
+          m_has_pending_read = false;
+          m_pending_read_packets = 0;
+          return fail("Large packet truncated after {} of {} bytes", fragment.offset, fragment.total_size);
+        }
+
+        fragment.id = packet->header.id;
+        fragment.total_size = packet->header.payload_size;
+        fragment.offset = 0;
+        fragment.data = packet->first;
+        callback(static_cast<Ref<Fragment>>(fragment));
+
+        if (!packet->second.empty())
+        {
+          fragment.offset = static_cast<u32>(packet->first.size());
+          fragment.data = packet->second;
+          callback(static_cast<Ref<Fragment>>(fragment));
+        }
+
+        consume();
+        return fragment.total_size;
+      }
+
+      // Fragments are written through reserve(), so they are never split
+      Mut<FragmentHeader> header;
+      if (packet->first.size() < sizeof(FragmentHeader) || !packet->second.empty())
+      {
+        consume();
+        return fail("Malformed fragment");
+      }
+      std::memcpy(&header, packet->first.data(), sizeof(FragmentHeader));
+
+      if (header.offset == 0)
+      {
+        if (in_message)
+        {
+          m_has_pending_read = false;
+          m_pending_read_packets = 0;
+          return fail("Large packet truncated after {} of {} bytes", fragment.offset, fragment.total_size);
+        }
+
+        in_message = true;
+        fragment.id = header.packet_id;
+        fragment.total_size = header.total_size;
+        fragment.offset = 0;
+      }
+      else if (!in_message)
+      {
+        // Tail of a message that was cut short, drop it
+        consume();
+        continue;
+      }
+      else if (header.offset != fragment.offset)
+      {
+        consume();
+        return fail("Fragment out of order: expected offset {}, got {}", fragment.offset, header.offset);
+      }
+
+      fragment.data = packet->first.subspan(sizeof(FragmentHeader));
+      callback(static_cast<Ref<Fragment>>(fragment));
+      consume();
+
+      fragment.offset += static_cast<u32>(fragment.data.size());
+      if (fragment.offset >= fragment.total_size)
+      {
+        return fragment.total_size;
+      }
+
+      spins = 0;
+    }
+  }
+
+  inline auto RingBufferView::push_batch(Ref<Span<const Packet>> packets) -> Result<usize>
+  {
+    for (const auto &packet : packets)
+    {
+      if (is_reserved_id(packet.id))
+      {
+        return fail("Packet id {} is reserved", packet.id);
+      }
 
-      std::memcpy(m_data_ptr + offset, src, first_chunk);
-      std::memcpy(m_data_ptr, src + first_chunk, second_chunk);
+      if (packet.data.size() > get_max_payload())
+      {
+        return fail("Data size {} exceeds the ring's limit of {}", packet.data.size(), get_max_payload());
+      }
+    }
+
+    Mut<u64> read = m_control_block->producer.cached_read_offset;
+    Mut<u64> write = get_local_write_offset();
+    Mut<usize> pushed = 0;
+
+    for (const auto &packet : packets)
+    {
+      const u32 padding = get_copy_padding(write, packet.data.size());
+      const u32 total_size = padding + get_record_size(static_cast<u32>(packet.data.size()));
+
+      // Only go back to the consumer's cache line once the known free space runs out
+      if (get_free_space(write, read) < total_size)
+      {
+        read = reload_read_offset();
+        if (get_free_space(write, read) < total_size)
+        {
+          break;
+        }
+      }
+
+      write = write_packet(write, padding, packet.id, packet.data);
+      pushed++;
+    }
+
+    if (pushed > 0)
+    {
+      publish_write_offset(write, static_cast<u32>(pushed));
+    }
+
+    if (pushed < packets.size())
+    {
+      record_full();
+    }
+
+    return pushed;
+  }
+
+  template<typename Fn>
+  inline auto RingBufferView::consume_all(ForwardRef<Fn> callback, const usize max_packets) -> usize
+  {
+    Mut<u64> write = m_control_block->consumer.cached_write_offset;
+    const u64 initial_read = get_local_read_offset();
+
+    Mut<u64> read = initial_read;
+    Mut<usize> consumed = 0;
+    Mut<PacketView> packet;
+
+    while (consumed < max_packets)
+    {
+      // Only go back to the producer's cache line once the known packets run out
+      if (!read_next_header(read, write, packet.header))
+      {
+        write = reload_write_offset();
+        if (!read_next_header(read, write, packet.header))
+        {
+          break;
+        }
+      }
+
+      read = read_payload_view(read, packet);
+      callback(static_cast<Ref<PacketView>>(packet));
+      consumed++;
+    }
+
+    if (read != initial_read)
+    {
+      publish_read_offset(read, static_cast<u32>(consumed));
+    }
+
+    return consumed;
+  }
+
+  inline auto RingBufferView::reserve(const u16 packet_id, const usize size) -> Result<Span<u8>>
+  {
+    if (is_reserved_id(packet_id))
+    {
+      return fail("Packet id {} is reserved", packet_id);
+    }
+
+    if (size > std::numeric_limits<u16>::max())
+    {
+      return fail("Data size exceeds u16 limit");
+    }
+
+    auto payload = try_reserve(packet_id, size);
+    if (!payload)
+    {
+      record_full();
+      return fail("RingBuffer full");
+    }
+
+    return *payload;
+  }
+
+  inline auto RingBufferView::try_reserve(const u16 packet_id, const usize size) -> Option<Span<u8>>
+  {
+    const u32 total_size = get_record_size(static_cast<u32>(size));
+
+    Mut<u64> write = get_local_write_offset();
+
+    // If the payload would straddle the end of the buffer, the tail is consumed by a skip record
+    // and the packet starts over at offset 0 (the mirror makes it contiguous anyway)
+    const u32 padding = get_wrap_padding(write, size);
+
+    if (get_free_space(write, m_control_block->producer.cached_read_offset) < padding + total_size &&
+        get_free_space(write, reload_read_offset()) < padding + total_size)
+    {
+      return std::nullopt;
+    }
+
+    if (padding > 0)
+    {
+      write = write_skip_record(write, padding);
+    }
+
+    const PacketHeader header{packet_id, static_cast<u16>(size)};
+    write_wrapped(get_index(write), &header, sizeof(PacketHeader));
+
+    const u64 data_write_offset = advance(write, get_header_size());
+
+    m_pending_write_offset = advance(write, total_size);
+    m_pending_write_packets++;
+    m_has_pending_write = true;
+
+    return Span<u8>(m_data_ptr + get_index(data_write_offset), size);
+  }
+
+  inline auto RingBufferView::commit() -> void
+  {
+    if (!m_has_pending_write)
+    {
+      return;
+    }
+
+    publish_write_offset(m_pending_write_offset, 0);
+  }
+
+  inline auto RingBufferView::peek() -> Option<PacketView>
+  {
+    const u64 initial_read = get_local_read_offset();
+
+    Mut<u64> read = initial_read;
+    Mut<PacketView> packet;
+    if (!read_next_header(read, m_control_block->consumer.cached_write_offset, packet.header) &&
+        !read_next_header(read, reload_write_offset(), packet.header))
+    {
+      // Skip records are released together with the next consume()
+      if (read != initial_read)
+      {
+        m_pending_read_offset = read;
+        m_has_pending_read = true;
+      }
+      return std::nullopt;
+    }
+
+    m_pending_read_offset = read_payload_view(read, packet);
+    m_pending_read_packets++;
+    m_has_pending_read = true;
+
+    return packet;
+  }
+
+  inline auto RingBufferView::consume() -> void
+  {
+    if (!m_has_pending_read)
+    {
+      return;
+    }
+
+    publish_read_offset(m_pending_read_offset, 0);
+  }
+
+  inline auto RingBufferView::get_control_block() -> ControlBlock *
+  {
+    return m_control_block;
+  }
+
+  inline auto RingBufferView::set_doorbell(const i32 fd) -> Result<void>
+  {
+    if ((m_flags & FLAG_WAITABLE) == 0)
+    {
+      return fail("RingBuffer was not created with FLAG_WAITABLE");
+    }
+
+    m_doorbell_fd = fd;
+    return {};
+  }
+
+  inline auto RingBufferView::arm_doorbell() -> bool
+  {
+    if ((m_flags & FLAG_WAITABLE) == 0)
+    {
+      return false;
+    }
+
+    MutRef<std::atomic<u32>> waiting_flag = m_control_block->producer.consumer_waiting;
+    waiting_flag.store(WAITER_DOORBELL, std::memory_order_seq_cst);
+
+    // Same race as park(): a publish right before the flag became visible would not ring
+    if (m_control_block->producer.write_offset.load(std::memory_order_seq_cst) != get_local_read_offset())
+    {
+      waiting_flag.store(WAITER_NONE, std::memory_order_relaxed);
+      return false;
+    }
+
+    return true;
+  }
+
+  inline auto RingBufferView::get_capacity() const -> u32
+  {
+    return m_capacity;
+  }
+
+  inline auto RingBufferView::get_flags() const -> u32
+  {
+    return m_flags;
+  }
+
+  inline auto RingBufferView::get_stats() const -> Stats
+  {
+    Mut<Stats> stats;
+    if (m_control_block == nullptr)
+    {
+      return stats;
+    }
+
+    Ref<decltype(ControlBlock::producer_stats)> producer_stats = m_control_block->producer_stats;
+    stats.packets_pushed = producer_stats.packets.load(std::memory_order_relaxed);
+    stats.bytes_pushed = producer_stats.bytes.load(std::memory_order_relaxed);
+    stats.full_rejections = producer_stats.full_rejections.load(std::memory_order_relaxed);
+    stats.high_water_mark = producer_stats.high_water_mark.load(std::memory_order_relaxed);
+    stats.last_push_ns = producer_stats.last_activity_ns.load(std::memory_order_relaxed);
+
+    Ref<decltype(ControlBlock::consumer_stats)> consumer_stats = m_control_block->consumer_stats;
+    stats.packets_popped = consumer_stats.packets.load(std::memory_order_relaxed);
+    stats.bytes_popped = consumer_stats.bytes.load(std::memory_order_relaxed);
+    stats.last_pop_ns = consumer_stats.last_activity_ns.load(std::memory_order_relaxed);
+
+    return stats;
+  }
+
+  inline auto RingBufferView::get_local_write_offset() const -> u64
+  {
+    if (m_has_pending_write)
+    {
+      return m_pending_write_offset;
+    }
+
+    return m_control_block->producer.write_offset.load(std::memory_order_relaxed);
+  }
+
+  inline auto RingBufferView::get_local_read_offset() const -> u64
+  {
+    if (m_has_pending_read)
+    {
+      return m_pending_read_offset;
+    }
+
+    return m_control_block->consumer.read_offset.load(std::memory_order_relaxed);
+  }
+
+  inline auto RingBufferView::reload_read_offset() -> u64
+  {
+    const u64 read = m_control_block->consumer.read_offset.load(std::memory_order_acquire);
+    m_control_block->producer.cached_read_offset = read;
+    return read;
+  }
+
+  inline auto RingBufferView::reload_write_offset() -> u64
+  {
+    const u64 write = m_control_block->producer.write_offset.load(std::memory_order_acquire);
+    m_control_block->consumer.cached_write_offset = write;
+    return write;
+  }
+
+  inline auto RingBufferView::publish_write_offset(const u64 write, const u32 packets) -> void
+  {
+    if (m_flags & FLAG_STATS)
+    {
+      record_push(write, packets + m_pending_write_packets);
+    }
+
+    m_control_block->producer.write_offset.store(write, std::memory_order_release);
+    m_has_pending_write = false;
+    m_pending_write_packets = 0;
+
+    if ((m_flags & FLAG_WAITABLE) && unpark(m_control_block->producer.consumer_waiting) == WAITER_DOORBELL &&
+        m_doorbell_fd != -1)
+    {
+      Doorbell::signal(m_doorbell_fd);
+    }
+  }
+
+  inline auto RingBufferView::publish_read_offset(const u64 read, const u32 packets) -> void
+  {
+    if (m_flags & FLAG_STATS)
+    {
+      record_pop(read, packets + m_pending_read_packets);
+    }
+
+    m_control_block->consumer.read_offset.store(read, std::memory_order_release);
+    m_has_pending_read = false;
+    m_pending_read_packets = 0;
+
+    if (m_flags & FLAG_WAITABLE)
+    {
+      unpark(m_control_block->consumer.producer_waiting);
+    }
+  }
+
+  inline auto RingBufferView::try_push(const u16 packet_id, Ref<Span<const u8>> data) -> bool
+  {
+    const u64 write = get_local_write_offset();
+
+    const u32 padding = get_copy_padding(write, data.size());
+    const u32 total_size = padding + get_record_size(static_cast<u32>(data.size()));
+
+    if (get_free_space(write, m_control_block->producer.cached_read_offset) < total_size &&
+        get_free_space(write, reload_read_offset()) < total_size)
+    {
+      return false;
+    }
+
+    publish_write_offset(write_packet(write, padding, packet_id, data), 1);
+
+    return true;
+  }
+
+  inline auto RingBufferView::record_push(const u64 write, const u32 packets) -> void
+  {
+    MutRef<decltype(ControlBlock::producer_stats)> stats = m_control_block->producer_stats;
+
+    const u64 previous = m_control_block->producer.write_offset.load(std::memory_order_relaxed);
+    bump_counter(stats.packets, packets);
+    bump_counter(stats.bytes, get_distance(previous, write));
+
+    const u64 used = get_distance(m_control_block->producer.cached_read_offset, write);
+    if (used > stats.high_water_mark.load(std::memory_order_relaxed))
+    {
+      stats.high_water_mark.store(used, std::memory_order_relaxed);
+    }
+
+    stats.last_activity_ns.store(get_timestamp_ns(), std::memory_order_relaxed);
+  }
+
+  inline auto RingBufferView::record_pop(const u64 read, const u32 packets) -> void
+  {
+    MutRef<decltype(ControlBlock::consumer_stats)> stats = m_control_block->consumer_stats;
+
+    const u64 previous = m_control_block->consumer.read_offset.load(std::memory_order_relaxed);
+    bump_counter(stats.packets, packets);
+    bump_counter(stats.bytes, get_distance(previous, read));
+
+    stats.last_activity_ns.store(get_timestamp_ns(), std::memory_order_relaxed);
+  }
+
+  inline auto RingBufferView::record_full() -> void
+  {
+    if (m_flags & FLAG_STATS)
+    {
+      bump_counter(m_control_block->producer_stats.full_rejections, 1);
+    }
+  }
+
+  inline auto RingBufferView::bump_counter(MutRef<std::atomic<u64>> counter, const u64 value) -> void
+  {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+  }
+
+  inline auto RingBufferView::get_timestamp_ns() -> u64
+  {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+  }
+
+  inline auto RingBufferView::park(MutRef<std::atomic<u32>> waiting_flag, Ref<std::atomic<u64>> cursor,
+                                   const u64 observed, const u64 timeout_us) -> void
+  {
+    waiting_flag.store(WAITER_PARKED, std::memory_order_seq_cst);
+
+    // The other side may have published right before it could see the flag, so check once more
+    if (cursor.load(std::memory_order_seq_cst) == observed)
+    {
+      utils::wait_on_address(waiting_flag, WAITER_PARKED, timeout_us);
+    }
+
+    waiting_flag.store(WAITER_NONE, std::memory_order_relaxed);
+  }
+
+  inline auto RingBufferView::unpark(MutRef<std::atomic<u32>> waiting_flag) -> u32
+  {
+    // Orders the cursor store before the flag load (pairs with the seq_cst operations in park())
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (waiting_flag.load(std::memory_order_relaxed) == WAITER_NONE)
+    {
+      return WAITER_NONE;
+    }
+
+    const u32 waiter = waiting_flag.exchange(WAITER_NONE, std::memory_order_relaxed);
+    if (waiter == WAITER_PARKED)
+    {
+      utils::wake_by_address(waiting_flag);
+    }
+    return waiter;
+  }
+
+  inline auto RingBufferView::wait_for_data(MutRef<u32> spins, const std::chrono::steady_clock::time_point deadline)
+      -> bool
+  {
+    // The failed attempt refreshed cached_write_offset, so it holds the last write_offset we saw
+    return wait_step(spins, deadline, m_control_block->producer.consumer_waiting,
+                     m_control_block->producer.write_offset, m_control_block->consumer.cached_write_offset);
+  }
+
+  inline auto RingBufferView::wait_for_space(MutRef<u32> spins, const std::chrono::steady_clock::time_point deadline)
+      -> bool
+  {
+    // The failed attempt refreshed cached_read_offset, so it holds the last read_offset we saw
+    return wait_step(spins, deadline, m_control_block->consumer.producer_waiting, m_control_block->consumer.read_offset,
+                     m_control_block->producer.cached_read_offset);
+  }
+
+  inline auto RingBufferView::wait_step(MutRef<u32> spins, const std::chrono::steady_clock::time_point deadline,
+                                        MutRef<std::atomic<u32>> waiting_flag, Ref<std::atomic<u64>> cursor,
+                                        const u64 observed) -> bool
+  {
+    if (spins < WAIT_SPIN_COUNT)
+    {
+      spins++;
+      utils::spin_pause();
+      return true;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= deadline)
+    {
+      return false;
+    }
+
+    const u64 remaining_us = std::chrono::duration_cast<std::chrono::microseconds>(deadline - now).count();
+    park(waiting_flag, cursor, observed, remaining_us);
+    return true;
+  }
+
+  inline auto RingBufferView::reserve_wait(const u16 packet_id, const usize size,
+                                           const std::chrono::steady_clock::time_point deadline) -> Result<Span<u8>>
+  {
+    Mut<u32> spins = 0;
+    Mut<bool> blocked = false;
+
+    while (true)
+    {
+      auto payload = try_reserve(packet_id, size);
+      if (payload)
+      {
+        return *payload;
+      }
+
+      if (!blocked)
+      {
+        record_full();
+        blocked = true;
+      }
+
+      if (!wait_for_space(spins, deadline))
+      {
+        return fail("RingBuffer full");
+      }
+    }
+  }
+
+  inline auto RingBufferView::get_max_payload() const -> u32
+  {
+    if ((m_flags & FLAG_ALIGNED) && !m_mirrored)
+    {
+      return get_max_fragment_payload();
+    }
+
+    // Wrapped offsets leave 1 byte empty
+    const u32 max_record = (m_flags & FLAG_MONOTONIC) ? m_capacity : m_capacity - 1;
+    if (max_record <= get_header_size())
+    {
+      return 0;
+    }
+
+    Mut<u32> payload = max_record - get_header_size();
+    if (m_flags & FLAG_ALIGNED)
+    {
+      payload -= payload % ALIGNED_RECORD_ALIGNMENT;
+    }
+    return std::min<u32>(payload, std::numeric_limits<u16>::max());
+  }
+
+  inline auto RingBufferView::get_max_fragment_payload() const -> u32
+  {
+    // With at most half the ring per packet, the skip record reserve() may need in front of it still fits
+    const u32 half = m_capacity / 2;
+    if (half <= get_header_size())
+    {
+      return 0;
+    }
+
+    Mut<u32> payload = std::min<u32>(half - get_header_size(), std::numeric_limits<u16>::max());
+    if (m_flags & FLAG_ALIGNED)
+    {
+      payload -= payload % ALIGNED_RECORD_ALIGNMENT;
+    }
+    return payload;
+  }
+
+  inline auto RingBufferView::read_next_header(MutRef<u64> read, const u64 write, MutRef<PacketHeader> out_header)
+      -> bool
+  {
+    while (read != write)
+    {
+      read_wrapped(get_index(read), &out_header, sizeof(PacketHeader));
+
+      if (out_header.id != PACKET_ID_SKIP)
+      {
+        return true;
+      }
+
+      read = advance(read, get_record_size(out_header.payload_size));
+    }
+
+    return false;
+  }
+
+  inline auto RingBufferView::read_payload_view(const u64 read, MutRef<PacketView> packet) const -> u64
+  {
+    const u32 size = packet.header.payload_size;
+    const u64 data_read_offset = advance(read, get_header_size());
+    const u32 data_read_index = get_index(data_read_offset);
+
+    if (m_mirrored || data_read_index + size <= m_capacity)
+    {
+      packet.first = Span<const u8>(m_data_ptr + data_read_index, size);
+      packet.second = {};
+    }
+    else
+    {
+      const u32 first_chunk = m_capacity - data_read_index;
+      packet.first = Span<const u8>(m_data_ptr + data_read_index, first_chunk);
+      packet.second = Span<const u8>(m_data_ptr, size - first_chunk);
+    }
+
+    return advance(read, get_record_size(size));
+  }
+
+  inline auto RingBufferView::get_wrap_padding(const u64 write, const usize size) const -> u32
+  {
+    if (m_mirrored)
+    {
+      return 0;
+    }
+
+    const u32 payload_index = get_index(advance(write, get_header_size()));
+    return payload_index + size > m_capacity ? m_capacity - get_index(write) : 0;
+  }
+
+  inline auto RingBufferView::get_copy_padding(const u64 write, const usize size) const -> u32
+  {
+    return (m_flags & FLAG_ALIGNED) ? get_wrap_padding(write, size) : 0;
+  }
+
+  inline auto RingBufferView::write_packet(const u64 packet_write, const u32 padding, const u16 packet_id,
+                                           Ref<Span<const u8>> data) -> u64
+  {
+    const u64 write = padding > 0 ? write_skip_record(packet_write, padding) : packet_write;
+
+    const PacketHeader header{packet_id, static_cast<u16>(data.size())};
+    write_wrapped(get_index(write), &header, sizeof(PacketHeader));
+
+    const u64 data_write_offset = advance(write, get_header_size());
+
+    if (!data.empty())
+    {
+      write_wrapped(get_index(data_write_offset), data.data(), static_cast<u32>(data.size()));
+    }
+
+    return advance(write, get_record_size(static_cast<u32>(data.size())));
+  }
+
+  inline auto RingBufferView::write_skip_record(const u64 write, const u32 padding) -> u64
+  {
+    const PacketHeader skip_header{PACKET_ID_SKIP, static_cast<u16>(padding - get_header_size())};
+    write_wrapped(get_index(write), &skip_header, sizeof(PacketHeader));
+    return advance(write, padding);
+  }
+
+  inline auto RingBufferView::get_header_size() const -> u32
+  {
+    return (m_flags & FLAG_ALIGNED) ? ALIGNED_RECORD_ALIGNMENT : sizeof(PacketHeader);
+  }
+
+  inline auto RingBufferView::get_record_size(const u32 payload_size) const -> u32
+  {
+    if (m_flags & FLAG_ALIGNED)
+    {
+      return (ALIGNED_RECORD_ALIGNMENT + payload_size + ALIGNED_RECORD_ALIGNMENT - 1) & ~(ALIGNED_RECORD_ALIGNMENT - 1);
+    }
+
+    return sizeof(PacketHeader) + payload_size;
+  }
+
+  inline auto RingBufferView::get_index(const u64 cursor) const -> u32
+  {
+    if (m_flags & FLAG_MONOTONIC)
+    {
+      return static_cast<u32>(cursor) & m_mask;
+    }
+
+    return static_cast<u32>(cursor);
+  }
+
+  inline auto RingBufferView::advance(const u64 cursor, const u32 size) const -> u64
+  {
+    if (m_flags & FLAG_MONOTONIC)
+    {
+      return cursor + size;
+    }
+
+    return (static_cast<u32>(cursor) + size) % m_capacity;
+  }
+
+  inline auto RingBufferView::get_free_space(const u64 write, const u64 read) const -> u32
+  {
+    if (m_flags & FLAG_MONOTONIC)
+    {
+      return m_capacity - static_cast<u32>(write - read);
+    }
+
+    // Wrapped offsets leave 1 byte empty, or a full ring would look empty
+    const u32 w = static_cast<u32>(write);
+    const u32 r = static_cast<u32>(read);
+    return ((r <= w) ? (m_capacity - w) + r : (r - w)) - 1;
+  }
+
+  inline auto RingBufferView::get_distance(const u64 from, const u64 to) const -> u32
+  {
+    if (m_flags & FLAG_MONOTONIC)
+    {
+      return static_cast<u32>(to - from);
+    }
+
+    const u32 f = static_cast<u32>(from);
+    const u32 t = static_cast<u32>(to);
+    return (t >= f) ? t - f : (m_capacity - f) + t;
+  }
+
+  inline auto RingBufferView::write_wrapped(const u32 offset, const void *data, const u32 size) -> void
+  {
+    if (m_mirrored || offset + size <= m_capacity)
+    {
+      copy_in(m_data_ptr + offset, data, size);
+    }
+    else
+    {
+      const u32 first_chunk = m_capacity - offset;
+      const u32 second_chunk = size - first_chunk;
+
+      const u8 *src = static_cast<const u8 *>(data);
+
+      copy_in(m_data_ptr + offset, src, first_chunk);
+      copy_in(m_data_ptr, src + first_chunk, second_chunk);
+    }
+  }
+
+  inline auto RingBufferView::copy_in(u8 *dst, const void *src, const usize size) -> void
+  {
+    if ((m_flags & FLAG_STREAMING_COPY) && size >= STREAMING_COPY_THRESHOLD)
+    {
+      utils::copy_non_temporal(dst, src, size);
+    }
+    else
+    {
+      std::memcpy(dst, src, size);
     }
   }
 
   inline auto RingBufferView::read_wrapped(const u32 offset, void *out_data, const u32 size) -> void
   {
-    if (offset + size <= m_capacity)
+    if (m_mirrored || offset + size <= m_capacity)
     {
       std::memcpy(out_data, m_data_ptr + offset, size);
     }
@@ -0,0 +1,386 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <crux/adt/ring_buffer.hpp>
+
+#include <cstring>
+#include <thread>
+
+namespace ia
+{
+  namespace rpc
+  {
+    static constexpr const usize RING_ALIGNMENT = 64;
+
+    // Polls that come back empty before the spinning loops start yielding the CPU
+    static constexpr const u32 IDLE_SPIN_COUNT = RingBufferView::WAIT_SPIN_COUNT;
+
+    // Payload prefix of every request and reply. The packet id carries the method.
+    struct CallHeader
+    {
+      Mut<u64> call_id{};
+    };
+
+    static constexpr const usize MAX_MESSAGE_SIZE = std::numeric_limits<u16>::max() - sizeof(CallHeader);
+
+    // A request (server side) or a reply (client side), payload in place
+    struct Message
+    {
+      Mut<u64> call_id{};
+      Mut<u16> method{};
+      Mut<Span<const u8>> data{};
+    };
+
+    // Both directions of one channel: the buffer is cut in two halves, each a ControlBlock followed by its ring
+    struct Rings
+    {
+      Mut<RingBufferView> requests = RingBufferView::default_instance();
+      Mut<RingBufferView> responses = RingBufferView::default_instance();
+    };
+
+    // Bytes needed for two rings of `capacity` bytes. Keep the capacity a multiple of RING_ALIGNMENT.
+    inline auto get_buffer_size(const u32 capacity) -> usize
+    {
+      return 2 * (sizeof(RingBufferView::ControlBlock) + capacity);
+    }
+
+    inline auto create_rings(Ref<Span<u8>> buffer, const bool is_owner, const u32 flags) -> Result<Rings>
+    {
+      const usize half = buffer.size() / 2;
+      if (buffer.size() % 2 != 0 || half % RING_ALIGNMENT != 0)
+      {
+        return fail("RPC buffer must be two halves of a multiple of {} bytes, got {} bytes", RING_ALIGNMENT,
+                    buffer.size());
+      }
+
+      auto requests = RingBufferView::create(buffer.subspan(0, half), is_owner, flags);
+      if (!requests)
+      {
+        return fail("{}", requests.error());
+      }
+
+      auto responses = RingBufferView::create(buffer.subspan(half), is_owner, flags);
+      if (!responses)
+      {
+        return fail("{}", responses.error());
+      }
+
+      return Rings{*requests, *responses};
+    }
+
+    // Writes one message without publishing it. Returns false if the ring is full.
+    inline auto write_message(MutRef<RingBufferView> ring, const u16 method, const u64 call_id,
+                              Ref<Span<const u8>> data) -> bool
+    {
+      auto payload = ring.reserve(method, sizeof(CallHeader) + data.size());
+      if (!payload)
+      {
+        return false;
+      }
+
+      const CallHeader header{call_id};
+      std::memcpy(payload->data(), &header, sizeof(CallHeader));
+      if (!data.empty())
+      {
+        std::memcpy(payload->data() + sizeof(CallHeader), data.data(), data.size());
+      }
+      return true;
+    }
+
+    // Messages are written through reserve(), so their payload is never split
+    inline auto read_message(Ref<RingBufferView::PacketView> packet) -> Message
+    {
+      Mut<CallHeader> header;
+      std::memcpy(&header, packet.first.data(), sizeof(CallHeader));
+      return Message{header.call_id, packet.header.id, packet.first.subspan(sizeof(CallHeader))};
+    }
+  } // namespace rpc
+
+  // Client end of a request/response channel laid out over one buffer (e.g. SharedMemory::get_data()).
+  //
+  // Calls are numbered in order and the server answers them in order, so replies are matched by walking the
+  // response ring: no table of pending calls is kept on either side.
+  class RpcClient
+  {
+public:
+    struct PendingCall
+    {
+      Mut<u64> id{};
+    };
+
+public:
+    static auto create(Ref<Span<u8>> buffer, const bool is_owner, const u32 flags = 0) -> Result<RpcClient>;
+
+    // Publishes a request and returns without waiting. Fails if the request ring is full.
+    // `method` is any packet id but RingBufferView::PACKET_ID_SKIP and PACKET_ID_FRAGMENT.
+    auto call(const u16 method, Ref<Span<const u8>> request) -> Result<PendingCall>;
+
+    // Hands the replies that arrived, up to and including the one for `call`, to callback(Ref<rpc::Message>)
+    // in place (replies to earlier calls come first). Returns true once the reply to `call` has been handled,
+    // by this poll or an earlier one.
+    template<typename Fn> auto poll(Ref<PendingCall> call, ForwardRef<Fn> callback) -> bool;
+
+    // Hands every reply that arrived (up to max_replies) to callback(Ref<rpc::Message>). Returns the count.
+    template<typename Fn>
+    auto poll_all(ForwardRef<Fn> callback, const usize max_replies = std::numeric_limits<usize>::max()) -> usize;
+
+    // Spins on poll() until the reply to `call` is handled, yielding after IDLE_SPIN_COUNT empty polls.
+    // Returns false on timeout.
+    template<typename Fn> auto wait(Ref<PendingCall> call, ForwardRef<Fn> callback, const u64 timeout_ms) -> bool;
+
+    // Calls still waiting for their reply
+    [[nodiscard]] auto get_pending_count() const -> u64;
+
+    auto get_rings() -> rpc::Rings &;
+
+protected:
+    RpcClient(Ref<rpc::Rings> rings);
+
+private:
+    Mut<rpc::Rings> m_rings;
+
+    Mut<u64> m_next_call_id{1};
+    Mut<u64> m_last_reply_id{0};
+  };
+
+  // Server end of a request/response channel, see RpcClient.
+  //
+  // Replies to one serve() pass are published together with a single store. A reply that does not fit in the
+  // response ring is parked in a backlog and sent by a later pass, before any new request is read.
+  class RpcServer
+  {
+public:
+    static auto create(Ref<Span<u8>> buffer, const bool is_owner, const u32 flags = 0) -> Result<RpcServer>;
+
+    // Runs handler(Ref<rpc::Message>) -> Span<const u8> for each pending request (up to max_requests) and
+    // replies with the bytes it returns (copied before the next request is handled, an empty span sends an
+    // empty reply). Replies longer than rpc::MAX_MESSAGE_SIZE go out empty, and the response ring must be able to
+    // hold the largest reply. Returns the number of requests handled.
+    template<typename Handler>
+    auto serve(ForwardRef<Handler> handler, const usize max_requests = std::numeric_limits<usize>::max()) -> usize;
+
+    // Serves until `running` turns false. Spins while idle (meant for a pinned thread), yielding after
+    // IDLE_SPIN_COUNT empty passes.
+    template<typename Handler> auto serve_loop(ForwardRef<Handler> handler, Ref<std::atomic<bool>> running) -> void;
+
+    auto get_rings() -> rpc::Rings &;
+
+protected:
+    RpcServer(Ref<rpc::Rings> rings);
+
+private:
+    struct BackloggedReply
+    {
+      Mut<u64> call_id{};
+      Mut<u16> method{};
+      Mut<Vec<u8>> data{};
+    };
+
+    Mut<rpc::Rings> m_rings;
+    Mut<Vec<BackloggedReply>> m_backlog{};
+
+private:
+    // Moves as much of the backlog as fits into the response ring (unpublished). Returns true if it emptied.
+    auto flush_backlog() -> bool;
+  };
+
+  inline auto RpcClient::create(Ref<Span<u8>> buffer, const bool is_owner, const u32 flags) -> Result<RpcClient>
+  {
+    auto rings = rpc::create_rings(buffer, is_owner, flags);
+    if (!rings)
+    {
+      return fail("{}", rings.error());
+    }
+
+    return RpcClient(*rings);
+  }
+
+  inline RpcClient::RpcClient(Ref<rpc::Rings> rings) : m_rings(rings)
+  {
+  }
+
+  inline auto RpcClient::call(const u16 method, Ref<Span<const u8>> request) -> Result<PendingCall>
+  {
+    if (method == RingBufferView::PACKET_ID_SKIP || method == RingBufferView::PACKET_ID_FRAGMENT)
+    {
+      return fail("Packet id {} is reserved", method);
+    }
+
+    if (request.size() > rpc::MAX_MESSAGE_SIZE)
+    {
+      return fail("Request size exceeds {} bytes", rpc::MAX_MESSAGE_SIZE);
+    }
+
+    if (!rpc::write_message(m_rings.requests, method, m_next_call_id, request))
+    {
+      return fail("RingBuffer full");
+    }
+    m_rings.requests.commit();
+
+    return PendingCall{m_next_call_id++};
+  }
+
+  template<typename Fn> inline auto RpcClient::poll(Ref<PendingCall> call, ForwardRef<Fn> callback) -> bool
+  {
+    if (call.id <= m_last_reply_id)
+    {
+      return true;
+    }
+
+    // Replies come back in call order, so the reply to `call` is exactly this many packets away
+    poll_all(callback, static_cast<usize>(call.id - m_last_reply_id));
+
+    return call.id <= m_last_reply_id;
+  }
+
+  template<typename Fn> inline auto RpcClient::poll_all(ForwardRef<Fn> callback, const usize max_replies) -> usize
+  {
+    return m_rings.responses.consume_all(
+        [&](Ref<RingBufferView::PacketView> packet) {
+          const rpc::Message reply = rpc::read_message(packet);
+          m_last_reply_id = reply.call_id;
+          callback(reply);
+        },
+        max_replies);
+  }
+
+  template<typename Fn>
+  inline auto RpcClient::wait(Ref<PendingCall> call, ForwardRef<Fn> callback, const u64 timeout_ms) -> bool
+  {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    Mut<u32> spins = 0;
+
+    while (!poll(call, callback))
+    {
+      if (spins < rpc::IDLE_SPIN_COUNT)
+      {
+        spins++;
+        utils::spin_pause();
+        continue;
+      }
+
+      if (std::chrono::steady_clock::now() >= deadline)
+      {
+        return false;
+      }
+      std::this_thread::yield();
+    }
+
+    return true;
+  }
+
+  inline auto RpcClient::get_pending_count() const -> u64
+  {
+    return m_next_call_id - 1 - m_last_reply_id;
+  }
+
+  inline auto RpcClient::get_rings() -> rpc::Rings &
+  {
+    return m_rings;
+  }
+
+  inline auto RpcServer::create(Ref<Span<u8>> buffer, const bool is_owner, const u32 flags) -> Result<RpcServer>
+  {
+    auto rings = rpc::create_rings(buffer, is_owner, flags);
+    if (!rings)
+    {
+      return fail("{}", rings.error());
+    }
+
+    return RpcServer(*rings);
+  }
+
+  inline RpcServer::RpcServer(Ref<rpc::Rings> rings) : m_rings(rings)
+  {
+  }
+
+  template<typename Handler>
+  inline auto RpcServer::serve(ForwardRef<Handler> handler, const usize max_requests) -> usize
+  {
+    if (!m_backlog.empty() && !flush_backlog())
+    {
+      m_rings.responses.commit();
+      return 0;
+    }
+
+    const usize served = m_rings.requests.consume_all(
+        [&](Ref<RingBufferView::PacketView> packet) {
+          const rpc::Message request = rpc::read_message(packet);
+
+          Mut<Span<const u8>> reply = handler(request);
+          if (reply.size() > rpc::MAX_MESSAGE_SIZE)
+          {
+            reply = {};
+          }
+
+          // Once one reply is backlogged, the ones behind it must queue up too to keep the order
+          if (!m_backlog.empty() || !rpc::write_message(m_rings.responses, request.method, request.call_id, reply))
+          {
+            m_backlog.push_back(BackloggedReply{request.call_id, request.method, Vec<u8>(reply.begin(), reply.end())});
+          }
+        },
+        max_requests);
+
+    m_rings.responses.commit();
+
+    return served;
+  }
+
+  template<typename Handler>
+  inline auto RpcServer::serve_loop(ForwardRef<Handler> handler, Ref<std::atomic<bool>> running) -> void
+  {
+    Mut<u32> spins = 0;
+
+    while (running.load(std::memory_order_relaxed))
+    {
+      if (serve(handler) > 0)
+      {
+        spins = 0;
+      }
+      else if (spins < rpc::IDLE_SPIN_COUNT)
+      {
+        spins++;
+        utils::spin_pause();
+      }
+      else
+      {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  inline auto RpcServer::flush_backlog() -> bool
+  {
+    Mut<usize> flushed = 0;
+    for (const auto &reply : m_backlog)
+    {
+      if (!rpc::write_message(m_rings.responses, reply.method, reply.call_id, reply.data))
+      {
+        break;
+      }
+      flushed++;
+    }
+
+    m_backlog.erase(m_backlog.begin(), m_backlog.begin() + static_cast<isize>(flushed));
+    return m_backlog.empty();
+  }
+
+  inline auto RpcServer::get_rings() -> rpc::Rings &
+  {
+    return m_rings;
+  }
+} // namespace ia
@@ -0,0 +1,182 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <crux/crux.hpp>
+
+#include <atomic>
+#include <bit>
+#include <new>
+#include <type_traits>
+
+namespace ia
+{
+  // Bounded Single-Producer Single-Consumer queue of T, for handing objects between threads of one process.
+  //
+  // Unlike RingBufferView there is no framing and no byte copy: every element lives in its own slot and is moved
+  // in and out. Cursors are monotonic u64 counts over a power-of-two capacity, and like RingBufferView's
+  // ControlBlock each side caches the other side's cursor on its own cache line.
+  template<typename T, usize N> class SpscQueue
+  {
+public:
+    static constexpr const usize CAPACITY = N;
+
+    static_assert(N > 0 && std::has_single_bit(N), "SpscQueue capacity must be a power of two");
+    static_assert(std::is_nothrow_move_constructible_v<T>, "SpscQueue elements must be nothrow move constructible");
+
+public:
+    SpscQueue() = default;
+    ~SpscQueue();
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    // Producer side. Returns false (leaving the arguments untouched) if the queue is full.
+    template<typename... Args> auto emplace(ForwardRef<Args>... args) -> bool;
+    auto push(Ref<T> value) -> bool;
+    auto push(T &&value) -> bool;
+
+    // Consumer side. Returns nullopt if the queue is empty.
+    auto pop() -> Option<T>;
+
+    // Consumer side, in-place access: front() returns nullptr if the queue is empty, otherwise the element stays
+    // in the queue until discard() destroys it. discard() must only follow a non-null front().
+    auto front() -> T *;
+    auto discard() -> void;
+
+    // Snapshots, only exact when called from a side that is not racing
+    [[nodiscard]] auto get_size() const -> usize;
+    [[nodiscard]] auto is_empty() const -> bool;
+
+private:
+    static constexpr const u64 MASK = N - 1;
+
+    struct alignas(64)
+    {
+      Mut<std::atomic<u64>> write_cursor{0};
+      Mut<u64> cached_read_cursor{0};
+    } m_producer;
+
+    struct alignas(64)
+    {
+      Mut<std::atomic<u64>> read_cursor{0};
+      Mut<u64> cached_write_cursor{0};
+    } m_consumer;
+
+    struct Slot
+    {
+      alignas(T) Mut<u8> storage[sizeof(T)];
+    };
+
+    alignas(64) Mut<Slot> m_slots[N];
+
+private:
+    auto get_slot(const u64 cursor) -> T *;
+  };
+
+  template<typename T, usize N> inline SpscQueue<T, N>::~SpscQueue()
+  {
+    while (front() != nullptr)
+    {
+      discard();
+    }
+  }
+
+  template<typename T, usize N> inline auto SpscQueue<T, N>::get_slot(const u64 cursor) -> T *
+  {
+    return std::launder(reinterpret_cast<T *>(m_slots[cursor & MASK].storage));
+  }
+
+  template<typename T, usize N>
+  template<typename... Args>
+  inline auto SpscQueue<T, N>::emplace(ForwardRef<Args>... args) -> bool
+  {
+    const u64 write = m_producer.write_cursor.load(std::memory_order_relaxed);
+
+    if (write - m_producer.cached_read_cursor == N)
+    {
+      m_producer.cached_read_cursor = m_consumer.read_cursor.load(std::memory_order_acquire);
+      if (write - m_producer.cached_read_cursor == N)
+      {
+        return false;
+      }
+    }
+
+    new (m_slots[write & MASK].storage) T(std::forward<Args>(args)...);
+    m_producer.write_cursor.store(write + 1, std::memory_order_release);
+
+    return true;
+  }
+
+  template<typename T, usize N> inline auto SpscQueue<T, N>::push(Ref<T> value) -> bool
+  {
+    return emplace(value);
+  }
+
+  template<typename T, usize N> inline auto SpscQueue<T, N>::push(T &&value) -> bool
+  {
+    return emplace(std::move(value));
+  }
+
+  template<typename T, usize N> inline auto SpscQueue<T, N>::front() -> T *
+  {
+    const u64 read = m_consumer.read_cursor.load(std::memory_order_relaxed);
+
+    if (read == m_consumer.cached_write_cursor)
+    {
+      m_consumer.cached_write_cursor = m_producer.write_cursor.load(std::memory_order_acquire);
+      if (read == m_consumer.cached_write_cursor)
+      {
+        return nullptr;
+      }
+    }
+
+    return get_slot(read);
+  }
+
+  template<typename T, usize N> inline auto SpscQueue<T, N>::discard() -> void
+  {
+    const u64 read = m_consumer.read_cursor.load(std::memory_order_relaxed);
+
+    get_slot(read)->~T();
+    m_consumer.read_cursor.store(read + 1, std::memory_order_release);
+  }
+
+  template<typename T, usize N> inline auto SpscQueue<T, N>::pop() -> Option<T>
+  {
+    T *element = front();
+    if (element == nullptr)
+    {
+      return std::nullopt;
+    }
+
+    Mut<Option<T>> value{std::move(*element)};
+    discard();
+    return value;
+  }
+
+  template<typename T, usize N> inline auto SpscQueue<T, N>::get_size() const -> usize
+  {
+    const u64 read = m_consumer.read_cursor.load(std::memory_order_acquire);
+    const u64 write = m_producer.write_cursor.load(std::memory_order_acquire);
+    return static_cast<usize>(write - read);
+  }
+
+  template<typename T, usize N> inline auto SpscQueue<T, N>::is_empty() const -> bool
+  {
+    return get_size() == 0;
+  }
+} // namespace ia
@@ -0,0 +1,151 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <crux/journal.hpp>
+#include <crux/logger.hpp>
+
+namespace ia
+{
+  namespace binary_log
+  {
+    // A binary log is a journal (see JournalWriter) of two packet kinds:
+    // - PACKET_ID_CALL_SITE: [CallSiteHeader][ArgType x arg_count][file][format], written just before the first
+    //   record of a call site, so the file carries everything needed to decode it without the binary that wrote it
+    // - PACKET_ID_RECORD: [u32 call site id][encoded arguments], stamped with the logger's steady-clock timestamp
+    // Call site ids are local to the file: 1, 2, 3... in the order the sites are first written, so each one is
+    // below the number of records.
+    static constexpr const u16 PACKET_ID_CALL_SITE = 1;
+    static constexpr const u16 PACKET_ID_RECORD = 2;
+
+    struct CallSiteHeader
+    {
+      Mut<u32> id{};
+      Mut<u32> line{};
+      Mut<u16> file_size{};
+      Mut<u16> format_size{};
+      Mut<u8> level{};
+      Mut<u8> arg_count{};
+      Mut<u16> reserved{};
+    };
+
+    static_assert(sizeof(CallSiteHeader) == 16, "CallSiteHeader must be packed");
+  } // namespace binary_log
+
+  // Records deferred log calls without formatting them. Install it with
+  //
+  //   logger::set_record_sink(BinaryLogWriter::sink, &writer);
+  //
+  // The writer is not thread-safe: pair it with logger::start_async() so only the async worker appends to it.
+  class BinaryLogWriter
+  {
+public:
+    BinaryLogWriter() = default;
+
+    static auto create(Ref<String> path_prefix, Ref<JournalWriterOptions> options = {}) -> Result<BinaryLogWriter>;
+
+    auto append(Ref<logger::CallSite> call_site, const u64 timestamp_ns, Span<const u8> args) -> Result<void>;
+
+    // logger::RecordSink forwarding to the BinaryLogWriter passed as user_data. Failed appends are counted.
+    static auto sink(void *user_data, Ref<logger::CallSite> call_site, u64 timestamp_ns, Span<const u8> args)
+        -> void;
+
+    auto close() -> void;
+
+    [[nodiscard]] auto get_failed_count() const -> u64;
+
+private:
+    Mut<JournalWriter> m_journal{};
+    // File-local id of each call site written so far, indexed by the process-wide id (0 if not written yet)
+    Mut<Vec<u32>> m_file_ids{};
+    Mut<u32> m_file_id_count{0};
+    Mut<Vec<u8>> m_scratch{};
+    Mut<u64> m_failed_count{0};
+
+private:
+    auto append_call_site(Ref<logger::CallSite> call_site, const u32 file_id, const u64 timestamp_ns)
+        -> Result<void>;
+  };
+
+  // Decodes a file written by BinaryLogWriter back into text, in any process
+  class BinaryLogReader
+  {
+public:
+    struct Record
+    {
+      Mut<u64> timestamp_ns{};
+      Mut<logger::Level> level{};
+      Mut<StringView> file{};
+      Mut<u32> line{};
+      Mut<String> message{};
+    };
+
+public:
+    static auto open(Ref<String> path_prefix) -> Result<BinaryLogReader>;
+
+    // Calls callback(Ref<Record>) for every record in order, returns the number of records decoded
+    template<typename Fn> auto for_each(ForwardRef<Fn> callback) const -> Result<u64>;
+
+    auto read_all() const -> Result<Vec<Record>>;
+
+private:
+    struct CallSiteEntry
+    {
+      Mut<logger::Level> level{};
+      Mut<u32> line{};
+      Mut<StringView> file{};
+      Mut<StringView> format{};
+      Mut<Vec<logger::ArgType>> arg_types{};
+    };
+
+    Mut<JournalReader> m_journal{};
+    // Indexed by call site id; the views point into the mapped journal
+    Mut<Vec<Option<CallSiteEntry>>> m_call_sites{};
+
+private:
+    auto decode(Ref<JournalReader::Entry> entry, MutRef<Record> out) const -> Result<bool>;
+  };
+
+  template<typename Fn> inline auto BinaryLogReader::for_each(ForwardRef<Fn> callback) const -> Result<u64>
+  {
+    Mut<Record> record;
+    Mut<u64> count = 0;
+
+    for (Mut<u64> i = 0; i < m_journal.get_record_count(); i++)
+    {
+      const auto entry = m_journal.get_entry(i);
+      if (!entry)
+      {
+        return fail("Binary log record {} is missing", i);
+      }
+
+      const auto decoded = decode(*entry, record);
+      if (!decoded)
+      {
+        return fail("Binary log record {}: {}", i, decoded.error());
+      }
+      if (!*decoded)
+      {
+        continue;
+      }
+
+      callback(std::as_const(record));
+      count++;
+    }
+
+    return count;
+  }
+} // namespace ia
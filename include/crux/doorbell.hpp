@@ -0,0 +1,57 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <crux/unique_handle.hpp>
+
+namespace ia
+{
+  namespace doorbell
+  {
+    auto close_fd(const i32 fd) -> void;
+
+    using UniqueFd = UniqueHandle<i32, -1, close_fd>;
+  } // namespace doorbell
+
+  // eventfd-based readiness notification (Linux), meant for consumers that run an epoll loop.
+  //
+  // Register get_fd() for EPOLLIN and hand the fd to the ring views with RingBufferView::set_doorbell().
+  // The fd can be passed to a peer process (SCM_RIGHTS or inheritance) and wrapped there with adopt().
+  class Doorbell
+  {
+public:
+    Doorbell() = default;
+
+    static auto create() -> Result<Doorbell>;
+
+    // Takes ownership of an eventfd received from another process
+    static auto adopt(const i32 fd) -> Doorbell;
+
+    // Makes the fd readable
+    auto signal() -> void;
+    static auto signal(const i32 fd) -> void;
+
+    // Resets the fd to not readable. Returns the number of signals since the last drain (0 if none).
+    auto drain() -> u64;
+
+    [[nodiscard]] auto get_fd() const -> i32;
+
+    [[nodiscard]] auto is_valid() const -> bool;
+
+private:
+    Mut<doorbell::UniqueFd> m_fd{};
+  };
+} // namespace ia
@@ -0,0 +1,191 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <crux/adt/ring_buffer.hpp>
+
+namespace ia
+{
+  namespace journal
+  {
+    static constexpr const u32 SEGMENT_MAGIC = 0x4E524A49; // "IJRN"
+    static constexpr const u32 SEGMENT_VERSION = 1;
+
+    static constexpr const u32 SEGMENT_FLAG_CRC32 = 1 << 0;
+
+    // Segment file layout: [SegmentHeader][IndexEntry x index_capacity][records]
+    //
+    // Records use the RingBufferView framing (PacketHeader + payload, back to back). The index holds one entry
+    // per record, in order, so it doubles as the timestamp index used for seeking and paced replay.
+    struct alignas(64) SegmentHeader
+    {
+      Mut<u32> magic{0};
+      Mut<u32> version{0};
+      Mut<u32> flags{0};
+      Mut<u32> segment_index{0};
+
+      Mut<u64> data_capacity{0};
+      Mut<u32> index_capacity{0};
+
+      // Updated after every record, so a segment that was never sealed is still readable up to here
+      Mut<u32> record_count{0};
+      Mut<u64> data_size{0};
+
+      Mut<u32> sealed{0};
+      Mut<u32> crc32{0};
+    };
+
+    struct IndexEntry
+    {
+      Mut<u64> timestamp_ns{0};
+      Mut<u64> offset{0};
+    };
+
+    // Read-write or read-only mapping of a whole file
+    class MappedFile
+    {
+  public:
+      MappedFile() = default;
+      ~MappedFile();
+
+      MappedFile(const MappedFile &) = delete;
+      MappedFile &operator=(const MappedFile &) = delete;
+
+      MappedFile(MappedFile &&other);
+      MappedFile &operator=(MappedFile &&other);
+
+      // Creates (or truncates) `path` with `size` bytes, allocated on disk up front on Linux
+      static auto create(Ref<String> path, const usize size) -> Result<MappedFile>;
+      static auto open(Ref<String> path) -> Result<MappedFile>;
+
+      auto get_data() -> Span<u8>;
+      [[nodiscard]] auto get_data() const -> Span<const u8>;
+
+      [[nodiscard]] auto is_valid() const -> bool;
+
+      // Blocks until the mapping has been written back to the file
+      auto sync() -> Result<void>;
+
+  private:
+      Mut<u8 *> m_base{};
+      Mut<usize> m_size{};
+
+  private:
+      auto unmap() -> void;
+    };
+
+    auto get_segment_path(Ref<String> path_prefix, const u32 segment_index) -> String;
+  } // namespace journal
+
+  struct JournalWriterOptions
+  {
+    // Bytes of records per segment, a new segment is started when they run out
+    Mut<usize> segment_size = 64 * 1024 * 1024;
+
+    // Records per segment, 0 picks one entry per 64 bytes of segment_size
+    Mut<u32> index_capacity = 0;
+
+    // Store a CRC32 of the records when a segment is sealed
+    Mut<bool> crc32 = false;
+  };
+
+  // Append-only recorder of packets, written to `<path_prefix>.<segment>.journal` files.
+  //
+  // Segments are preallocated and mapped up front, so append() is a couple of memcpys into the mapping: the
+  // only syscalls happen when a segment is rotated.
+  class JournalWriter
+  {
+public:
+    using Options = JournalWriterOptions;
+
+public:
+    JournalWriter() = default;
+    ~JournalWriter();
+
+    JournalWriter(const JournalWriter &) = delete;
+    JournalWriter &operator=(const JournalWriter &) = delete;
+
+    JournalWriter(JournalWriter &&other);
+    JournalWriter &operator=(JournalWriter &&other);
+
+    // Starts a new journal, removing any segments an earlier journal left under `path_prefix`
+    static auto create(Ref<String> path_prefix, Ref<Options> options = {}) -> Result<JournalWriter>;
+
+    // Timestamps default to the system clock, in nanoseconds. One earlier than the previous record's (the clock
+    // stepped backwards) is stored as that one instead, so the index stays sorted for seeking.
+    auto append(const u16 packet_id, Ref<Span<const u8>> data) -> Result<void>;
+    auto append(const u16 packet_id, Ref<Span<const u8>> data, const u64 timestamp_ns) -> Result<void>;
+
+    // Seals the current segment (writing its CRC32 if enabled). Called by the destructor.
+    auto close() -> void;
+
+    [[nodiscard]] auto get_segment_count() const -> u32;
+
+private:
+    Mut<String> m_path_prefix{};
+    Mut<Options> m_options{};
+
+    Mut<journal::MappedFile> m_file{};
+    Mut<journal::SegmentHeader *> m_header{};
+    Mut<journal::IndexEntry *> m_index{};
+    Mut<u8 *> m_data{};
+    Mut<u32> m_segment_count{0};
+    Mut<u64> m_last_timestamp_ns{0};
+
+private:
+    auto open_segment() -> Result<void>;
+    auto seal_segment() -> void;
+  };
+
+  // Reads every segment of a journal written by JournalWriter
+  class JournalReader
+  {
+public:
+    struct Entry
+    {
+      Mut<u64> timestamp_ns{};
+      Mut<u16> id{};
+      Mut<Span<const u8>> data{};
+    };
+
+public:
+    // Fails if a sealed segment does not match its CRC32, or if an index entry points outside its segment
+    static auto open(Ref<String> path_prefix) -> Result<JournalReader>;
+
+    [[nodiscard]] auto get_record_count() const -> u64;
+
+    auto get_entry(const u64 index) const -> Option<Entry>;
+
+    // Index of the first record stamped at or after timestamp_ns (get_record_count() if none)
+    [[nodiscard]] auto seek(const u64 timestamp_ns) const -> u64;
+
+    // Pushes records [first, end) into `ring`, spaced like they were recorded divided by `speed`
+    // (0 replays as fast as the ring accepts them). Waits up to timeout_ms for room on each packet.
+    // Returns the number of packets pushed.
+    auto replay(MutRef<RingBufferView> ring, const f64 speed = 1.0, const u64 first = 0, const u64 timeout_ms = 1000)
+        const -> Result<u64>;
+
+private:
+    Mut<Vec<journal::MappedFile>> m_segments{};
+
+    // m_first_records[i] is the global index of segment i's first record
+    Mut<Vec<u64>> m_first_records{};
+    Mut<u64> m_record_count{0};
+
+private:
+    auto get_header(const usize segment) const -> const journal::SegmentHeader *;
+  };
+} // namespace ia
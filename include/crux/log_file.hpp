@@ -0,0 +1,135 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <crux/journal.hpp>
+#include <crux/logger.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace ia
+{
+  struct RotatingFileSinkOptions
+  {
+    // Bytes mapped per file. A file is rotated when the next line does not fit; longer lines are truncated.
+    Mut<usize> file_size = 64 * 1024 * 1024;
+    // Rotate once a file has been open this long, 0 disables time-based rotation
+    Mut<u64> max_age_ms = 0;
+    // Files kept, including the current one and those left by earlier runs; older ones are deleted. 0 keeps them
+    // all.
+    Mut<u32> max_files = 0;
+    // Write a finished file back to disk before moving on. This is the only time the sink syncs.
+    Mut<bool> sync_on_rotate = true;
+  };
+
+  // Log sink appending text lines to `<path_prefix>.<index>.log` files.
+  //
+  // Each file is created at its full size and mapped up front, so logging a line is a memcpy into the mapping.
+  // A background thread keeps the next file created and mapped ahead of time, and finishes rotated ones (sync,
+  // unmap, truncate to the bytes written), so a rotation only swaps mappings on the logging thread. It blocks only
+  // if the next file is not ready yet. This costs one extra preallocated file on disk.
+  //
+  // Indices continue after the highest file already on disk, so a restart never overwrites an earlier run. Until
+  // it is finished, the live file keeps its full size with a zero-filled tail: after a crash, create() trims the
+  // files it finds back to their last line. A sink holds an exclusive lock on `<path_prefix>.lock` until it is
+  // closed, and create() fails while another sink (in this process or any other) holds it: trimming and
+  // pruning would otherwise cut into that sink's live files. Install it next to (or instead of) the console with
+  //
+  //   logger::add_sink(RotatingFileSink::handler, &sink, logger::Level::Info);
+  class RotatingFileSink
+  {
+public:
+    using Options = RotatingFileSinkOptions;
+
+public:
+    RotatingFileSink() = default;
+    ~RotatingFileSink();
+
+    RotatingFileSink(const RotatingFileSink &) = delete;
+    RotatingFileSink &operator=(const RotatingFileSink &) = delete;
+
+    static auto create(Ref<String> path_prefix, Ref<Options> options = {})
+        -> Result<std::unique_ptr<RotatingFileSink>>;
+
+    // Safe to call from several threads, though it only sees one at a time when fed by the async worker
+    auto write(logger::Level level, StringView message, StringView file, u32 line) -> void;
+
+    // logger::Handler forwarding to the RotatingFileSink passed as user_data
+    static auto handler(void *user_data, logger::Level level, StringView message, StringView file, u32 line)
+        -> void;
+
+    // Finishes the current file and starts the next one
+    auto rotate() -> Result<void>;
+
+    // Finishes the current file, deletes the one prepared ahead and stops the background thread. Lines written
+    // afterwards are dropped. Called by the destructor.
+    auto close() -> void;
+
+    [[nodiscard]] auto get_current_path() const -> String;
+    [[nodiscard]] auto get_current_index() const -> u32;
+    // Lines lost because a rotation failed, or written after close()
+    [[nodiscard]] auto get_dropped_count() const -> u64;
+
+    static auto get_file_path(Ref<String> path_prefix, const u32 file_index) -> String;
+    static auto get_lock_path(Ref<String> path_prefix) -> String;
+
+private:
+    struct FinishedFile
+    {
+      Mut<journal::MappedFile> file{};
+      Mut<String> path{};
+      Mut<usize> size{};
+    };
+
+    Mut<String> m_path_prefix{};
+    Mut<Options> m_options{};
+
+    // Descriptor holding the prefix lock, -1 once released
+    Mut<i32> m_lock_fd{-1};
+
+    // Guards everything below. The background thread only holds it to pick up work and hand files over.
+    mutable Mut<std::mutex> m_mutex{};
+    Mut<journal::MappedFile> m_file{};
+    Mut<usize> m_offset{0};
+    Mut<u32> m_current_index{0};
+    Mut<std::chrono::steady_clock::time_point> m_opened_at{};
+    Mut<u64> m_dropped_count{0};
+    Mut<bool> m_closed{false};
+
+    // Oldest file still on disk, and the index the next prepared file gets
+    Mut<u32> m_first_index{0};
+    Mut<u32> m_next_index{0};
+
+    Mut<std::thread> m_worker{};
+    Mut<std::condition_variable> m_wake{};
+    Mut<std::condition_variable> m_ready{};
+    Mut<bool> m_stop_requested{false};
+    Mut<bool> m_prepare_requested{false};
+    Mut<bool> m_prepare_failed{false};
+    Mut<journal::MappedFile> m_prepared_file{};
+    Mut<u32> m_prepared_index{0};
+    Mut<Vec<FinishedFile>> m_finished_files{};
+
+private:
+    // Swaps in the prepared file, handing the current one to the background thread
+    auto rotate_locked(MutRef<std::unique_lock<std::mutex>> lock) -> Result<void>;
+    auto run_worker() -> void;
+  };
+} // namespace ia
@@ -17,8 +17,13 @@
 
 #include <crux/crux.hpp>
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <format>
+#include <iterator>
 #include <source_location>
+#include <type_traits>
 
 namespace ia
 {
@@ -34,39 +39,594 @@ namespace ia
       Fatal
     };
 
+    // `file` is the basename of the logging source file
     using Handler = void (*)(void *user_data, Level level, StringView message, StringView file, u32 line);
 
     auto set_handler(Handler handler, void *user_data) -> void;
 
+    // A Handler that discards everything, for set_handler() when only sinks should see records
+    auto null_handler(void *user_data, Level level, StringView message, StringView file, u32 line) -> void;
+
+    // Sinks receive every record the Handler does, from the same thread (the logging thread, or the async
+    // worker), provided the record's level passes the sink's own threshold. Emitting does not lock.
+    // remove_sink() waits for the calls already inside the sink to return, so its user_data may be freed as soon
+    // as remove_sink() does; it must therefore not be called from within that sink.
+    static constexpr const u32 MAX_SINKS = 8;
+
+    using SinkId = u32;
+
+    auto add_sink(Handler handler, void *user_data, Level min_level = Level::Trace) -> Result<SinkId>;
+    auto remove_sink(const SinkId id) -> bool;
+    auto set_sink_level(const SinkId id, Level min_level) -> bool;
+
+    // Runtime filtering. The IA_LOG_* macros test the threshold before evaluating any argument, at the cost of one
+    // relaxed atomic load; dispatch() and dispatch_fmt() themselves do not filter. Trace and Debug are still
+    // compiled out entirely in release builds.
+    inline Mut<std::atomic<Level>> g_min_level{Level::Trace};
+
+    static_assert(std::atomic<Level>::is_always_lock_free, "Log levels must be settable from a signal handler");
+
+    inline auto is_enabled(Level level) -> bool
+    {
+      return level >= g_min_level.load(std::memory_order_relaxed);
+    }
+
+    auto set_level(Level level) -> void;
+    auto get_level() -> Level;
+
+    // A named subsystem with its own threshold, declared at namespace scope with IA_LOG_CATEGORY(name) and
+    // logged to with the IA_LOG_*_CAT macros. Until set_level() is called on it, it follows the global threshold.
+    class Category
+    {
+  public:
+      explicit Category(const char *name);
+
+      Category(const Category &) = delete;
+      Category &operator=(const Category &) = delete;
+
+      auto set_level(Level level) -> void;
+      // Back to following the global threshold
+      auto reset_level() -> void;
+      [[nodiscard]] auto get_level() const -> Option<Level>;
+
+      [[nodiscard]] auto get_name() const -> StringView;
+      [[nodiscard]] auto get_next() const -> Category *;
+
+      [[nodiscard]] auto is_enabled(Level level) const -> bool
+      {
+        const u8 threshold = m_level.load(std::memory_order_relaxed);
+        if (threshold == LEVEL_INHERIT)
+        {
+          return logger::is_enabled(level);
+        }
+        return static_cast<u8>(level) >= threshold;
+      }
+
+  private:
+      static constexpr const u8 LEVEL_INHERIT = 0xFF;
+
+      Mut<const char *> m_name{};
+      Mut<std::atomic<u8>> m_level{LEVEL_INHERIT};
+      // Every category registers itself on construction, this links the registry
+      Mut<Category *> m_next{};
+    };
+
+    auto find_category(StringView name) -> Category *;
+    // Head of the list of every category constructed so far, follow it with Category::get_next()
+    auto get_first_category() -> Category *;
+
+    // Applies a comma-separated list of `level` (global threshold) and `category=level` entries, e.g.
+    // "warn,net=debug,shm=trace". `category=default` makes a category follow the global threshold again.
+    // Levels are trace, debug, info, warn, error and fatal. Nothing is applied unless the whole spec is valid.
+    auto configure(StringView spec) -> Result<void>;
+
+    // configure() with the value of an environment variable, a no-op if it is not set
+    auto configure_from_env(Ref<String> name = "IA_LOG_LEVEL") -> Result<void>;
+
+    // Installs a handler for `signal_number` (e.g. SIGUSR1) that flips the global threshold to Trace, and back
+    // to the previous threshold on the next delivery, so a live process can be made verbose without a restart.
+    auto install_verbosity_signal(const i32 signal_number) -> Result<void>;
+
+    // Where a record was logged from. `file` is a basename and must have static storage (the async worker reads it
+    // after dispatch() returns).
+    struct Site
+    {
+      Mut<StringView> file{};
+      Mut<u32> line{};
+    };
+
+    constexpr auto get_basename(StringView path) -> StringView
+    {
+      const usize separator = path.find_last_of("/\\");
+      return separator == StringView::npos ? path : path.substr(separator + 1);
+    }
+
+    // The default argument is evaluated at the caller and consteval forces the basename to be computed by the
+    // compiler, so the IA_LOG_* macros pass a constant Site
+    consteval auto make_site(std::source_location loc = std::source_location::current()) -> Site
+    {
+      return Site{get_basename(loc.file_name()), loc.line()};
+    }
+
+    auto dispatch(Level level, StringView message, Ref<Site> site) -> void;
     auto dispatch(Level level, StringView message, Ref<std::source_location> loc = std::source_location::current())
         -> void;
 
+    // Asynchronous mode. Once started, dispatch() only copies the record into a lock-free SPSC buffer owned by the
+    // calling thread (allocated on its first log), and a background thread drains every buffer into the active
+    // Handler, merging them by timestamp. The handler is then only ever called from that background thread.
+    enum class OverflowPolicy : u8
+    {
+      // The record is discarded and counted, see get_dropped_count()
+      Drop = 0,
+      // The caller yields until the background thread makes room
+      Block
+    };
+
+    struct AsyncOptions
+    {
+      // Ring bytes per logging thread. A record takes its message plus a small header; messages longer than
+      // half the buffer are truncated.
+      Mut<u32> buffer_size = 64 * 1024;
+      Mut<OverflowPolicy> overflow_policy = OverflowPolicy::Drop;
+      // How long the background thread sleeps once every buffer is empty
+      Mut<u32> poll_interval_ms = 1;
+    };
+
+    auto start_async(Ref<AsyncOptions> options = {}) -> Result<void>;
+
+    // Blocks until every record dispatched (by any thread) before the call has been handed to the handler.
+    // No-op in synchronous mode. Must not be called from a Handler.
+    auto flush() -> void;
+
+    // Flushes, joins the background thread and returns to synchronous dispatch. Records other threads are
+    // halfway through writing are waited for and still reach the Handler, later calls are dispatched synchronously.
+    auto stop_async() -> void;
+
+    auto is_async() -> bool;
+
+    // Records discarded under OverflowPolicy::Drop (or while a blocked caller saw stop_async()), since startup
+    auto get_dropped_count() -> u64;
+
+    // Deferred formatting. IA_LOG_*_DEFERRED does not format on the calling thread: it captures a static
+    // per-callsite descriptor plus the raw arguments into a binary record, which is formatted later by the async
+    // worker (immediately in synchronous mode) or handed as-is to a RecordSink, e.g. to be decoded offline from a
+    // BinaryLogWriter file. Arguments must be bools, chars, integers, floating-point values, pointers or strings;
+    // strings are copied (up to MAX_DEFERRED_STRING_SIZE bytes each) and come back as StringView.
+    enum class ArgType : u8
+    {
+      Bool = 0,
+      Char,
+      Int,
+      UInt,
+      Float,
+      Double,
+      String,
+      Pointer
+    };
+
+    static constexpr const usize MAX_DEFERRED_STRING_SIZE = 1024;
+
+    struct CallSiteInfo
+    {
+      Mut<Level> level{};
+      Mut<StringView> format{};
+      Mut<std::source_location> location{};
+    };
+
+    // Registered once per call site, lives until exit
+    struct CallSite
+    {
+      // Process-local, 1-based in registration order
+      Mut<u32> id{};
+      Mut<Level> level{};
+      Mut<StringView> format{};
+      Mut<StringView> file{};
+      Mut<u32> line{};
+      Mut<Span<const ArgType>> arg_types{};
+    };
+
+    // Receives deferred records instead of the Handler: `args` is the encoded argument block, valid only for the
+    // duration of the call. Called from the async worker, or from the logging thread in synchronous mode.
+    using RecordSink = void (*)(void *user_data, Ref<CallSite> call_site, u64 timestamp_ns, Span<const u8> args);
+
+    // nullptr goes back to formatting deferred records and passing them to the Handler
+    auto set_record_sink(RecordSink sink, void *user_data) -> void;
+
+    auto register_call_site(Ref<CallSiteInfo> info, Span<const ArgType> arg_types) -> Ref<CallSite>;
+    auto get_call_site(const u32 id) -> const CallSite *;
+
+    // Renders an encoded argument block with a std::format string. Only needs the descriptor, not the types the
+    // call site was compiled with, so it works just as well on records read back from a file.
+    auto format_encoded(StringView format, Span<const ArgType> arg_types, Span<const u8> args) -> Result<String>;
+
+    // Room for `args_size` bytes of encoded arguments (nullopt if the record was dropped), published by
+    // end_deferred(). Used by dispatch_deferred().
+    auto begin_deferred(Ref<CallSite> call_site, const usize args_size) -> Option<Span<u8>>;
+    auto end_deferred(Ref<CallSite> call_site) -> void;
+
+    namespace deferred
+    {
+      template<typename T> consteval auto get_arg_type() -> ArgType
+      {
+        using Type = std::remove_cvref_t<T>;
+
+        if constexpr (std::is_same_v<Type, bool>)
+          return ArgType::Bool;
+        else if constexpr (std::is_same_v<Type, char>)
+          return ArgType::Char;
+        else if constexpr (std::is_convertible_v<Ref<T>, StringView>)
+          return ArgType::String;
+        else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>)
+          return ArgType::Int;
+        else if constexpr (std::is_integral_v<Type>)
+          return ArgType::UInt;
+        else if constexpr (std::is_same_v<Type, float>)
+          return ArgType::Float;
+        else if constexpr (std::is_floating_point_v<Type>)
+          return ArgType::Double;
+        else if constexpr (std::is_pointer_v<Type> || std::is_null_pointer_v<Type>)
+          return ArgType::Pointer;
+        else
+          static_assert(sizeof(Type) == 0, "Unsupported deferred log argument type");
+      }
+
+      template<typename T> inline auto get_encoded_size(Ref<T> value) -> usize
+      {
+        if constexpr (get_arg_type<T>() == ArgType::String)
+          return sizeof(u32) + std::min(StringView(value).size(), MAX_DEFERRED_STRING_SIZE);
+        else if constexpr (get_arg_type<T>() == ArgType::Bool || get_arg_type<T>() == ArgType::Char)
+          return sizeof(u8);
+        else if constexpr (get_arg_type<T>() == ArgType::Float)
+          return sizeof(f32);
+        else
+          return sizeof(u64);
+      }
+
+      inline auto write_bytes(Span<u8> out, MutRef<usize> offset, const void *data, const usize size) -> void
+      {
+        std::memcpy(out.data() + offset, data, size);
+        offset += size;
+      }
+
+      template<typename T> inline auto encode_arg(Span<u8> out, MutRef<usize> offset, Ref<T> value) -> void
+      {
+        constexpr ArgType TYPE = get_arg_type<T>();
+
+        if constexpr (TYPE == ArgType::String)
+        {
+          const StringView text = StringView(value).substr(0, MAX_DEFERRED_STRING_SIZE);
+          const u32 size = static_cast<u32>(text.size());
+          write_bytes(out, offset, &size, sizeof(size));
+          write_bytes(out, offset, text.data(), size);
+        }
+        else if constexpr (TYPE == ArgType::Bool || TYPE == ArgType::Char)
+        {
+          const u8 byte = static_cast<u8>(value);
+          write_bytes(out, offset, &byte, sizeof(byte));
+        }
+        else if constexpr (TYPE == ArgType::Int)
+        {
+          const i64 wide = static_cast<i64>(value);
+          write_bytes(out, offset, &wide, sizeof(wide));
+        }
+        else if constexpr (TYPE == ArgType::UInt)
+        {
+          const u64 wide = static_cast<u64>(value);
+          write_bytes(out, offset, &wide, sizeof(wide));
+        }
+        else if constexpr (TYPE == ArgType::Float)
+        {
+          const f32 narrow = value;
+          write_bytes(out, offset, &narrow, sizeof(narrow));
+        }
+        else if constexpr (TYPE == ArgType::Double)
+        {
+          const f64 wide = static_cast<f64>(value);
+          write_bytes(out, offset, &wide, sizeof(wide));
+        }
+        else
+        {
+          const u64 address = reinterpret_cast<u64>(static_cast<const void *>(value));
+          write_bytes(out, offset, &address, sizeof(address));
+        }
+      }
+    } // namespace deferred
+
+    // `SiteFn` is a captureless lambda returning the CallSiteInfo, so every call site gets its own instantiation
+    // and with it its own static CallSite
+    template<typename SiteFn, typename... Args> void dispatch_deferred(SiteFn, Ref<Args>... args)
+    {
+      static constexpr CallSiteInfo INFO = SiteFn{}();
+      static constexpr std::array<ArgType, sizeof...(Args)> ARG_TYPES{deferred::get_arg_type<Args>()...};
+      [[maybe_unused]] static constexpr std::format_string<Ref<Args>...> FORMAT_CHECK{INFO.format};
+
+      static Ref<CallSite> s_call_site = register_call_site(INFO, ARG_TYPES);
+
+      const usize args_size = (usize{0} + ... + deferred::get_encoded_size(args));
+
+      const auto out = begin_deferred(s_call_site, args_size);
+      if (!out)
+      {
+        return;
+      }
+
+      [[maybe_unused]] Mut<usize> offset = 0;
+      (deferred::encode_arg(*out, offset, args), ...);
+
+      end_deferred(s_call_site);
+    }
+
+    // Messages up to this size are formatted on the stack
+    static constexpr const usize INLINE_FORMAT_SIZE = 256;
+
+    // Thread-local buffer for longer messages, which keeps its capacity between calls. Returns nullptr while the
+    // calling thread already holds it (a Handler that logs), release_format_buffer() hands it back.
+    auto acquire_format_buffer() -> String *;
+    auto release_format_buffer() -> void;
+
+    // Holds the thread's format buffer (if it was free) until the end of the scope, even if a formatter or a
+    // Handler throws: a buffer left marked in use would send every later long message to std::format
+    class FormatBufferLease
+    {
+  public:
+      FormatBufferLease() : m_buffer(acquire_format_buffer())
+      {
+      }
+
+      ~FormatBufferLease()
+      {
+        if (m_buffer != nullptr)
+        {
+          release_format_buffer();
+        }
+      }
+
+      FormatBufferLease(const FormatBufferLease &) = delete;
+      FormatBufferLease &operator=(const FormatBufferLease &) = delete;
+
+      [[nodiscard]] auto get() const -> String *
+      {
+        return m_buffer;
+      }
+
+  private:
+      Mut<String *> m_buffer{};
+    };
+
+    // Allocation-free once the thread's format buffer has grown to fit its longest message
+    template<typename... Args>
+    void dispatch_fmt(Level level, Ref<Site> site, std::format_string<Args...> fmt, ForwardRef<Args>... args)
+    {
+      // Formatting only reads the arguments, so forwarding them to both passes is safe
+      Mut<std::array<char, INLINE_FORMAT_SIZE>> inline_buffer;
+      const auto result =
+          std::format_to_n(inline_buffer.data(), inline_buffer.size(), fmt, std::forward<Args>(args)...);
+      if (static_cast<usize>(result.size) <= inline_buffer.size())
+      {
+        dispatch(level, StringView(inline_buffer.data(), static_cast<usize>(result.size)), site);
+        return;
+      }
+
+      const FormatBufferLease lease;
+      String *buffer = lease.get();
+      if (buffer == nullptr)
+      {
+        dispatch(level, std::format(fmt, std::forward<Args>(args)...), site);
+        return;
+      }
+
+      buffer->clear();
+      std::format_to(std::back_inserter(*buffer), fmt, std::forward<Args>(args)...);
+      dispatch(level, *buffer, site);
+    }
+
     template<typename... Args>
     void dispatch_fmt(Level level, Ref<std::source_location> loc, std::format_string<Args...> fmt,
                       ForwardRef<Args>... args)
     {
-      auto msg = std::format(fmt, std::forward<Args>(args)...);
-      dispatch(level, msg, loc);
+      dispatch_fmt(level, Site{get_basename(loc.file_name()), loc.line()}, fmt, std::forward<Args>(args)...);
+    }
+
+    // Per-call-site limiters behind IA_LOG_*_ONCE, IA_LOG_*_EVERY_N and IA_LOG_*_RATE. Each macro expansion owns a
+    // constant-initialized static instance. try_acquire() returns nullopt to suppress the call, otherwise the number
+    // of calls suppressed since the last one that got through.
+    class OnceLimiter
+    {
+  public:
+      auto try_acquire() -> Option<u64>
+      {
+        if (m_done.load(std::memory_order_relaxed) || m_done.exchange(true, std::memory_order_relaxed))
+        {
+          return std::nullopt;
+        }
+        return 0;
+      }
+
+  private:
+      Mut<std::atomic<bool>> m_done{false};
+    };
+
+    // Lets the 1st, (n+1)th, (2n+1)th... call through. The suppressed count is always n - 1, so it is not reported.
+    class EveryNLimiter
+    {
+  public:
+      auto try_acquire(const u64 n) -> Option<u64>
+      {
+        const u64 count = m_count.fetch_add(1, std::memory_order_relaxed);
+        if (n > 1 && count % n != 0)
+        {
+          return std::nullopt;
+        }
+        return 0;
+      }
+
+  private:
+      Mut<std::atomic<u64>> m_count{0};
+    };
+
+    // Lets at most `per_second` calls through per one-second window. Once a window is used up, calls are rejected
+    // on a single relaxed load of its end time (plus the increment that counts them) until the next one opens.
+    class RateLimiter
+    {
+  public:
+      static constexpr const u64 WINDOW_NS = 1'000'000'000;
+
+      auto try_acquire(const u64 per_second) -> Option<u64>
+      {
+        return try_acquire(per_second, static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                             std::chrono::steady_clock::now().time_since_epoch())
+                                                             .count()));
+      }
+
+      auto try_acquire(const u64 per_second, const u64 now_ns) -> Option<u64>
+      {
+        if (now_ns < m_blocked_until_ns.load(std::memory_order_relaxed))
+        {
+          m_suppressed.fetch_add(1, std::memory_order_relaxed);
+          return std::nullopt;
+        }
+
+        Mut<u64> window_start = m_window_start_ns.load(std::memory_order_relaxed);
+        if (now_ns >= window_start + WINDOW_NS &&
+            m_window_start_ns.compare_exchange_strong(window_start, now_ns, std::memory_order_relaxed))
+        {
+          window_start = now_ns;
+          m_window_count.store(0, std::memory_order_relaxed);
+        }
+
+        if (m_window_count.fetch_add(1, std::memory_order_relaxed) >= per_second)
+        {
+          m_blocked_until_ns.store(window_start + WINDOW_NS, std::memory_order_relaxed);
+          m_suppressed.fetch_add(1, std::memory_order_relaxed);
+          return std::nullopt;
+        }
+
+        return m_suppressed.exchange(0, std::memory_order_relaxed);
+      }
+
+  private:
+      Mut<std::atomic<u64>> m_blocked_until_ns{0};
+      Mut<std::atomic<u64>> m_window_start_ns{0};
+      Mut<std::atomic<u64>> m_window_count{0};
+      Mut<std::atomic<u64>> m_suppressed{0};
+    };
+
+    // Reports the calls a limiter held back, then logs the one it let through
+    template<typename... Args>
+    void dispatch_limited(Level level, Ref<Site> site, const u64 suppressed, std::format_string<Args...> fmt,
+                          ForwardRef<Args>... args)
+    {
+      if (suppressed != 0)
+      {
+        dispatch_fmt(level, site, "suppressed {} messages", suppressed);
+      }
+      dispatch_fmt(level, site, fmt, std::forward<Args>(args)...);
     }
   } // namespace logger
 } // namespace ia
 
-#define IA_LOG_TRACE(...)                                                                                              \
-  ::ia::logger::dispatch_fmt(::ia::logger::Level::Trace, std::source_location::current(), __VA_ARGS__)
-#define IA_LOG_DEBUG(...)                                                                                              \
-  ::ia::logger::dispatch_fmt(::ia::logger::Level::Debug, std::source_location::current(), __VA_ARGS__)
-#define IA_LOG_INFO(...)                                                                                               \
-  ::ia::logger::dispatch_fmt(::ia::logger::Level::Info, std::source_location::current(), __VA_ARGS__)
-#define IA_LOG_WARN(...)                                                                                               \
-  ::ia::logger::dispatch_fmt(::ia::logger::Level::Warn, std::source_location::current(), __VA_ARGS__)
-#define IA_LOG_ERROR(...)                                                                                              \
-  ::ia::logger::dispatch_fmt(::ia::logger::Level::Error, std::source_location::current(), __VA_ARGS__)
-#define IA_LOG_FATAL(...)                                                                                              \
-  ::ia::logger::dispatch_fmt(::ia::logger::Level::Fatal, std::source_location::current(), __VA_ARGS__)
+#define IA_LOG_AT(level, ...)                                                                                          \
+  (::ia::logger::is_enabled(level)                                                                                     \
+       ? ::ia::logger::dispatch_fmt(level, ::ia::logger::make_site(), __VA_ARGS__)                                     \
+       : void())
+
+#define IA_LOG_TRACE(...) IA_LOG_AT(::ia::logger::Level::Trace, __VA_ARGS__)
+#define IA_LOG_DEBUG(...) IA_LOG_AT(::ia::logger::Level::Debug, __VA_ARGS__)
+#define IA_LOG_INFO(...) IA_LOG_AT(::ia::logger::Level::Info, __VA_ARGS__)
+#define IA_LOG_WARN(...) IA_LOG_AT(::ia::logger::Level::Warn, __VA_ARGS__)
+#define IA_LOG_ERROR(...) IA_LOG_AT(::ia::logger::Level::Error, __VA_ARGS__)
+#define IA_LOG_FATAL(...) IA_LOG_AT(::ia::logger::Level::Fatal, __VA_ARGS__)
+
+#define IA_LOG_CATEGORY(name) inline ::ia::logger::Category name{#name}
+
+#define IA_LOG_CAT_AT(category, level, ...)                                                                            \
+  ((category).is_enabled(level) ? ::ia::logger::dispatch_fmt(level, ::ia::logger::make_site(), __VA_ARGS__)           \
+                                : void())
+
+#define IA_LOG_TRACE_CAT(category, ...) IA_LOG_CAT_AT(category, ::ia::logger::Level::Trace, __VA_ARGS__)
+#define IA_LOG_DEBUG_CAT(category, ...) IA_LOG_CAT_AT(category, ::ia::logger::Level::Debug, __VA_ARGS__)
+#define IA_LOG_INFO_CAT(category, ...) IA_LOG_CAT_AT(category, ::ia::logger::Level::Info, __VA_ARGS__)
+#define IA_LOG_WARN_CAT(category, ...) IA_LOG_CAT_AT(category, ::ia::logger::Level::Warn, __VA_ARGS__)
+#define IA_LOG_ERROR_CAT(category, ...) IA_LOG_CAT_AT(category, ::ia::logger::Level::Error, __VA_ARGS__)
+#define IA_LOG_FATAL_CAT(category, ...) IA_LOG_CAT_AT(category, ::ia::logger::Level::Fatal, __VA_ARGS__)
+
+#define IA_LOG_DEFERRED(level, fmt, ...)                                                                               \
+  (::ia::logger::is_enabled(level)                                                                                     \
+       ? ::ia::logger::dispatch_deferred(                                                                              \
+             [] { return ::ia::logger::CallSiteInfo{level, fmt, std::source_location::current()}; }                    \
+                 __VA_OPT__(, ) __VA_ARGS__)                                                                           \
+       : void())
+
+#define IA_LOG_TRACE_DEFERRED(fmt, ...) IA_LOG_DEFERRED(::ia::logger::Level::Trace, fmt __VA_OPT__(, ) __VA_ARGS__)
+#define IA_LOG_DEBUG_DEFERRED(fmt, ...) IA_LOG_DEFERRED(::ia::logger::Level::Debug, fmt __VA_OPT__(, ) __VA_ARGS__)
+#define IA_LOG_INFO_DEFERRED(fmt, ...) IA_LOG_DEFERRED(::ia::logger::Level::Info, fmt __VA_OPT__(, ) __VA_ARGS__)
+#define IA_LOG_WARN_DEFERRED(fmt, ...) IA_LOG_DEFERRED(::ia::logger::Level::Warn, fmt __VA_OPT__(, ) __VA_ARGS__)
+#define IA_LOG_ERROR_DEFERRED(fmt, ...) IA_LOG_DEFERRED(::ia::logger::Level::Error, fmt __VA_OPT__(, ) __VA_ARGS__)
+#define IA_LOG_FATAL_DEFERRED(fmt, ...) IA_LOG_DEFERRED(::ia::logger::Level::Fatal, fmt __VA_OPT__(, ) __VA_ARGS__)
+
+// `acquire_args` is the parenthesized argument list of the limiter's try_acquire(). The level and the limiter are
+// checked before any log argument is evaluated.
+#define IA_LOG_LIMITED_AT(limiter, acquire_args, level, ...)                                                           \
+  [&] {                                                                                                                \
+    static constinit ::ia::logger::limiter s_limiter{};                                                                \
+    if (::ia::logger::is_enabled(level))                                                                               \
+    {                                                                                                                  \
+      if (const auto suppressed = s_limiter.try_acquire acquire_args)                                                  \
+      {                                                                                                                \
+        ::ia::logger::dispatch_limited(level, ::ia::logger::make_site(), *suppressed, __VA_ARGS__);                    \
+      }                                                                                                                \
+    }                                                                                                                  \
+  }()
+
+#define IA_LOG_TRACE_ONCE(...) IA_LOG_LIMITED_AT(OnceLimiter, (), ::ia::logger::Level::Trace, __VA_ARGS__)
+#define IA_LOG_DEBUG_ONCE(...) IA_LOG_LIMITED_AT(OnceLimiter, (), ::ia::logger::Level::Debug, __VA_ARGS__)
+#define IA_LOG_INFO_ONCE(...) IA_LOG_LIMITED_AT(OnceLimiter, (), ::ia::logger::Level::Info, __VA_ARGS__)
+#define IA_LOG_WARN_ONCE(...) IA_LOG_LIMITED_AT(OnceLimiter, (), ::ia::logger::Level::Warn, __VA_ARGS__)
+#define IA_LOG_ERROR_ONCE(...) IA_LOG_LIMITED_AT(OnceLimiter, (), ::ia::logger::Level::Error, __VA_ARGS__)
+#define IA_LOG_FATAL_ONCE(...) IA_LOG_LIMITED_AT(OnceLimiter, (), ::ia::logger::Level::Fatal, __VA_ARGS__)
+
+#define IA_LOG_TRACE_EVERY_N(n, ...) IA_LOG_LIMITED_AT(EveryNLimiter, (n), ::ia::logger::Level::Trace, __VA_ARGS__)
+#define IA_LOG_DEBUG_EVERY_N(n, ...) IA_LOG_LIMITED_AT(EveryNLimiter, (n), ::ia::logger::Level::Debug, __VA_ARGS__)
+#define IA_LOG_INFO_EVERY_N(n, ...) IA_LOG_LIMITED_AT(EveryNLimiter, (n), ::ia::logger::Level::Info, __VA_ARGS__)
+#define IA_LOG_WARN_EVERY_N(n, ...) IA_LOG_LIMITED_AT(EveryNLimiter, (n), ::ia::logger::Level::Warn, __VA_ARGS__)
+#define IA_LOG_ERROR_EVERY_N(n, ...) IA_LOG_LIMITED_AT(EveryNLimiter, (n), ::ia::logger::Level::Error, __VA_ARGS__)
+#define IA_LOG_FATAL_EVERY_N(n, ...) IA_LOG_LIMITED_AT(EveryNLimiter, (n), ::ia::logger::Level::Fatal, __VA_ARGS__)
+
+#define IA_LOG_TRACE_RATE(per_sec, ...)                                                                                \
+  IA_LOG_LIMITED_AT(RateLimiter, (per_sec), ::ia::logger::Level::Trace, __VA_ARGS__)
+#define IA_LOG_DEBUG_RATE(per_sec, ...)                                                                                \
+  IA_LOG_LIMITED_AT(RateLimiter, (per_sec), ::ia::logger::Level::Debug, __VA_ARGS__)
+#define IA_LOG_INFO_RATE(per_sec, ...) IA_LOG_LIMITED_AT(RateLimiter, (per_sec), ::ia::logger::Level::Info, __VA_ARGS__)
+#define IA_LOG_WARN_RATE(per_sec, ...) IA_LOG_LIMITED_AT(RateLimiter, (per_sec), ::ia::logger::Level::Warn, __VA_ARGS__)
+#define IA_LOG_ERROR_RATE(per_sec, ...)                                                                                \
+  IA_LOG_LIMITED_AT(RateLimiter, (per_sec), ::ia::logger::Level::Error, __VA_ARGS__)
+#define IA_LOG_FATAL_RATE(per_sec, ...)                                                                                \
+  IA_LOG_LIMITED_AT(RateLimiter, (per_sec), ::ia::logger::Level::Fatal, __VA_ARGS__)
 
 #if !__IA_DEBUG
 #  undef IA_LOG_TRACE
 #  undef IA_LOG_DEBUG
+#  undef IA_LOG_TRACE_DEFERRED
+#  undef IA_LOG_DEBUG_DEFERRED
+#  undef IA_LOG_TRACE_CAT
+#  undef IA_LOG_DEBUG_CAT
+#  undef IA_LOG_TRACE_ONCE
+#  undef IA_LOG_DEBUG_ONCE
+#  undef IA_LOG_TRACE_EVERY_N
+#  undef IA_LOG_DEBUG_EVERY_N
+#  undef IA_LOG_TRACE_RATE
+#  undef IA_LOG_DEBUG_RATE
 #  define IA_LOG_TRACE(...) ((void) 0)
 #  define IA_LOG_DEBUG(...) ((void) 0)
+#  define IA_LOG_TRACE_DEFERRED(...) ((void) 0)
+#  define IA_LOG_DEBUG_DEFERRED(...) ((void) 0)
+#  define IA_LOG_TRACE_CAT(...) ((void) 0)
+#  define IA_LOG_DEBUG_CAT(...) ((void) 0)
+#  define IA_LOG_TRACE_ONCE(...) ((void) 0)
+#  define IA_LOG_DEBUG_ONCE(...) ((void) 0)
+#  define IA_LOG_TRACE_EVERY_N(...) ((void) 0)
+#  define IA_LOG_DEBUG_EVERY_N(...) ((void) 0)
+#  define IA_LOG_TRACE_RATE(...) ((void) 0)
+#  define IA_LOG_DEBUG_RATE(...) ((void) 0)
 #endif
\ No newline at end of file
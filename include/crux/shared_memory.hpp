@@ -0,0 +1,117 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <crux/adt/ring_buffer.hpp>
+#include <crux/unique_handle.hpp>
+
+namespace ia
+{
+  namespace shm
+  {
+#if IA_PLATFORM_WINDOWS
+    using NativeHandle = void *;
+    constexpr const NativeHandle INVALID_NATIVE_HANDLE = nullptr;
+#else
+    using NativeHandle = i32;
+    constexpr const NativeHandle INVALID_NATIVE_HANDLE = -1;
+#endif
+
+    auto close_native_handle(NativeHandle handle) -> void;
+
+    using UniqueNativeHandle = UniqueHandle<NativeHandle, INVALID_NATIVE_HANDLE, close_native_handle>;
+  } // namespace shm
+
+  struct SharedMemoryOptions
+  {
+    // Prefault every page at map time (MAP_POPULATE), so first-touch page faults don't land on the hot path
+    Mut<bool> populate = false;
+
+    // Back the segment with huge pages. On Linux the segment is created on the hugetlbfs mount at
+    // /dev/hugepages instead of /dev/shm.
+    Mut<bool> huge_pages = false;
+
+    // Pin the mapping in RAM (mlock/VirtualLock)
+    Mut<bool> lock = false;
+
+    // Map the data pages twice, back to back, so ring buffer records never wrap (Linux only).
+    // The data region is rounded up to whole pages and the ControlBlock moves into the header page.
+    // Segments created mirrored can still be opened without the mirror.
+    Mut<bool> mirrored = false;
+  };
+
+  // Named shared memory segment (shm_open/mmap, or a named file mapping on Windows).
+  //
+  // Every segment starts with a SegmentHeader carrying a magic and a layout version, which open()
+  // validates before handing out the data region behind it.
+  class SharedMemory
+  {
+public:
+    static constexpr const u32 SEGMENT_MAGIC = 0x58524349; // "ICRX"
+    // Bumped on every change to SegmentHeader or to the ring ControlBlock behind it
+    static constexpr const u32 SEGMENT_VERSION = 3;
+
+    static constexpr const u32 SEGMENT_FLAG_MIRRORED = 1 << 0;
+
+    struct alignas(64) SegmentHeader
+    {
+      Mut<std::atomic<u32>> magic{0};
+      Mut<u32> version{0};
+      Mut<u64> data_size{0};
+      Mut<u64> data_offset{0};
+      Mut<u32> flags{0};
+    };
+
+    using Options = SharedMemoryOptions;
+
+public:
+    SharedMemory() = default;
+    ~SharedMemory();
+
+    SharedMemory(const SharedMemory &) = delete;
+    SharedMemory &operator=(const SharedMemory &) = delete;
+
+    SharedMemory(SharedMemory &&other);
+    SharedMemory &operator=(SharedMemory &&other);
+
+    // Creates a new segment with `data_size` usable bytes. Fails if `name` already exists.
+    static auto create(Ref<String> name, const usize data_size, Ref<Options> options = {}) -> Result<SharedMemory>;
+
+    // Opens a segment created by another process
+    static auto open(Ref<String> name, Ref<Options> options = {}) -> Result<SharedMemory>;
+
+    // Removes the name; existing mappings stay valid until they are closed. No-op on Windows.
+    static auto unlink(Ref<String> name, Ref<Options> options = {}) -> Result<void>;
+
+    // Lays a RingBufferView over the data region. The creator of the segment should pass is_owner = true.
+    // On a mirrored mapping this is a RingBufferView::create_mirrored() view.
+    auto create_ring_buffer(const bool is_owner, const u32 flags = 0) -> Result<RingBufferView>;
+
+    auto get_data() -> Span<u8>;
+    auto get_header() -> SegmentHeader *;
+
+    [[nodiscard]] auto is_valid() const -> bool;
+
+private:
+    Mut<shm::UniqueNativeHandle> m_handle{};
+    Mut<u8 *> m_base{};
+    Mut<usize> m_mapped_size{};
+    Mut<bool> m_mirrored{};
+
+private:
+    auto unmap() -> void;
+  };
+} // namespace ia
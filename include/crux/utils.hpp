@@ -18,6 +18,7 @@
 #include <crux/crux.hpp>
 
 #include <algorithm>
+#include <atomic>
 
 namespace ia
 {
@@ -31,6 +32,10 @@ namespace ia
 
     auto crc32(Ref<Span<const u8>> data) -> u32;
 
+    // memcpy with streaming stores that bypass the cache (AVX2), for large copies the caller won't read back.
+    // Falls back to memcpy when AVX2 is unavailable.
+    auto copy_non_temporal(void *dst, const void *src, const usize size) -> void;
+
     auto get_unix_time() -> u64;
 
     auto get_random() -> f32;
@@ -39,6 +44,15 @@ namespace ia
 
     auto sleep(const u64 milliseconds) -> void;
 
+    // Hint to the CPU that the caller is busy-waiting
+    auto spin_pause() -> void;
+
+    // Blocks while `word` holds `expected`, for at most timeout_us. May return spuriously.
+    // On Linux this is a process-shared futex, so `word` may live in shared memory.
+    // Other platforms fall back to a short sleep.
+    auto wait_on_address(MutRef<std::atomic<u32>> word, const u32 expected, const u64 timeout_us) -> void;
+    auto wake_by_address(MutRef<std::atomic<u32>> word) -> void;
+
     auto binary_to_hex_string(const Span<const u8> data) -> String;
 
     auto hex_string_to_binary(const StringView hex) -> Result<Vec<u8>>;
@@ -0,0 +1,231 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <crux/binary_log.hpp>
+
+#include <cstring>
+#include <utility>
+
+namespace ia
+{
+  auto BinaryLogWriter::create(Ref<String> path_prefix, Ref<JournalWriterOptions> options) -> Result<BinaryLogWriter>
+  {
+    auto journal = JournalWriter::create(path_prefix, options);
+    if (!journal)
+    {
+      return fail("{}", journal.error());
+    }
+
+    Mut<BinaryLogWriter> writer;
+    writer.m_journal = std::move(*journal);
+    return writer;
+  }
+
+  auto BinaryLogWriter::append_call_site(Ref<logger::CallSite> call_site, const u32 file_id,
+                                         const u64 timestamp_ns) -> Result<void>
+  {
+    // Stored truncated, they would make the reader decode garbage
+    if (call_site.file.size() > std::numeric_limits<u16>::max() ||
+        call_site.format.size() > std::numeric_limits<u16>::max())
+    {
+      return fail("Call site {} has a file name or format string longer than {} bytes", call_site.id,
+                  std::numeric_limits<u16>::max());
+    }
+
+    const binary_log::CallSiteHeader header{
+        file_id,
+        call_site.line,
+        static_cast<u16>(call_site.file.size()),
+        static_cast<u16>(call_site.format.size()),
+        static_cast<u8>(call_site.level),
+        static_cast<u8>(call_site.arg_types.size()),
+        0,
+    };
+
+    m_scratch.resize(sizeof(header) + header.arg_count + header.file_size + header.format_size);
+
+    Mut<u8 *> out = m_scratch.data();
+    std::memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+    std::memcpy(out, call_site.arg_types.data(), header.arg_count);
+    out += header.arg_count;
+    std::memcpy(out, call_site.file.data(), header.file_size);
+    out += header.file_size;
+    std::memcpy(out, call_site.format.data(), header.format_size);
+
+    return m_journal.append(binary_log::PACKET_ID_CALL_SITE, Span<const u8>(m_scratch), timestamp_ns);
+  }
+
+  auto BinaryLogWriter::append(Ref<logger::CallSite> call_site, const u64 timestamp_ns, Span<const u8> args)
+      -> Result<void>
+  {
+    if (call_site.arg_types.size() > std::numeric_limits<u8>::max())
+    {
+      return fail("Call site {} has too many arguments", call_site.id);
+    }
+
+    if (call_site.id >= m_file_ids.size())
+    {
+      m_file_ids.resize(call_site.id + 1, 0);
+    }
+
+    if (m_file_ids[call_site.id] == 0)
+    {
+      auto written = append_call_site(call_site, m_file_id_count + 1, timestamp_ns);
+      if (!written)
+      {
+        return written;
+      }
+      m_file_ids[call_site.id] = ++m_file_id_count;
+    }
+
+    const u32 file_id = m_file_ids[call_site.id];
+    m_scratch.resize(sizeof(u32) + args.size());
+    std::memcpy(m_scratch.data(), &file_id, sizeof(u32));
+    std::memcpy(m_scratch.data() + sizeof(u32), args.data(), args.size());
+
+    return m_journal.append(binary_log::PACKET_ID_RECORD, Span<const u8>(m_scratch), timestamp_ns);
+  }
+
+  auto BinaryLogWriter::sink(void *user_data, Ref<logger::CallSite> call_site, u64 timestamp_ns,
+                             Span<const u8> args) -> void
+  {
+    auto writer = reinterpret_cast<BinaryLogWriter *>(user_data);
+    if (!writer->append(call_site, timestamp_ns, args))
+    {
+      writer->m_failed_count++;
+    }
+  }
+
+  auto BinaryLogWriter::close() -> void
+  {
+    m_journal.close();
+  }
+
+  auto BinaryLogWriter::get_failed_count() const -> u64
+  {
+    return m_failed_count;
+  }
+
+  auto BinaryLogReader::open(Ref<String> path_prefix) -> Result<BinaryLogReader>
+  {
+    auto journal = JournalReader::open(path_prefix);
+    if (!journal)
+    {
+      return fail("{}", journal.error());
+    }
+
+    Mut<BinaryLogReader> reader;
+    reader.m_journal = std::move(*journal);
+
+    // Call site definitions always precede their first record, but load them all up front so decode() can stay
+    // const and records can be read in any order
+    for (Mut<u64> i = 0; i < reader.m_journal.get_record_count(); i++)
+    {
+      const auto entry = reader.m_journal.get_entry(i);
+      if (!entry || entry->id != binary_log::PACKET_ID_CALL_SITE)
+      {
+        continue;
+      }
+
+      Mut<binary_log::CallSiteHeader> header;
+      if (entry->data.size() < sizeof(header))
+      {
+        return fail("Binary log record {} has a truncated call site", i);
+      }
+      std::memcpy(&header, entry->data.data(), sizeof(header));
+
+      if (entry->data.size() != sizeof(header) + header.arg_count + header.file_size + header.format_size)
+      {
+        return fail("Binary log record {} has a malformed call site", i);
+      }
+      // Ids are dense, so a larger one can only come from a damaged file (and would size m_call_sites by it)
+      if (header.id == 0 || header.id > reader.m_journal.get_record_count())
+      {
+        return fail("Binary log record {} defines call site {}", i, header.id);
+      }
+
+      const u8 *data = entry->data.data() + sizeof(header);
+      const auto text = [](const u8 *bytes, const usize size) {
+        return StringView(reinterpret_cast<const char *>(bytes), size);
+      };
+
+      Mut<CallSiteEntry> call_site;
+      call_site.level = static_cast<logger::Level>(header.level);
+      call_site.line = header.line;
+      call_site.arg_types.resize(header.arg_count);
+      std::memcpy(call_site.arg_types.data(), data, header.arg_count);
+      call_site.file = text(data + header.arg_count, header.file_size);
+      call_site.format = text(data + header.arg_count + header.file_size, header.format_size);
+
+      if (header.id >= reader.m_call_sites.size())
+      {
+        reader.m_call_sites.resize(header.id + 1);
+      }
+      reader.m_call_sites[header.id] = std::move(call_site);
+    }
+
+    return reader;
+  }
+
+  auto BinaryLogReader::decode(Ref<JournalReader::Entry> entry, MutRef<Record> out) const -> Result<bool>
+  {
+    if (entry.id != binary_log::PACKET_ID_RECORD)
+    {
+      return false;
+    }
+
+    Mut<u32> call_site_id = 0;
+    if (entry.data.size() < sizeof(call_site_id))
+    {
+      return fail("Truncated record");
+    }
+    std::memcpy(&call_site_id, entry.data.data(), sizeof(call_site_id));
+
+    if (call_site_id >= m_call_sites.size() || !m_call_sites[call_site_id])
+    {
+      return fail("Unknown call site {}", call_site_id);
+    }
+
+    Ref<CallSiteEntry> call_site = *m_call_sites[call_site_id];
+
+    auto message = logger::format_encoded(call_site.format, call_site.arg_types, entry.data.subspan(sizeof(u32)));
+    if (!message)
+    {
+      return fail("{}", message.error());
+    }
+
+    out.timestamp_ns = entry.timestamp_ns;
+    out.level = call_site.level;
+    out.file = call_site.file;
+    out.line = call_site.line;
+    out.message = std::move(*message);
+
+    return true;
+  }
+
+  auto BinaryLogReader::read_all() const -> Result<Vec<Record>>
+  {
+    Mut<Vec<Record>> records;
+
+    auto count = for_each([&](Ref<Record> record) { records.push_back(record); });
+    if (!count)
+    {
+      return fail("{}", count.error());
+    }
+
+    return records;
+  }
+} // namespace ia
@@ -0,0 +1,101 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <crux/doorbell.hpp>
+
+#include <cerrno>
+#include <cstring>
+
+#if IA_PLATFORM_LINUX
+#  include <sys/eventfd.h>
+#  include <unistd.h>
+#endif
+
+namespace ia::doorbell
+{
+  auto close_fd(const i32 fd) -> void
+  {
+#if IA_PLATFORM_LINUX
+    close(fd);
+#else
+    AU_UNUSED(fd);
+#endif
+  }
+} // namespace ia::doorbell
+
+namespace ia
+{
+  auto Doorbell::create() -> Result<Doorbell>
+  {
+#if IA_PLATFORM_LINUX
+    Mut<Doorbell> doorbell;
+    *doorbell.m_fd.ptr() = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (!doorbell.is_valid())
+    {
+      return fail("eventfd failed: {}", std::strerror(errno));
+    }
+    return doorbell;
+#else
+    return fail("Doorbells are only supported on Linux");
+#endif
+  }
+
+  auto Doorbell::adopt(const i32 fd) -> Doorbell
+  {
+    Mut<Doorbell> doorbell;
+    *doorbell.m_fd.ptr() = fd;
+    return doorbell;
+  }
+
+  auto Doorbell::signal() -> void
+  {
+    signal(m_fd);
+  }
+
+  auto Doorbell::signal(const i32 fd) -> void
+  {
+#if IA_PLATFORM_LINUX
+    const u64 one = 1;
+    // Can only fail if the counter would overflow, which still leaves the fd readable
+    (void) write(fd, &one, sizeof(one));
+#else
+    AU_UNUSED(fd);
+#endif
+  }
+
+  auto Doorbell::drain() -> u64
+  {
+#if IA_PLATFORM_LINUX
+    Mut<u64> count = 0;
+    if (read(m_fd, &count, sizeof(count)) != sizeof(count))
+    {
+      return 0;
+    }
+    return count;
+#else
+    return 0;
+#endif
+  }
+
+  auto Doorbell::get_fd() const -> i32
+  {
+    return m_fd;
+  }
+
+  auto Doorbell::is_valid() const -> bool
+  {
+    return m_fd != -1;
+  }
+} // namespace ia
@@ -0,0 +1,552 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <crux/journal.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+#include <utility>
+
+#if IA_PLATFORM_UNIX
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace ia::journal
+{
+  MappedFile::~MappedFile()
+  {
+    unmap();
+  }
+
+  MappedFile::MappedFile(MappedFile &&other)
+      : m_base(std::exchange(other.m_base, nullptr)), m_size(std::exchange(other.m_size, 0))
+  {
+  }
+
+  MappedFile &MappedFile::operator=(MappedFile &&other)
+  {
+    if (this != &other)
+    {
+      unmap();
+      m_base = std::exchange(other.m_base, nullptr);
+      m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+  }
+
+  auto MappedFile::create(Ref<String> path, const usize size) -> Result<MappedFile>
+  {
+#if IA_PLATFORM_UNIX
+    const i32 fd = ::open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR | O_CLOEXEC, 0644);
+    if (fd == -1)
+    {
+      return fail("Failed to create '{}': {}", path, std::strerror(errno));
+    }
+
+    // The mapping keeps the file alive, the descriptor is not needed past this point.
+    // Blocks are reserved up front where possible: a sparse file would turn a full disk into a SIGBUS on the
+    // first store into an unbacked page.
+#  if IA_PLATFORM_LINUX
+    const i32 error = posix_fallocate(fd, 0, static_cast<off_t>(size));
+#  else
+    const i32 error = ftruncate(fd, static_cast<off_t>(size)) == 0 ? 0 : errno;
+#  endif
+    if (error != 0)
+    {
+      close(fd);
+      return fail("Failed to resize '{}': {}", path, std::strerror(error));
+    }
+
+    void *const base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    const i32 map_error = errno;
+    close(fd);
+
+    if (base == MAP_FAILED)
+    {
+      return fail("Failed to map '{}': {}", path, std::strerror(map_error));
+    }
+
+    Mut<MappedFile> file;
+    file.m_base = static_cast<u8 *>(base);
+    file.m_size = size;
+    return file;
+#else
+    AU_UNUSED(size);
+    return fail("Journals are not supported on this platform ('{}')", path);
+#endif
+  }
+
+  auto MappedFile::open(Ref<String> path) -> Result<MappedFile>
+  {
+#if IA_PLATFORM_UNIX
+    const i32 fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+      return fail("Failed to open '{}': {}", path, std::strerror(errno));
+    }
+
+    Mut<struct stat> st{};
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+      close(fd);
+      return fail("Failed to stat '{}' (or it is empty)", path);
+    }
+
+    const usize size = static_cast<usize>(st.st_size);
+    void *const base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    const i32 error = errno;
+    close(fd);
+
+    if (base == MAP_FAILED)
+    {
+      return fail("Failed to map '{}': {}", path, std::strerror(error));
+    }
+
+    Mut<MappedFile> file;
+    file.m_base = static_cast<u8 *>(base);
+    file.m_size = size;
+    return file;
+#else
+    return fail("Journals are not supported on this platform ('{}')", path);
+#endif
+  }
+
+  auto MappedFile::get_data() -> Span<u8>
+  {
+    return Span<u8>(m_base, m_size);
+  }
+
+  auto MappedFile::get_data() const -> Span<const u8>
+  {
+    return Span<const u8>(m_base, m_size);
+  }
+
+  auto MappedFile::is_valid() const -> bool
+  {
+    return m_base != nullptr;
+  }
+
+  auto MappedFile::sync() -> Result<void>
+  {
+    if (m_base == nullptr)
+    {
+      return fail("File is not mapped");
+    }
+
+#if IA_PLATFORM_UNIX
+    if (msync(m_base, m_size, MS_SYNC) != 0)
+    {
+      return fail("msync failed: {}", std::strerror(errno));
+    }
+#endif
+
+    return {};
+  }
+
+  auto MappedFile::unmap() -> void
+  {
+    if (m_base == nullptr)
+    {
+      return;
+    }
+
+#if IA_PLATFORM_UNIX
+    munmap(m_base, m_size);
+#endif
+
+    m_base = nullptr;
+    m_size = 0;
+  }
+
+  auto get_segment_path(Ref<String> path_prefix, const u32 segment_index) -> String
+  {
+    return std::format("{}.{:06}.journal", path_prefix, segment_index);
+  }
+} // namespace ia::journal
+
+namespace ia
+{
+  namespace
+  {
+    auto get_index_capacity(Ref<JournalWriter::Options> options) -> u32
+    {
+      if (options.index_capacity != 0)
+      {
+        return options.index_capacity;
+      }
+      return static_cast<u32>(std::max<usize>(options.segment_size / 64, 1));
+    }
+
+    auto get_data_offset(const u32 index_capacity) -> usize
+    {
+      return sizeof(journal::SegmentHeader) + static_cast<usize>(index_capacity) * sizeof(journal::IndexEntry);
+    }
+  } // namespace
+
+  JournalWriter::~JournalWriter()
+  {
+    close();
+  }
+
+  JournalWriter::JournalWriter(JournalWriter &&other)
+      : m_path_prefix(std::move(other.m_path_prefix)), m_options(other.m_options), m_file(std::move(other.m_file)),
+        m_header(std::exchange(other.m_header, nullptr)), m_index(std::exchange(other.m_index, nullptr)),
+        m_data(std::exchange(other.m_data, nullptr)), m_segment_count(std::exchange(other.m_segment_count, 0)),
+        m_last_timestamp_ns(std::exchange(other.m_last_timestamp_ns, 0))
+  {
+  }
+
+  JournalWriter &JournalWriter::operator=(JournalWriter &&other)
+  {
+    if (this != &other)
+    {
+      close();
+      m_path_prefix = std::move(other.m_path_prefix);
+      m_options = other.m_options;
+      m_file = std::move(other.m_file);
+      m_header = std::exchange(other.m_header, nullptr);
+      m_index = std::exchange(other.m_index, nullptr);
+      m_data = std::exchange(other.m_data, nullptr);
+      m_segment_count = std::exchange(other.m_segment_count, 0);
+      m_last_timestamp_ns = std::exchange(other.m_last_timestamp_ns, 0);
+    }
+    return *this;
+  }
+
+  auto JournalWriter::create(Ref<String> path_prefix, Ref<Options> options) -> Result<JournalWriter>
+  {
+    if (options.segment_size <= sizeof(RingBufferView::PacketHeader))
+    {
+      return fail("Journal segment size too small");
+    }
+
+    // Segments past the ones this run will write would otherwise be read back as its continuation
+    for (Mut<u32> segment_index = 0;; segment_index++)
+    {
+      Mut<std::error_code> error;
+      if (!std::filesystem::remove(journal::get_segment_path(path_prefix, segment_index), error))
+      {
+        break;
+      }
+    }
+
+    Mut<JournalWriter> writer;
+    writer.m_path_prefix = path_prefix;
+    writer.m_options = options;
+
+    auto opened = writer.open_segment();
+    if (!opened)
+    {
+      return fail("{}", opened.error());
+    }
+
+    return writer;
+  }
+
+  auto JournalWriter::append(const u16 packet_id, Ref<Span<const u8>> data) -> Result<void>
+  {
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    return append(packet_id, data, std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+  }
+
+  auto JournalWriter::append(const u16 packet_id, Ref<Span<const u8>> data, const u64 timestamp_ns) -> Result<void>
+  {
+    if (m_header == nullptr)
+    {
+      return fail("Journal is closed");
+    }
+
+    if (data.size() > std::numeric_limits<u16>::max())
+    {
+      return fail("Data size exceeds u16 limit");
+    }
+
+    const usize record_size = sizeof(RingBufferView::PacketHeader) + data.size();
+    if (record_size > m_header->data_capacity)
+    {
+      return fail("Record larger than a journal segment");
+    }
+
+    if (m_header->data_size + record_size > m_header->data_capacity ||
+        m_header->record_count == m_header->index_capacity)
+    {
+      seal_segment();
+
+      auto opened = open_segment();
+      if (!opened)
+      {
+        return fail("{}", opened.error());
+      }
+    }
+
+    const u64 offset = m_header->data_size;
+
+    const RingBufferView::PacketHeader header{packet_id, static_cast<u16>(data.size())};
+    std::memcpy(m_data + offset, &header, sizeof(header));
+    std::memcpy(m_data + offset + sizeof(header), data.data(), data.size());
+
+    // A clock that stepped backwards would leave the index unsorted for seek(), so such records take the
+    // previous record's timestamp
+    m_last_timestamp_ns = std::max(m_last_timestamp_ns, timestamp_ns);
+    m_index[m_header->record_count] = journal::IndexEntry{m_last_timestamp_ns, offset};
+
+    // Publish the record last, so a crash leaves a consistent prefix behind
+    m_header->data_size = offset + record_size;
+    m_header->record_count++;
+
+    return {};
+  }
+
+  auto JournalWriter::close() -> void
+  {
+    if (m_header == nullptr)
+    {
+      return;
+    }
+
+    seal_segment();
+    m_file = {};
+  }
+
+  auto JournalWriter::get_segment_count() const -> u32
+  {
+    return m_segment_count;
+  }
+
+  auto JournalWriter::open_segment() -> Result<void>
+  {
+    const u32 index_capacity = get_index_capacity(m_options);
+    const usize data_offset = get_data_offset(index_capacity);
+
+    auto file = journal::MappedFile::create(journal::get_segment_path(m_path_prefix, m_segment_count),
+                                            data_offset + m_options.segment_size);
+    if (!file)
+    {
+      return fail("{}", file.error());
+    }
+
+    m_file = std::move(*file);
+
+    u8 *const base = m_file.get_data().data();
+    m_header = reinterpret_cast<journal::SegmentHeader *>(base);
+    m_index = reinterpret_cast<journal::IndexEntry *>(base + sizeof(journal::SegmentHeader));
+    m_data = base + data_offset;
+
+    m_header->magic = journal::SEGMENT_MAGIC;
+    m_header->version = journal::SEGMENT_VERSION;
+    m_header->flags = m_options.crc32 ? journal::SEGMENT_FLAG_CRC32 : 0;
+    m_header->segment_index = m_segment_count;
+    m_header->data_capacity = m_options.segment_size;
+    m_header->index_capacity = index_capacity;
+    m_header->record_count = 0;
+    m_header->data_size = 0;
+
+    m_segment_count++;
+
+    return {};
+  }
+
+  auto JournalWriter::seal_segment() -> void
+  {
+    if (m_header->flags & journal::SEGMENT_FLAG_CRC32)
+    {
+      m_header->crc32 = utils::crc32(Span<const u8>(m_data, m_header->data_size));
+    }
+
+    m_header->sealed = 1;
+
+    m_header = nullptr;
+    m_index = nullptr;
+    m_data = nullptr;
+  }
+
+  auto JournalReader::open(Ref<String> path_prefix) -> Result<JournalReader>
+  {
+    Mut<JournalReader> reader;
+
+    for (Mut<u32> segment_index = 0;; segment_index++)
+    {
+      const String path = journal::get_segment_path(path_prefix, segment_index);
+
+      auto file = journal::MappedFile::open(path);
+      if (!file)
+      {
+        // Segments are numbered without gaps, the first missing one ends the journal
+        if (segment_index == 0)
+        {
+          return fail("{}", file.error());
+        }
+        break;
+      }
+
+      const Span<const u8> bytes = std::as_const(*file).get_data();
+      if (bytes.size() < sizeof(journal::SegmentHeader))
+      {
+        return fail("Journal segment '{}' is truncated", path);
+      }
+
+      const auto *header = reinterpret_cast<const journal::SegmentHeader *>(bytes.data());
+      if (header->magic != journal::SEGMENT_MAGIC)
+      {
+        return fail("'{}' is not a journal segment", path);
+      }
+      if (header->version != journal::SEGMENT_VERSION)
+      {
+        return fail("Journal segment '{}' version mismatch: expected {}, found {}", path, journal::SEGMENT_VERSION,
+                    header->version);
+      }
+
+      const usize data_offset = get_data_offset(header->index_capacity);
+      if (data_offset + header->data_size > bytes.size() || header->record_count > header->index_capacity)
+      {
+        return fail("Journal segment '{}' is truncated", path);
+      }
+
+      if (header->sealed && (header->flags & journal::SEGMENT_FLAG_CRC32) &&
+          utils::crc32(bytes.subspan(data_offset, header->data_size)) != header->crc32)
+      {
+        return fail("Journal segment '{}' failed its CRC32 check", path);
+      }
+
+      // get_entry() trusts the index, so every record it points at must lie within data_size
+      const auto *index_entries =
+          reinterpret_cast<const journal::IndexEntry *>(bytes.data() + sizeof(journal::SegmentHeader));
+      for (Mut<u32> i = 0; i < header->record_count; i++)
+      {
+        const u64 offset = index_entries[i].offset;
+        if (header->data_size < sizeof(RingBufferView::PacketHeader) ||
+            offset > header->data_size - sizeof(RingBufferView::PacketHeader))
+        {
+          return fail("Journal segment '{}' has a corrupt index", path);
+        }
+
+        Mut<RingBufferView::PacketHeader> packet_header;
+        std::memcpy(&packet_header, bytes.data() + data_offset + offset, sizeof(packet_header));
+        if (offset + sizeof(packet_header) + packet_header.payload_size > header->data_size)
+        {
+          return fail("Journal segment '{}' has a corrupt index", path);
+        }
+      }
+
+      reader.m_first_records.push_back(reader.m_record_count);
+      reader.m_record_count += header->record_count;
+      reader.m_segments.push_back(std::move(*file));
+    }
+
+    return reader;
+  }
+
+  auto JournalReader::get_record_count() const -> u64
+  {
+    return m_record_count;
+  }
+
+  auto JournalReader::get_entry(const u64 index) const -> Option<Entry>
+  {
+    if (index >= m_record_count)
+    {
+      return std::nullopt;
+    }
+
+    const auto it = std::upper_bound(m_first_records.begin(), m_first_records.end(), index);
+    const usize segment = static_cast<usize>(std::distance(m_first_records.begin(), it)) - 1;
+
+    const journal::SegmentHeader *header = get_header(segment);
+    const u8 *base = m_segments[segment].get_data().data();
+
+    const auto *index_entries = reinterpret_cast<const journal::IndexEntry *>(base + sizeof(journal::SegmentHeader));
+    const journal::IndexEntry entry = index_entries[index - m_first_records[segment]];
+
+    const u8 *record = base + get_data_offset(header->index_capacity) + entry.offset;
+
+    Mut<RingBufferView::PacketHeader> packet_header;
+    std::memcpy(&packet_header, record, sizeof(packet_header));
+
+    return Entry{entry.timestamp_ns, packet_header.id,
+                 Span<const u8>(record + sizeof(packet_header), packet_header.payload_size)};
+  }
+
+  auto JournalReader::seek(const u64 timestamp_ns) const -> u64
+  {
+    // append() never lets a timestamp go backwards, so the index is sorted
+    Mut<u64> low = 0;
+    Mut<u64> high = m_record_count;
+    while (low < high)
+    {
+      const u64 mid = low + (high - low) / 2;
+      if (get_entry(mid)->timestamp_ns < timestamp_ns)
+      {
+        low = mid + 1;
+      }
+      else
+      {
+        high = mid;
+      }
+    }
+    return low;
+  }
+
+  auto JournalReader::replay(MutRef<RingBufferView> ring, const f64 speed, const u64 first, const u64 timeout_ms) const
+      -> Result<u64>
+  {
+    const auto start = std::chrono::steady_clock::now();
+    const bool waitable = (ring.get_flags() & RingBufferView::FLAG_WAITABLE) != 0;
+
+    Mut<u64> pushed = 0;
+    Mut<u64> first_timestamp = 0;
+
+    for (Mut<u64> i = first; i < m_record_count; i++)
+    {
+      const Entry entry = *get_entry(i);
+
+      if (i == first)
+      {
+        first_timestamp = entry.timestamp_ns;
+      }
+
+      if (speed > 0.0)
+      {
+        // append() keeps timestamps from going backwards, this only guards against a damaged index
+        const u64 elapsed_ns = entry.timestamp_ns > first_timestamp ? entry.timestamp_ns - first_timestamp : 0;
+        const auto offset = std::chrono::nanoseconds(static_cast<i64>(elapsed_ns / speed));
+        std::this_thread::sleep_until(start + offset);
+      }
+
+      // Both reject packets the ring can never take (reserved ids, oversized payloads) before waiting for room
+      auto result = waitable ? ring.push_wait(entry.id, entry.data, timeout_ms)
+                             : ring.push_spin(entry.id, entry.data, timeout_ms);
+      if (!result)
+      {
+        return fail("Replay stopped after {} packets: {}", pushed, result.error());
+      }
+
+      pushed++;
+    }
+
+    return pushed;
+  }
+
+  auto JournalReader::get_header(const usize segment) const -> const journal::SegmentHeader *
+  {
+    return reinterpret_cast<const journal::SegmentHeader *>(m_segments[segment].get_data().data());
+  }
+} // namespace ia
@@ -0,0 +1,480 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <crux/log_file.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <utility>
+
+#if IA_PLATFORM_UNIX
+#  include <fcntl.h>
+#  include <sys/file.h>
+#  include <unistd.h>
+#endif
+
+namespace ia
+{
+  namespace
+  {
+    auto get_level_tag(logger::Level level) -> StringView
+    {
+      switch (level)
+      {
+      case logger::Level::Trace:
+        return "[TRCE]";
+      case logger::Level::Debug:
+        return "[DEBG]";
+      case logger::Level::Info:
+        return "[INFO]";
+      case logger::Level::Warn:
+        return "[WARN]";
+      case logger::Level::Error:
+        return "[ERRO]";
+      case logger::Level::Fatal:
+        return "[FATL]";
+      }
+      return "[????]";
+    }
+
+    // Takes the exclusive lock on `<path_prefix>.lock`, failing without waiting if another sink holds it.
+    // Returns the descriptor, which keeps the lock until it is closed (by the process exiting, at the latest).
+    auto lock_prefix(Ref<String> path_prefix) -> Result<i32>
+    {
+#if IA_PLATFORM_UNIX
+      const String path = RotatingFileSink::get_lock_path(path_prefix);
+      const i32 fd = ::open(path.c_str(), O_CREAT | O_RDWR | O_CLOEXEC, 0644);
+      if (fd == -1)
+      {
+        return fail("Failed to open '{}': {}", path, std::strerror(errno));
+      }
+
+      if (flock(fd, LOCK_EX | LOCK_NB) != 0)
+      {
+        const i32 error = errno;
+        ::close(fd);
+        if (error == EWOULDBLOCK)
+        {
+          return fail("Log file prefix '{}' is already in use by another sink", path_prefix);
+        }
+        return fail("Failed to lock '{}': {}", path, std::strerror(error));
+      }
+
+      return fd;
+#else
+      AU_UNUSED(path_prefix);
+      return -1;
+#endif
+    }
+
+    auto unlock_prefix(const i32 fd) -> void
+    {
+#if IA_PLATFORM_UNIX
+      if (fd != -1)
+      {
+        ::close(fd);
+      }
+#else
+      AU_UNUSED(fd);
+#endif
+    }
+
+    // Indices of the `<path_prefix>.<index>.log` files already on disk, in ascending order
+    auto find_existing_files(Ref<String> path_prefix) -> Vec<u32>
+    {
+      const std::filesystem::path prefix(path_prefix);
+      const std::filesystem::path directory = prefix.has_parent_path() ? prefix.parent_path() : ".";
+      const String stem = prefix.filename().string() + ".";
+
+      Mut<Vec<u32>> indices;
+      Mut<std::error_code> ec;
+      for (Mut<std::filesystem::directory_iterator> it(directory, ec); !ec && it != std::filesystem::end(it);
+           it.increment(ec))
+      {
+        const String name = it->path().filename().string();
+        if (name.size() <= stem.size() + 4 || !name.starts_with(stem) || !name.ends_with(".log"))
+        {
+          continue;
+        }
+
+        const char *first = name.data() + stem.size();
+        const char *last = name.data() + name.size() - 4;
+        Mut<u32> index = 0;
+        const auto [end, error] = std::from_chars(first, last, index);
+        if (error == std::errc{} && end == last)
+        {
+          indices.push_back(index);
+        }
+      }
+
+      std::sort(indices.begin(), indices.end());
+      return indices;
+    }
+
+    // A file whose run crashed before finishing it still has its zero-filled tail. Returns false if nothing but
+    // the tail was left and the file was deleted.
+    auto trim_unfinished_file(Ref<String> path) -> bool
+    {
+      Mut<usize> size = 0;
+      {
+        auto file = journal::MappedFile::open(path);
+        if (!file)
+        {
+          // Empty (or unreadable), nothing to trim
+          return true;
+        }
+
+        const Span<const u8> data = std::as_const(*file).get_data();
+        size = data.size();
+        while (size > 0 && data[size - 1] == 0)
+        {
+          size--;
+        }
+
+        if (size == data.size())
+        {
+          return true;
+        }
+      }
+
+      Mut<std::error_code> ec;
+      if (size == 0)
+      {
+        std::filesystem::remove(path, ec);
+        return false;
+      }
+
+      std::filesystem::resize_file(path, size, ec);
+      return true;
+    }
+
+    // Syncs if asked to, unmaps and drops the unused tail so the file ends at its last line
+    auto finish_file(MutRef<journal::MappedFile> file, Ref<String> path, const usize size, const bool sync) -> void
+    {
+      if (sync)
+      {
+        (void) file.sync();
+      }
+
+      file = journal::MappedFile();
+
+      Mut<std::error_code> ec;
+      std::filesystem::resize_file(path, size, ec);
+    }
+  } // namespace
+
+  RotatingFileSink::~RotatingFileSink()
+  {
+    close();
+  }
+
+  auto RotatingFileSink::create(Ref<String> path_prefix, Ref<Options> options)
+      -> Result<std::unique_ptr<RotatingFileSink>>
+  {
+    if (options.file_size < 256)
+    {
+      return fail("Log file size must be at least 256 bytes, got {}", options.file_size);
+    }
+
+    auto lock_fd = lock_prefix(path_prefix);
+    if (!lock_fd)
+    {
+      return fail("{}", lock_fd.error());
+    }
+
+    auto sink = std::make_unique<RotatingFileSink>();
+    sink->m_path_prefix = path_prefix;
+    sink->m_options = options;
+    sink->m_lock_fd = *lock_fd;
+
+    // Carry on after the files earlier runs left behind, so none of them is overwritten
+    Mut<Vec<u32>> existing = find_existing_files(path_prefix);
+    std::erase_if(existing, [&](const u32 index) { return !trim_unfinished_file(get_file_path(path_prefix, index)); });
+    if (!existing.empty())
+    {
+      sink->m_first_index = existing.front();
+      sink->m_next_index = existing.back() + 1;
+    }
+    else
+    {
+      sink->m_first_index = sink->m_next_index;
+    }
+
+    const u32 index = sink->m_next_index++;
+    auto file = journal::MappedFile::create(get_file_path(path_prefix, index), options.file_size);
+    if (!file)
+    {
+      return fail("{}", file.error());
+    }
+
+    sink->m_file = std::move(*file);
+    sink->m_current_index = index;
+    sink->m_opened_at = std::chrono::steady_clock::now();
+
+    // The worker prepares the next file (and prunes old ones) right away
+    sink->m_prepare_requested = true;
+    sink->m_worker = std::thread([raw = sink.get()] { raw->run_worker(); });
+
+    return sink;
+  }
+
+  auto RotatingFileSink::get_file_path(Ref<String> path_prefix, const u32 file_index) -> String
+  {
+    return std::format("{}.{:06}.log", path_prefix, file_index);
+  }
+
+  auto RotatingFileSink::get_lock_path(Ref<String> path_prefix) -> String
+  {
+    return std::format("{}.lock", path_prefix);
+  }
+
+  auto RotatingFileSink::run_worker() -> void
+  {
+    Mut<std::unique_lock<std::mutex>> lock(m_mutex);
+    while (true)
+    {
+      m_wake.wait(lock, [this] { return m_stop_requested || m_prepare_requested || !m_finished_files.empty(); });
+
+      const bool stopping = m_stop_requested;
+      Mut<Vec<FinishedFile>> finished = std::exchange(m_finished_files, {});
+
+      const bool prepare = m_prepare_requested && !stopping;
+      m_prepare_requested = false;
+      const u32 prepare_index = prepare ? m_next_index++ : 0;
+
+      Mut<Vec<String>> expired;
+      while (m_options.max_files != 0 && m_current_index - m_first_index >= m_options.max_files)
+      {
+        expired.push_back(get_file_path(m_path_prefix, m_first_index++));
+      }
+
+      // The slow part, done without blocking the logging threads
+      lock.unlock();
+
+      for (MutRef<FinishedFile> finished_file : finished)
+      {
+        finish_file(finished_file.file, finished_file.path, finished_file.size, m_options.sync_on_rotate);
+      }
+
+      for (Ref<String> path : expired)
+      {
+        Mut<std::error_code> ec;
+        std::filesystem::remove(path, ec);
+      }
+
+      Mut<journal::MappedFile> prepared_file;
+      Mut<bool> prepared = false;
+      if (prepare)
+      {
+        auto file = journal::MappedFile::create(get_file_path(m_path_prefix, prepare_index), m_options.file_size);
+        if (file)
+        {
+          prepared_file = std::move(*file);
+          prepared = true;
+        }
+      }
+
+      lock.lock();
+
+      if (prepare)
+      {
+        m_prepared_file = std::move(prepared_file);
+        m_prepared_index = prepare_index;
+        m_prepare_failed = !prepared;
+        m_ready.notify_all();
+      }
+
+      if (stopping)
+      {
+        break;
+      }
+    }
+  }
+
+  auto RotatingFileSink::rotate_locked(MutRef<std::unique_lock<std::mutex>> lock) -> Result<void>
+  {
+    if (m_closed)
+    {
+      return fail("Log file sink is closed");
+    }
+
+    m_ready.wait(lock, [this] { return m_prepared_file.is_valid() || m_prepare_failed; });
+
+    if (!m_prepared_file.is_valid())
+    {
+      // Try again on the next rotation
+      m_prepare_failed = false;
+      m_prepare_requested = true;
+      m_wake.notify_one();
+      return fail("Failed to create log file '{}'", get_file_path(m_path_prefix, m_prepared_index));
+    }
+
+    m_finished_files.push_back(
+        FinishedFile{std::move(m_file), get_file_path(m_path_prefix, m_current_index), m_offset});
+
+    m_file = std::move(m_prepared_file);
+    m_current_index = m_prepared_index;
+    m_offset = 0;
+    m_opened_at = std::chrono::steady_clock::now();
+
+    m_prepare_requested = true;
+    m_wake.notify_one();
+
+    return {};
+  }
+
+  auto RotatingFileSink::rotate() -> Result<void>
+  {
+    Mut<std::unique_lock<std::mutex>> lock(m_mutex);
+    return rotate_locked(lock);
+  }
+
+  auto RotatingFileSink::close() -> void
+  {
+    {
+      const std::lock_guard lock(m_mutex);
+      if (m_closed)
+      {
+        return;
+      }
+      m_closed = true;
+
+      m_finished_files.push_back(
+          FinishedFile{std::move(m_file), get_file_path(m_path_prefix, m_current_index), m_offset});
+      m_stop_requested = true;
+      m_wake.notify_one();
+    }
+
+    // The worker finishes every file handed to it before it exits
+    if (m_worker.joinable())
+    {
+      m_worker.join();
+    }
+
+    const std::lock_guard lock(m_mutex);
+    if (m_prepared_file.is_valid())
+    {
+      m_prepared_file = journal::MappedFile();
+
+      Mut<std::error_code> ec;
+      std::filesystem::remove(get_file_path(m_path_prefix, m_prepared_index), ec);
+    }
+
+    // Only now may another sink trim and prune these files
+    unlock_prefix(std::exchange(m_lock_fd, -1));
+  }
+
+  auto RotatingFileSink::write(logger::Level level, StringView message, StringView file, u32 line) -> void
+  {
+    // "<seconds>.<microseconds> [LEVL] [file:line] message\n", every piece but the message bounded
+    const u64 now_us = static_cast<u64>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                            std::chrono::system_clock::now().time_since_epoch())
+                                            .count());
+
+    Mut<char> prefix[64];
+    Mut<char *> cursor = std::to_chars(prefix, prefix + 24, now_us / 1000000).ptr;
+    *cursor++ = '.';
+    const u64 micros = now_us % 1000000;
+    for (Mut<u64> divisor = 100000; divisor > 0; divisor /= 10)
+    {
+      *cursor++ = static_cast<char>('0' + (micros / divisor) % 10);
+    }
+    *cursor++ = ' ';
+
+    const StringView tag = get_level_tag(level);
+    std::memcpy(cursor, tag.data(), tag.size());
+    cursor += tag.size();
+    *cursor++ = ' ';
+    *cursor++ = '[';
+
+    Mut<char> line_digits[16];
+    const auto line_end = std::to_chars(line_digits, line_digits + sizeof(line_digits), line).ptr;
+    const StringView line_text(line_digits, static_cast<usize>(line_end - line_digits));
+
+    const StringView pieces[] = {
+        StringView(prefix, static_cast<usize>(cursor - prefix)), file, ":", line_text, "] ", message, "\n",
+    };
+
+    Mut<usize> size = 0;
+    for (const StringView piece : pieces)
+    {
+      size += piece.size();
+    }
+    size = std::min(size, m_options.file_size);
+
+    Mut<std::unique_lock<std::mutex>> lock(m_mutex);
+    if (m_closed)
+    {
+      m_dropped_count++;
+      return;
+    }
+
+    const bool expired =
+        m_options.max_age_ms != 0 &&
+        std::chrono::steady_clock::now() - m_opened_at >= std::chrono::milliseconds(m_options.max_age_ms);
+
+    if (m_offset + size > m_options.file_size || expired)
+    {
+      if (!rotate_locked(lock))
+      {
+        m_dropped_count++;
+        return;
+      }
+    }
+
+    const Span<u8> data = m_file.get_data();
+    Mut<usize> remaining = size;
+    for (const StringView piece : pieces)
+    {
+      const usize count = std::min(piece.size(), remaining);
+      std::memcpy(data.data() + m_offset, piece.data(), count);
+      m_offset += count;
+      remaining -= count;
+    }
+
+    // A truncated line still ends with a newline
+    if (size == m_options.file_size)
+    {
+      data[m_offset - 1] = '\n';
+    }
+  }
+
+  auto RotatingFileSink::handler(void *user_data, logger::Level level, StringView message, StringView file, u32 line)
+      -> void
+  {
+    reinterpret_cast<RotatingFileSink *>(user_data)->write(level, message, file, line);
+  }
+
+  auto RotatingFileSink::get_current_path() const -> String
+  {
+    const std::lock_guard lock(m_mutex);
+    return get_file_path(m_path_prefix, m_current_index);
+  }
+
+  auto RotatingFileSink::get_current_index() const -> u32
+  {
+    const std::lock_guard lock(m_mutex);
+    return m_current_index;
+  }
+
+  auto RotatingFileSink::get_dropped_count() const -> u64
+  {
+    const std::lock_guard lock(m_mutex);
+    return m_dropped_count;
+  }
+} // namespace ia
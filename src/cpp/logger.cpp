@@ -13,23 +13,70 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <crux/adt/ring_buffer.hpp>
+#include <crux/env.hpp>
 #include <crux/logger.hpp>
 
+#include <algorithm>
 #include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+#if IA_PLATFORM_UNIX
+#  include <csignal>
+#  include <unistd.h>
+#else
+#  include <cstdio>
+#  include <io.h>
+#endif
 
 namespace ia::logger
 {
   namespace
   {
-    Mut<std::mutex> g_console_mutex;
+    auto is_console_colored() -> bool
+    {
+#if IA_PLATFORM_UNIX
+      static const bool s_is_tty = isatty(STDOUT_FILENO) != 0;
+#else
+      static const bool s_is_tty = _isatty(_fileno(stdout)) != 0;
+#endif
+      return s_is_tty;
+    }
 
-    void default_console_handler(void *user_data, Level level, StringView msg, StringView file, u32 line)
+    // One write per line, so concurrent lines do not interleave and no lock is needed
+    auto write_console(StringView text) -> void
     {
-      AU_UNUSED(user_data);
+#if IA_PLATFORM_UNIX
+      while (!text.empty())
+      {
+        const ssize_t written = ::write(STDOUT_FILENO, text.data(), text.size());
+        if (written < 0)
+        {
+          if (errno == EINTR)
+          {
+            continue;
+          }
+          return;
+        }
+        text.remove_prefix(static_cast<usize>(written));
+      }
+#else
+      std::fwrite(text.data(), 1, text.size(), stdout);
+#endif
+    }
 
-      const auto filename = std::filesystem::path(file).filename().string();
+    thread_local Mut<String> t_console_line{};
 
-      const std::lock_guard lock(g_console_mutex);
+    void default_console_handler(void *user_data, Level level, StringView msg, StringView file, u32 line)
+    {
+      AU_UNUSED(user_data);
 
       Mut<const char *> color_code = ia::console::RESET;
       Mut<const char *> level_str = "[INFO]";
@@ -62,14 +109,815 @@ namespace ia::logger
         break;
       }
 
-      std::cout << color_code << level_str << " " << ia::console::RESET << "[" << filename << ":" << line << "] " << msg
-                << "\n";
+      Mut<char> line_digits[16];
+      const auto line_end = std::to_chars(line_digits, line_digits + sizeof(line_digits), line).ptr;
+
+      const bool colored = is_console_colored();
+
+      MutRef<String> out = t_console_line;
+      out.clear();
+      if (colored)
+      {
+        out += color_code;
+      }
+      out += level_str;
+      out += ' ';
+      if (colored)
+      {
+        out += ia::console::RESET;
+      }
+      out += '[';
+      out += file;
+      out += ':';
+      out.append(line_digits, line_end);
+      out += "] ";
+      out += msg;
+      out += '\n';
+
+      write_console(out);
     }
 
     Mut<std::atomic<Handler>> g_active_handler{default_console_handler};
     Mut<std::atomic<void *>> g_active_handler_user_data{nullptr};
+
+    // A slot is live while `handler` is non-null; it is published last and cleared first. `in_flight` counts the
+    // emit() calls currently inside the handler, remove_sink() waits for it to drain.
+    struct alignas(64) SinkSlot
+    {
+      Mut<std::atomic<Handler>> handler{nullptr};
+      Mut<std::atomic<void *>> user_data{nullptr};
+      Mut<std::atomic<Level>> min_level{Level::Trace};
+      Mut<std::atomic<u32>> in_flight{0};
+    };
+
+    Mut<std::array<SinkSlot, MAX_SINKS>> g_sinks{};
+    // One past the highest slot ever used, so emit() only scans what it has to
+    Mut<std::atomic<u32>> g_sink_end{0};
+    // Serializes add_sink()/remove_sink(), never taken while emitting
+    Mut<std::mutex> g_sinks_mutex{};
+
+    static constexpr const u32 MIN_ASYNC_BUFFER_SIZE = 1024;
+    static constexpr const u16 RECORD_PACKET_ID = 1;
+
+    // Head of the intrusive list of categories. Function-local so categories in other translation units can
+    // register during their static initialization.
+    auto get_category_list() -> MutRef<std::atomic<Category *>>
+    {
+      static Mut<std::atomic<Category *>> s_head{nullptr};
+      return s_head;
+    }
+
+    // The threshold install_verbosity_signal() goes back to
+    Mut<std::atomic<Level>> g_signal_saved_level{Level::Trace};
+
+    static_assert(std::atomic<u8>::is_always_lock_free, "Category levels must be settable from a signal handler");
+
+    auto parse_level(StringView text) -> Option<Level>
+    {
+      static constexpr const std::pair<const char *, Level> LEVELS[] = {
+          {"trace", Level::Trace}, {"debug", Level::Debug}, {"info", Level::Info},
+          {"warn", Level::Warn},   {"error", Level::Error}, {"fatal", Level::Fatal},
+      };
+
+      for (const auto &[name, level] : LEVELS)
+      {
+        const StringView candidate = name;
+        if (candidate.size() == text.size() &&
+            std::equal(text.begin(), text.end(), candidate.begin(),
+                       [](const char a, const char b) { return std::tolower(static_cast<u8>(a)) == b; }))
+        {
+          return level;
+        }
+      }
+      return std::nullopt;
+    }
+
+    auto trim(StringView text) -> StringView
+    {
+      while (!text.empty() && std::isspace(static_cast<u8>(text.front())))
+      {
+        text.remove_prefix(1);
+      }
+      while (!text.empty() && std::isspace(static_cast<u8>(text.back())))
+      {
+        text.remove_suffix(1);
+      }
+      return text;
+    }
+
+#if IA_PLATFORM_UNIX
+    void handle_verbosity_signal(int signal_number)
+    {
+      AU_UNUSED(signal_number);
+
+      // Only lock-free atomics in here
+      const Level current = g_min_level.load(std::memory_order_relaxed);
+      if (current != Level::Trace)
+      {
+        g_signal_saved_level.store(current, std::memory_order_relaxed);
+        g_min_level.store(Level::Trace, std::memory_order_relaxed);
+      }
+      else
+      {
+        g_min_level.store(g_signal_saved_level.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      }
+    }
+#endif
+
+    struct FormatBuffer
+    {
+      Mut<String> text{};
+      Mut<bool> in_use{false};
+    };
+
+    thread_local Mut<FormatBuffer> t_format_buffer{};
+
+    Mut<std::atomic<RecordSink>> g_record_sink{nullptr};
+    Mut<std::atomic<void *>> g_record_sink_user_data{nullptr};
+
+    struct CallSiteRegistry
+    {
+      Mut<std::mutex> mutex{};
+      Mut<Vec<std::unique_ptr<CallSite>>> call_sites{};
+    };
+
+    auto get_call_site_registry() -> MutRef<CallSiteRegistry>
+    {
+      static Mut<CallSiteRegistry> s_registry{};
+      return s_registry;
+    }
+
+    // Payload prefix of every record in a thread's buffer, the message bytes (or, with a call site, the encoded
+    // arguments) follow it. `file` comes from a Site, so it has static storage.
+    struct RecordHeader
+    {
+      Mut<u64> timestamp_ns{};
+      Mut<StringView> file{};
+      Mut<const CallSite *> call_site{};
+      Mut<u32> line{};
+      Mut<Level> level{};
+    };
+
+    struct ThreadBuffer
+    {
+      Mut<RingBufferView::ControlBlock> control_block{};
+      Mut<Vec<u8>> data{};
+
+      // `producer` belongs to the logging thread, `consumer` to the background thread
+      Mut<RingBufferView> producer = RingBufferView::default_instance();
+      Mut<RingBufferView> consumer = RingBufferView::default_instance();
+
+      Mut<usize> max_message_size{};
+      Mut<u64> generation{};
+
+      // Set by the owning thread while it writes a record, so stop_async() can wait for it to be committed
+      alignas(64) Mut<std::atomic<bool>> writing{false};
+
+      // Set when the owning thread exits. Once the background thread has seen it and drained the buffer
+      // afterwards, it sets `released` and the buffer leaves the registry.
+      Mut<std::atomic<bool>> retired{false};
+      Mut<bool> released{false};
+    };
+
+    // Each thread holds a reference to its buffer, the registry holds the other one
+    struct ThreadBufferSlot
+    {
+      Mut<std::shared_ptr<ThreadBuffer>> buffer{};
+
+      ~ThreadBufferSlot()
+      {
+        if (buffer)
+        {
+          buffer->retired.store(true, std::memory_order_release);
+        }
+      }
+    };
+
+    thread_local Mut<ThreadBufferSlot> t_buffer_slot{};
+
+    struct AsyncState
+    {
+      // Guards everything below. Logging threads only take it to register their buffer.
+      Mut<std::mutex> mutex{};
+      Mut<std::condition_variable> wake{};
+      Mut<std::condition_variable> drained{};
+
+      Mut<std::thread> worker{};
+      Mut<AsyncOptions> options{};
+      Mut<Vec<std::shared_ptr<ThreadBuffer>>> buffers{};
+
+      Mut<bool> stop_requested{false};
+      Mut<u64> flush_requested{0};
+      Mut<u64> flush_completed{0};
+    };
+
+    Mut<AsyncState> g_async{};
+
+    Mut<std::atomic<bool>> g_async_active{false};
+    // Bumped by every start_async(), so buffers registered before a stop_async() are not reused
+    Mut<std::atomic<u64>> g_async_generation{0};
+    Mut<std::atomic<OverflowPolicy>> g_overflow_policy{OverflowPolicy::Drop};
+    Mut<std::atomic<u64>> g_dropped_count{0};
+
+    auto get_timestamp_ns() -> u64
+    {
+      return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                  std::chrono::steady_clock::now().time_since_epoch())
+                                  .count());
+    }
+
+    auto create_thread_buffer(const u32 buffer_size) -> std::shared_ptr<ThreadBuffer>
+    {
+      auto buffer = std::make_shared<ThreadBuffer>();
+      buffer->data.resize(buffer_size);
+
+      const Span<u8> data(buffer->data);
+      buffer->producer = *RingBufferView::create(&buffer->control_block, data, true);
+      buffer->consumer = *RingBufferView::create(&buffer->control_block, data, false);
+
+      // Keeping records under half the ring guarantees reserve() can always place one in an empty buffer
+      buffer->max_message_size = std::min<usize>(std::numeric_limits<u16>::max(), buffer_size / 2) -
+                                 sizeof(RingBufferView::PacketHeader) * 2 - sizeof(RecordHeader);
+
+      return buffer;
+    }
+
+    // Returns nullptr if async mode is (no longer) running
+    auto get_thread_buffer() -> ThreadBuffer *
+    {
+      MutRef<ThreadBufferSlot> slot = t_buffer_slot;
+
+      const u64 generation = g_async_generation.load(std::memory_order_acquire);
+      if (slot.buffer && slot.buffer->generation == generation)
+      {
+        return slot.buffer.get();
+      }
+
+      const std::lock_guard lock(g_async.mutex);
+      if (!g_async_active.load(std::memory_order_relaxed))
+      {
+        return nullptr;
+      }
+
+      auto buffer = create_thread_buffer(g_async.options.buffer_size);
+      buffer->generation = g_async_generation.load(std::memory_order_relaxed);
+      g_async.buffers.push_back(buffer);
+
+      slot.buffer = std::move(buffer);
+      return slot.buffer.get();
+    }
+
+    // Marks the calling thread as writing into `buffer`. Fails if async mode stopped in the meantime; the
+    // seq_cst pair with stop_async() guarantees that either this sees the stop or stop_async() sees the flag.
+    auto begin_write(MutRef<ThreadBuffer> buffer) -> bool
+    {
+      buffer.writing.store(true, std::memory_order_seq_cst);
+      if (!g_async_active.load(std::memory_order_seq_cst))
+      {
+        buffer.writing.store(false, std::memory_order_release);
+        return false;
+      }
+      return true;
+    }
+
+    auto end_write(MutRef<ThreadBuffer> buffer) -> void
+    {
+      buffer.writing.store(false, std::memory_order_release);
+    }
+
+    // Claims room for a record whose header is followed by `body_size` bytes, applying the overflow policy.
+    // Returns the room after the header, or nullopt if the record was dropped (and counted).
+    auto reserve_record(MutRef<ThreadBuffer> buffer, Ref<RecordHeader> header, const usize body_size)
+        -> Option<Span<u8>>
+    {
+      if (body_size > buffer.max_message_size)
+      {
+        g_dropped_count.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+      }
+
+      const usize record_size = sizeof(RecordHeader) + body_size;
+
+      Mut<Result<Span<u8>>> payload = buffer.producer.reserve(RECORD_PACKET_ID, record_size);
+      if (!payload && g_overflow_policy.load(std::memory_order_relaxed) == OverflowPolicy::Block)
+      {
+        while (!payload && g_async_active.load(std::memory_order_relaxed))
+        {
+          std::this_thread::yield();
+          payload = buffer.producer.reserve(RECORD_PACKET_ID, record_size);
+        }
+      }
+
+      if (!payload)
+      {
+        g_dropped_count.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+      }
+
+      std::memcpy(payload->data(), &header, sizeof(RecordHeader));
+      return payload->subspan(sizeof(RecordHeader));
+    }
+
+    // Returns false if the record must be dispatched synchronously instead
+    auto enqueue(Level level, StringView message, Ref<Site> site) -> bool
+    {
+      ThreadBuffer *buffer = get_thread_buffer();
+      if (buffer == nullptr || !begin_write(*buffer))
+      {
+        return false;
+      }
+
+      const usize message_size = std::min(message.size(), buffer->max_message_size);
+
+      const RecordHeader header{get_timestamp_ns(), site.file, nullptr, site.line, level};
+      const auto body = reserve_record(*buffer, header, message_size);
+      if (body)
+      {
+        std::memcpy(body->data(), message.data(), message_size);
+        buffer->producer.commit();
+      }
+
+      end_write(*buffer);
+      return true;
+    }
+
+    auto emit(Level level, StringView message, StringView file, u32 line) -> void
+    {
+      const auto handler = g_active_handler.load(std::memory_order_relaxed);
+      if (handler)
+      {
+        handler(g_active_handler_user_data.load(), level, message, file, line);
+      }
+
+      const u32 sink_end = g_sink_end.load(std::memory_order_acquire);
+      for (Mut<u32> i = 0; i < sink_end; i++)
+      {
+        MutRef<SinkSlot> slot = g_sinks[i];
+
+        // Free and filtering slots are skipped without touching the counter
+        if (slot.handler.load(std::memory_order_relaxed) == nullptr ||
+            level < slot.min_level.load(std::memory_order_relaxed))
+        {
+          continue;
+        }
+
+        // seq_cst pairs with remove_sink(): either the handler is seen cleared here, or the count is seen there
+        slot.in_flight.fetch_add(1, std::memory_order_seq_cst);
+        const auto sink = slot.handler.load(std::memory_order_seq_cst);
+        if (sink)
+        {
+          sink(slot.user_data.load(std::memory_order_relaxed), level, message, file, line);
+        }
+        slot.in_flight.fetch_sub(1, std::memory_order_release);
+      }
+    }
+
+    auto emit_deferred(Ref<CallSite> call_site, const u64 timestamp_ns, Span<const u8> args) -> void
+    {
+      const auto sink = g_record_sink.load(std::memory_order_relaxed);
+      if (sink)
+      {
+        sink(g_record_sink_user_data.load(), call_site, timestamp_ns, args);
+        return;
+      }
+
+      const auto message = format_encoded(call_site.format, call_site.arg_types, args);
+      if (!message)
+      {
+        emit(call_site.level, std::format("<deferred format failed: {}>", message.error()), call_site.file,
+             call_site.line);
+        return;
+      }
+
+      emit(call_site.level, *message, call_site.file, call_site.line);
+    }
+
+    // Where the calling thread's pending deferred record lives between begin_deferred() and end_deferred():
+    // its async buffer, or the scratch buffer in synchronous mode
+    thread_local Mut<ThreadBuffer *> t_deferred_buffer{nullptr};
+    thread_local Mut<Vec<u8>> t_deferred_scratch{};
+
+    struct DecodedArg
+    {
+      Mut<ArgType> type{};
+      Mut<u64> bits{};
+      Mut<StringView> text{};
+    };
+
+    auto decode_args(Span<const ArgType> arg_types, Span<const u8> args, MutRef<Vec<DecodedArg>> out)
+        -> Result<void>
+    {
+      Mut<usize> offset = 0;
+      const auto read = [&](void *data, const usize size) -> bool {
+        if (args.size() - offset < size)
+        {
+          return false;
+        }
+        std::memcpy(data, args.data() + offset, size);
+        offset += size;
+        return true;
+      };
+
+      out.clear();
+      for (const ArgType type : arg_types)
+      {
+        Mut<DecodedArg> arg{type};
+        Mut<bool> ok = true;
+
+        switch (type)
+        {
+        case ArgType::Bool:
+        case ArgType::Char:
+          ok = read(&arg.bits, sizeof(u8));
+          break;
+        case ArgType::Float:
+          ok = read(&arg.bits, sizeof(f32));
+          break;
+        case ArgType::String: {
+          Mut<u32> size = 0;
+          ok = read(&size, sizeof(size)) && args.size() - offset >= size;
+          if (ok)
+          {
+            arg.text = StringView(reinterpret_cast<const char *>(args.data()) + offset, size);
+            offset += size;
+          }
+          break;
+        }
+        case ArgType::Int:
+        case ArgType::UInt:
+        case ArgType::Double:
+        case ArgType::Pointer:
+          ok = read(&arg.bits, sizeof(u64));
+          break;
+        default:
+          return fail("Unknown argument type {}", static_cast<u32>(type));
+        }
+
+        if (!ok)
+        {
+          return fail("Argument block truncated at argument {}", out.size());
+        }
+        out.push_back(arg);
+      }
+
+      if (offset != args.size())
+      {
+        return fail("Argument block has {} trailing bytes", args.size() - offset);
+      }
+
+      return {};
+    }
+
+    // Formats one argument on its own through a "{:spec}" format string
+    auto format_arg(Ref<DecodedArg> arg, StringView field_format, MutRef<String> out) -> void
+    {
+      switch (arg.type)
+      {
+      case ArgType::Bool: {
+        const bool value = arg.bits != 0;
+        out += std::vformat(field_format, std::make_format_args(value));
+        break;
+      }
+      case ArgType::Char: {
+        const char value = static_cast<char>(arg.bits);
+        out += std::vformat(field_format, std::make_format_args(value));
+        break;
+      }
+      case ArgType::Int: {
+        Mut<i64> value;
+        std::memcpy(&value, &arg.bits, sizeof(value));
+        out += std::vformat(field_format, std::make_format_args(value));
+        break;
+      }
+      case ArgType::UInt: {
+        const u64 value = arg.bits;
+        out += std::vformat(field_format, std::make_format_args(value));
+        break;
+      }
+      case ArgType::Float: {
+        Mut<f32> value;
+        std::memcpy(&value, &arg.bits, sizeof(value));
+        out += std::vformat(field_format, std::make_format_args(value));
+        break;
+      }
+      case ArgType::Double: {
+        Mut<f64> value;
+        std::memcpy(&value, &arg.bits, sizeof(value));
+        out += std::vformat(field_format, std::make_format_args(value));
+        break;
+      }
+      case ArgType::String: {
+        const StringView value = arg.text;
+        out += std::vformat(field_format, std::make_format_args(value));
+        break;
+      }
+      case ArgType::Pointer: {
+        const void *value = reinterpret_cast<const void *>(arg.bits);
+        out += std::vformat(field_format, std::make_format_args(value));
+        break;
+      }
+      }
+    }
+
+    struct DrainHead
+    {
+      Mut<bool> has_record{false};
+      Mut<RecordHeader> header{};
+      Mut<StringView> message{};
+    };
+
+    auto peek_record(MutRef<ThreadBuffer> buffer, MutRef<DrainHead> head) -> void
+    {
+      const auto packet = buffer.consumer.peek();
+      head.has_record = packet.has_value();
+      if (!head.has_record)
+      {
+        return;
+      }
+
+      // reserve() always hands out contiguous payloads, so `second` is empty
+      std::memcpy(&head.header, packet->first.data(), sizeof(RecordHeader));
+      head.message = StringView(reinterpret_cast<const char *>(packet->first.data()) + sizeof(RecordHeader),
+                                packet->first.size() - sizeof(RecordHeader));
+    }
+
+    // Hands the buffered records stamped before `cutoff_ns` to the handler, oldest first. Later records are left
+    // for the next pass, so threads that keep logging cannot hold the worker here (and flush() waiting) forever.
+    auto drain(Ref<Vec<std::shared_ptr<ThreadBuffer>>> buffers, MutRef<Vec<DrainHead>> heads, const u64 cutoff_ns)
+        -> usize
+    {
+      Mut<Vec<bool>> retired(buffers.size());
+
+      heads.assign(buffers.size(), DrainHead{});
+      for (Mut<usize> i = 0; i < buffers.size(); i++)
+      {
+        // Read before draining: everything the thread logged is then guaranteed to be visible
+        retired[i] = buffers[i]->retired.load(std::memory_order_acquire);
+        peek_record(*buffers[i], heads[i]);
+      }
+
+      Mut<usize> count = 0;
+      while (true)
+      {
+        Mut<usize> next = buffers.size();
+        for (Mut<usize> i = 0; i < buffers.size(); i++)
+        {
+          if (!heads[i].has_record)
+          {
+            continue;
+          }
+          if (next == buffers.size() || heads[i].header.timestamp_ns < heads[next].header.timestamp_ns)
+          {
+            next = i;
+          }
+        }
+
+        // Each thread stamps its records in order, so every other buffered record is at least as late
+        if (next == buffers.size() || heads[next].header.timestamp_ns >= cutoff_ns)
+        {
+          break;
+        }
+
+        Ref<DrainHead> head = heads[next];
+        if (head.header.call_site != nullptr)
+        {
+          emit_deferred(*head.header.call_site, head.header.timestamp_ns,
+                        Span<const u8>(reinterpret_cast<const u8 *>(head.message.data()), head.message.size()));
+        }
+        else
+        {
+          emit(head.header.level, head.message, head.header.file, head.header.line);
+        }
+
+        buffers[next]->consumer.consume();
+        peek_record(*buffers[next], heads[next]);
+        count++;
+      }
+
+      for (Mut<usize> i = 0; i < buffers.size(); i++)
+      {
+        // A retired thread may still have records past the cutoff; those keep the buffer for another pass
+        buffers[i]->released = retired[i] && !heads[i].has_record;
+      }
+
+      return count;
+    }
+
+    auto run_async_worker() -> void
+    {
+      Mut<Vec<std::shared_ptr<ThreadBuffer>>> buffers;
+      Mut<Vec<DrainHead>> heads;
+
+      Mut<std::unique_lock<std::mutex>> lock(g_async.mutex);
+      while (true)
+      {
+        const u64 flush_target = g_async.flush_requested;
+        const bool stopping = g_async.stop_requested;
+        const u64 cutoff_ns = get_timestamp_ns();
+
+        std::erase_if(g_async.buffers, [](Ref<std::shared_ptr<ThreadBuffer>> buffer) { return buffer->released; });
+        buffers = g_async.buffers;
+
+        lock.unlock();
+        const usize drained = drain(buffers, heads, cutoff_ns);
+        buffers.clear();
+        lock.lock();
+
+        g_async.flush_completed = flush_target;
+        g_async.drained.notify_all();
+
+        if (stopping)
+        {
+          break;
+        }
+
+        if (drained == 0)
+        {
+          g_async.wake.wait_for(lock, std::chrono::milliseconds(g_async.options.poll_interval_ms), [flush_target] {
+            return g_async.stop_requested || g_async.flush_requested != flush_target;
+          });
+        }
+      }
+    }
   } // namespace
 
+  auto set_level(Level level) -> void
+  {
+    g_min_level.store(level, std::memory_order_relaxed);
+  }
+
+  auto get_level() -> Level
+  {
+    return g_min_level.load(std::memory_order_relaxed);
+  }
+
+  Category::Category(const char *name) : m_name(name)
+  {
+    MutRef<std::atomic<Category *>> head = get_category_list();
+
+    m_next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(m_next, this, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+  }
+
+  auto Category::set_level(Level level) -> void
+  {
+    m_level.store(static_cast<u8>(level), std::memory_order_relaxed);
+  }
+
+  auto Category::reset_level() -> void
+  {
+    m_level.store(LEVEL_INHERIT, std::memory_order_relaxed);
+  }
+
+  auto Category::get_level() const -> Option<Level>
+  {
+    const u8 level = m_level.load(std::memory_order_relaxed);
+    if (level == LEVEL_INHERIT)
+    {
+      return std::nullopt;
+    }
+    return static_cast<Level>(level);
+  }
+
+  auto Category::get_name() const -> StringView
+  {
+    return m_name;
+  }
+
+  auto Category::get_next() const -> Category *
+  {
+    return m_next;
+  }
+
+  auto get_first_category() -> Category *
+  {
+    return get_category_list().load(std::memory_order_acquire);
+  }
+
+  auto find_category(StringView name) -> Category *
+  {
+    for (Mut<Category *> category = get_first_category(); category != nullptr; category = category->get_next())
+    {
+      if (category->get_name() == name)
+      {
+        return category;
+      }
+    }
+    return nullptr;
+  }
+
+  auto configure(StringView spec) -> Result<void>
+  {
+    struct Setting
+    {
+      Mut<Category *> category{};
+      Mut<Option<Level>> level{};
+    };
+
+    Mut<Option<Level>> global_level;
+    Mut<Vec<Setting>> settings;
+
+    while (!spec.empty())
+    {
+      const usize comma = spec.find(',');
+      const StringView entry = trim(spec.substr(0, comma));
+      spec = comma == StringView::npos ? StringView{} : spec.substr(comma + 1);
+
+      if (entry.empty())
+      {
+        continue;
+      }
+
+      const usize equals = entry.find('=');
+      if (equals == StringView::npos)
+      {
+        global_level = parse_level(entry);
+        if (!global_level)
+        {
+          return fail("Unknown log level '{}'", entry);
+        }
+        continue;
+      }
+
+      const StringView name = trim(entry.substr(0, equals));
+      const StringView value = trim(entry.substr(equals + 1));
+
+      Mut<Setting> setting;
+      setting.category = find_category(name);
+      if (setting.category == nullptr)
+      {
+        return fail("Unknown log category '{}'", name);
+      }
+
+      if (value != "default")
+      {
+        setting.level = parse_level(value);
+        if (!setting.level)
+        {
+          return fail("Unknown log level '{}' for category '{}'", value, name);
+        }
+      }
+
+      settings.push_back(setting);
+    }
+
+    if (global_level)
+    {
+      set_level(*global_level);
+    }
+
+    for (Ref<Setting> setting : settings)
+    {
+      if (setting.level)
+      {
+        setting.category->set_level(*setting.level);
+      }
+      else
+      {
+        setting.category->reset_level();
+      }
+    }
+
+    return {};
+  }
+
+  auto configure_from_env(Ref<String> name) -> Result<void>
+  {
+    const auto value = env::find(name);
+    if (!value)
+    {
+      return {};
+    }
+
+    auto configured = configure(*value);
+    if (!configured)
+    {
+      return fail("{}: {}", name, configured.error());
+    }
+    return {};
+  }
+
+  auto install_verbosity_signal(const i32 signal_number) -> Result<void>
+  {
+#if IA_PLATFORM_UNIX
+    struct sigaction action{};
+    action.sa_handler = handle_verbosity_signal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+
+    if (sigaction(signal_number, &action, nullptr) != 0)
+    {
+      return fail("sigaction({}) failed: {}", signal_number, std::strerror(errno));
+    }
+    return {};
+#else
+    AU_UNUSED(signal_number);
+    return fail("Verbosity signals are not supported on this platform");
+#endif
+  }
+
   auto set_handler(Handler handler, void *user_data) -> void
   {
     if (handler == nullptr)
@@ -84,10 +932,348 @@ namespace ia::logger
     }
   }
 
+  auto acquire_format_buffer() -> String *
+  {
+    if (t_format_buffer.in_use)
+    {
+      return nullptr;
+    }
+
+    t_format_buffer.in_use = true;
+    return &t_format_buffer.text;
+  }
+
+  auto release_format_buffer() -> void
+  {
+    t_format_buffer.in_use = false;
+  }
+
+  auto null_handler(void *user_data, Level level, StringView message, StringView file, u32 line) -> void
+  {
+    AU_UNUSED(user_data);
+    AU_UNUSED(level);
+    AU_UNUSED(message);
+    AU_UNUSED(file);
+    AU_UNUSED(line);
+  }
+
+  auto add_sink(Handler handler, void *user_data, Level min_level) -> Result<SinkId>
+  {
+    if (handler == nullptr)
+    {
+      return fail("Sink handler is null");
+    }
+
+    const std::lock_guard lock(g_sinks_mutex);
+
+    for (Mut<u32> i = 0; i < MAX_SINKS; i++)
+    {
+      MutRef<SinkSlot> slot = g_sinks[i];
+      if (slot.handler.load(std::memory_order_relaxed) != nullptr)
+      {
+        continue;
+      }
+
+      slot.user_data.store(user_data, std::memory_order_relaxed);
+      slot.min_level.store(min_level, std::memory_order_relaxed);
+      slot.handler.store(handler, std::memory_order_release);
+
+      if (g_sink_end.load(std::memory_order_relaxed) <= i)
+      {
+        g_sink_end.store(i + 1, std::memory_order_release);
+      }
+      return i;
+    }
+
+    return fail("All {} log sinks are in use", MAX_SINKS);
+  }
+
+  auto remove_sink(const SinkId id) -> bool
+  {
+    if (id >= MAX_SINKS)
+    {
+      return false;
+    }
+
+    const std::lock_guard lock(g_sinks_mutex);
+    MutRef<SinkSlot> slot = g_sinks[id];
+    if (slot.handler.exchange(nullptr, std::memory_order_seq_cst) == nullptr)
+    {
+      return false;
+    }
+
+    // Holding the mutex keeps the slot from being reused while calls already inside the handler finish
+    while (slot.in_flight.load(std::memory_order_acquire) != 0)
+    {
+      std::this_thread::yield();
+    }
+    return true;
+  }
+
+  auto set_sink_level(const SinkId id, Level min_level) -> bool
+  {
+    if (id >= MAX_SINKS)
+    {
+      return false;
+    }
+
+    const std::lock_guard lock(g_sinks_mutex);
+    if (g_sinks[id].handler.load(std::memory_order_relaxed) == nullptr)
+    {
+      return false;
+    }
+
+    g_sinks[id].min_level.store(min_level, std::memory_order_relaxed);
+    return true;
+  }
+
+  auto set_record_sink(RecordSink sink, void *user_data) -> void
+  {
+    g_record_sink.store(sink);
+    g_record_sink_user_data.store(sink ? user_data : nullptr);
+  }
+
+  auto register_call_site(Ref<CallSiteInfo> info, Span<const ArgType> arg_types) -> Ref<CallSite>
+  {
+    MutRef<CallSiteRegistry> registry = get_call_site_registry();
+    const std::lock_guard lock(registry.mutex);
+
+    auto call_site = std::make_unique<CallSite>();
+    call_site->id = static_cast<u32>(registry.call_sites.size() + 1);
+    call_site->level = info.level;
+    call_site->format = info.format;
+    call_site->file = get_basename(info.location.file_name());
+    call_site->line = info.location.line();
+    call_site->arg_types = arg_types;
+
+    registry.call_sites.push_back(std::move(call_site));
+    return *registry.call_sites.back();
+  }
+
+  auto get_call_site(const u32 id) -> const CallSite *
+  {
+    MutRef<CallSiteRegistry> registry = get_call_site_registry();
+    const std::lock_guard lock(registry.mutex);
+
+    if (id == 0 || id > registry.call_sites.size())
+    {
+      return nullptr;
+    }
+    return registry.call_sites[id - 1].get();
+  }
+
+  auto format_encoded(StringView format, Span<const ArgType> arg_types, Span<const u8> args) -> Result<String>
+  {
+    Mut<Vec<DecodedArg>> decoded;
+    const auto decode_result = decode_args(arg_types, args, decoded);
+    if (!decode_result)
+    {
+      return fail("{}", decode_result.error());
+    }
+
+    Mut<String> out;
+    Mut<String> field_format;
+    Mut<usize> next_arg = 0;
+
+    for (Mut<usize> i = 0; i < format.size(); i++)
+    {
+      const char c = format[i];
+      if ((c == '{' || c == '}') && i + 1 < format.size() && format[i + 1] == c)
+      {
+        out += c;
+        i++;
+        continue;
+      }
+      if (c == '}')
+      {
+        return fail("Unmatched '}}' at offset {}", i);
+      }
+      if (c != '{')
+      {
+        out += c;
+        continue;
+      }
+
+      const usize end = format.find('}', i);
+      if (end == StringView::npos)
+      {
+        return fail("Unterminated replacement field at offset {}", i);
+      }
+
+      const StringView field = format.substr(i + 1, end - i - 1);
+      const usize colon = field.find(':');
+      const StringView index_text = field.substr(0, colon);
+      const StringView spec = colon == StringView::npos ? StringView{} : field.substr(colon);
+
+      if (spec.find('{') != StringView::npos)
+      {
+        return fail("Nested replacement fields are not supported in deferred formats");
+      }
+
+      Mut<usize> arg_index = next_arg++;
+      if (!index_text.empty())
+      {
+        arg_index = 0;
+        for (const char digit : index_text)
+        {
+          if (digit < '0' || digit > '9')
+          {
+            return fail("Invalid argument index '{}'", index_text);
+          }
+          arg_index = arg_index * 10 + static_cast<usize>(digit - '0');
+        }
+      }
+
+      if (arg_index >= decoded.size())
+      {
+        return fail("Format references argument {} but the record has {}", arg_index, decoded.size());
+      }
+
+      field_format = "{";
+      field_format += spec;
+      field_format += "}";
+      format_arg(decoded[arg_index], field_format, out);
+
+      i = end;
+    }
+
+    return out;
+  }
+
+  auto begin_deferred(Ref<CallSite> call_site, const usize args_size) -> Option<Span<u8>>
+  {
+    if (g_async_active.load(std::memory_order_acquire))
+    {
+      ThreadBuffer *buffer = get_thread_buffer();
+      if (buffer != nullptr && begin_write(*buffer))
+      {
+        t_deferred_buffer = buffer;
+
+        const RecordHeader header{get_timestamp_ns(), call_site.file, &call_site, call_site.line, call_site.level};
+        const auto body = reserve_record(*buffer, header, args_size);
+        if (!body)
+        {
+          // No end_deferred() follows a dropped record
+          end_write(*buffer);
+        }
+        return body;
+      }
+    }
+
+    t_deferred_buffer = nullptr;
+    t_deferred_scratch.resize(args_size);
+    return Span<u8>(t_deferred_scratch);
+  }
+
+  auto end_deferred(Ref<CallSite> call_site) -> void
+  {
+    if (t_deferred_buffer != nullptr)
+    {
+      t_deferred_buffer->producer.commit();
+      end_write(*t_deferred_buffer);
+      return;
+    }
+
+    emit_deferred(call_site, get_timestamp_ns(), t_deferred_scratch);
+  }
+
+  auto start_async(Ref<AsyncOptions> options) -> Result<void>
+  {
+    if (options.buffer_size < MIN_ASYNC_BUFFER_SIZE)
+    {
+      return fail("Async log buffers must be at least {} bytes, got {}", MIN_ASYNC_BUFFER_SIZE, options.buffer_size);
+    }
+
+    const std::lock_guard lock(g_async.mutex);
+    if (g_async_active.load(std::memory_order_relaxed) || g_async.worker.joinable())
+    {
+      return fail("Async logging is already running");
+    }
+
+    g_async.options = options;
+    g_async.stop_requested = false;
+    g_overflow_policy.store(options.overflow_policy, std::memory_order_relaxed);
+    g_async_generation.fetch_add(1, std::memory_order_release);
+
+    g_async.worker = std::thread(run_async_worker);
+    g_async_active.store(true, std::memory_order_release);
+
+    return {};
+  }
+
+  auto flush() -> void
+  {
+    Mut<std::unique_lock<std::mutex>> lock(g_async.mutex);
+    if (!g_async_active.load(std::memory_order_relaxed))
+    {
+      return;
+    }
+
+    const u64 target = ++g_async.flush_requested;
+    g_async.wake.notify_one();
+    g_async.drained.wait(lock, [target] { return g_async.flush_completed >= target; });
+  }
+
+  auto stop_async() -> void
+  {
+    Mut<Vec<std::shared_ptr<ThreadBuffer>>> buffers;
+    {
+      const std::lock_guard lock(g_async.mutex);
+      if (!g_async_active.load(std::memory_order_relaxed))
+      {
+        return;
+      }
+
+      g_async_active.store(false, std::memory_order_seq_cst);
+      buffers = g_async.buffers;
+    }
+
+    // Threads that saw async mode still running commit their record before the worker's last pass. The worker
+    // keeps draining meanwhile, so a blocked writer gets room (or sees the stop and drops).
+    for (Ref<std::shared_ptr<ThreadBuffer>> buffer : buffers)
+    {
+      while (buffer->writing.load(std::memory_order_acquire))
+      {
+        std::this_thread::yield();
+      }
+    }
+    buffers.clear();
+
+    {
+      const std::lock_guard lock(g_async.mutex);
+      g_async.stop_requested = true;
+      g_async.wake.notify_one();
+    }
+
+    // The worker makes one last pass before it exits
+    g_async.worker.join();
+
+    const std::lock_guard lock(g_async.mutex);
+    g_async.buffers.clear();
+  }
+
+  auto is_async() -> bool
+  {
+    return g_async_active.load(std::memory_order_acquire);
+  }
+
+  auto get_dropped_count() -> u64
+  {
+    return g_dropped_count.load(std::memory_order_relaxed);
+  }
+
+  auto dispatch(Level level, StringView message, Ref<Site> site) -> void
+  {
+    if (g_async_active.load(std::memory_order_acquire) && enqueue(level, message, site))
+    {
+      return;
+    }
+
+    emit(level, message, site.file, site.line);
+  }
+
   auto dispatch(Level level, StringView message, Ref<std::source_location> loc) -> void
   {
-    const auto handler = g_active_handler.load(std::memory_order_relaxed);
-    if (handler)
-      handler(g_active_handler_user_data.load(), level, message, loc.file_name(), loc.line());
+    dispatch(level, message, Site{get_basename(loc.file_name()), loc.line()});
   }
 } // namespace ia::logger
\ No newline at end of file
@@ -0,0 +1,561 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <crux/shared_memory.hpp>
+
+#include <cerrno>
+#include <cstring>
+
+#if IA_PLATFORM_WINDOWS
+#  include <Windows.h>
+#elif IA_PLATFORM_UNIX
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace ia::shm
+{
+  auto close_native_handle(NativeHandle handle) -> void
+  {
+#if IA_PLATFORM_WINDOWS
+    CloseHandle(handle);
+#elif IA_PLATFORM_UNIX
+    close(handle);
+#else
+    AU_UNUSED(handle);
+#endif
+  }
+} // namespace ia::shm
+
+namespace ia
+{
+  namespace
+  {
+    constexpr const usize HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    auto get_page_size(Ref<SharedMemory::Options> options) -> usize
+    {
+      if (options.huge_pages)
+      {
+        return HUGE_PAGE_SIZE;
+      }
+
+#if IA_PLATFORM_WINDOWS
+      Mut<SYSTEM_INFO> info{};
+      GetSystemInfo(&info);
+      return static_cast<usize>(info.dwAllocationGranularity);
+#elif IA_PLATFORM_UNIX
+      return static_cast<usize>(sysconf(_SC_PAGESIZE));
+#else
+      return 4096;
+#endif
+    }
+
+    auto round_up(const usize value, const usize alignment) -> usize
+    {
+      return (value + alignment - 1) / alignment * alignment;
+    }
+
+    auto validate_options(Ref<SharedMemory::Options> options) -> Result<void>
+    {
+      if (options.mirrored)
+      {
+#if !IA_PLATFORM_LINUX
+        return fail("Mirrored mappings are only supported on Linux");
+#endif
+        if (options.huge_pages)
+        {
+          return fail("Mirrored mappings cannot use huge pages");
+        }
+      }
+      return {};
+    }
+
+#if IA_PLATFORM_UNIX
+    auto get_segment_path(Ref<String> name, Ref<SharedMemory::Options> options) -> String
+    {
+      if (options.huge_pages)
+      {
+        return "/dev/hugepages/" + name;
+      }
+      return "/" + name;
+    }
+
+    auto open_segment(Ref<String> name, const i32 open_flags, Ref<SharedMemory::Options> options) -> shm::NativeHandle
+    {
+      const String path = get_segment_path(name, options);
+
+      if (options.huge_pages)
+      {
+        return ::open(path.c_str(), open_flags, 0600);
+      }
+      return shm_open(path.c_str(), open_flags, 0600);
+    }
+
+    auto get_map_flags(Ref<SharedMemory::Options> options) -> i32
+    {
+      Mut<i32> map_flags = MAP_SHARED;
+#  ifdef MAP_POPULATE
+      if (options.populate)
+      {
+        map_flags |= MAP_POPULATE;
+      }
+#  else
+      AU_UNUSED(options);
+#  endif
+      return map_flags;
+    }
+
+    // Prefaults (where MAP_POPULATE is missing) and locks a fresh mapping. Unmaps it on failure.
+    auto prepare_mapping(u8 *base, const usize size, const bool is_new, Ref<SharedMemory::Options> options)
+        -> Result<void>
+    {
+#  ifndef MAP_POPULATE
+      if (options.populate)
+      {
+        // No MAP_POPULATE, touch every page by hand (writing is only safe on a fresh segment)
+        const usize page_size = get_page_size(options);
+        for (Mut<usize> offset = 0; offset < size; offset += page_size)
+        {
+          if (is_new)
+          {
+            static_cast<volatile u8 *>(base)[offset] = 0;
+          }
+          else
+          {
+            (void) static_cast<volatile const u8 *>(base)[offset];
+          }
+        }
+      }
+#  else
+      AU_UNUSED(is_new);
+#  endif
+
+      if (options.lock && mlock(base, size) != 0)
+      {
+        const i32 error = errno;
+        munmap(base, size);
+        return fail("mlock failed: {}", std::strerror(error));
+      }
+
+      return {};
+    }
+
+    auto map_segment(const shm::NativeHandle fd, const usize size, const bool is_new,
+                     Ref<SharedMemory::Options> options) -> Result<u8 *>
+    {
+      void *const base = mmap(nullptr, size, PROT_READ | PROT_WRITE, get_map_flags(options), fd, 0);
+      if (base == MAP_FAILED)
+      {
+        return fail("mmap failed: {}", std::strerror(errno));
+      }
+
+      auto prepared = prepare_mapping(static_cast<u8 *>(base), size, is_new, options);
+      if (!prepared)
+      {
+        return fail("{}", prepared.error());
+      }
+
+      return static_cast<u8 *>(base);
+    }
+
+#  if IA_PLATFORM_LINUX
+    // Maps [header | data | data]: the file's data pages show up a second time right behind the first copy
+    auto map_mirrored_segment(const shm::NativeHandle fd, const usize data_offset, const usize data_size,
+                              const bool is_new, Ref<SharedMemory::Options> options) -> Result<u8 *>
+    {
+      const usize size = data_offset + 2 * data_size;
+
+      // Reserve the whole range first so both views land next to each other
+      void *const reserved = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (reserved == MAP_FAILED)
+      {
+        return fail("mmap failed: {}", std::strerror(errno));
+      }
+
+      u8 *const base = static_cast<u8 *>(reserved);
+      const i32 map_flags = get_map_flags(options) | MAP_FIXED;
+
+      if (mmap(base, data_offset + data_size, PROT_READ | PROT_WRITE, map_flags, fd, 0) == MAP_FAILED ||
+          mmap(base + data_offset + data_size, data_size, PROT_READ | PROT_WRITE, map_flags, fd,
+               static_cast<off_t>(data_offset)) == MAP_FAILED)
+      {
+        const i32 error = errno;
+        munmap(base, size);
+        return fail("mmap failed: {}", std::strerror(error));
+      }
+
+      auto prepared = prepare_mapping(base, size, is_new, options);
+      if (!prepared)
+      {
+        return fail("{}", prepared.error());
+      }
+
+      return base;
+    }
+#  endif
+
+    auto map_segment(const shm::NativeHandle fd, const usize file_size, const usize data_offset, const bool is_new,
+                     Ref<SharedMemory::Options> options) -> Result<u8 *>
+    {
+#  if IA_PLATFORM_LINUX
+      if (options.mirrored)
+      {
+        return map_mirrored_segment(fd, data_offset, file_size - data_offset, is_new, options);
+      }
+#  else
+      AU_UNUSED(data_offset);
+#  endif
+      return map_segment(fd, file_size, is_new, options);
+    }
+#endif
+
+#if IA_PLATFORM_WINDOWS
+    auto map_segment(const shm::NativeHandle handle, const usize size, Ref<SharedMemory::Options> options)
+        -> Result<u8 *>
+    {
+      const DWORD access = FILE_MAP_ALL_ACCESS | (options.huge_pages ? FILE_MAP_LARGE_PAGES : 0);
+
+      void *const base = MapViewOfFile(handle, access, 0, 0, size);
+      if (base == nullptr)
+      {
+        return fail("MapViewOfFile failed: {}", GetLastError());
+      }
+
+      if (options.populate)
+      {
+        Mut<WIN32_MEMORY_RANGE_ENTRY> range{};
+        range.VirtualAddress = base;
+        range.NumberOfBytes = size;
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+      }
+
+      if (options.lock && !VirtualLock(base, size))
+      {
+        const DWORD error = GetLastError();
+        UnmapViewOfFile(base);
+        return fail("VirtualLock failed: {}", error);
+      }
+
+      return static_cast<u8 *>(base);
+    }
+#endif
+  } // namespace
+
+  SharedMemory::~SharedMemory()
+  {
+    unmap();
+  }
+
+  SharedMemory::SharedMemory(SharedMemory &&other)
+      : m_handle(std::move(other.m_handle)), m_base(std::exchange(other.m_base, nullptr)),
+        m_mapped_size(std::exchange(other.m_mapped_size, 0)), m_mirrored(std::exchange(other.m_mirrored, false))
+  {
+  }
+
+  SharedMemory &SharedMemory::operator=(SharedMemory &&other)
+  {
+    if (this != &other)
+    {
+      unmap();
+      m_handle = std::move(other.m_handle);
+      m_base = std::exchange(other.m_base, nullptr);
+      m_mapped_size = std::exchange(other.m_mapped_size, 0);
+      m_mirrored = std::exchange(other.m_mirrored, false);
+    }
+    return *this;
+  }
+
+  auto SharedMemory::create(Ref<String> name, const usize data_size, Ref<Options> options) -> Result<SharedMemory>
+  {
+    if (name.empty())
+    {
+      return fail("Shared memory name cannot be empty");
+    }
+
+    auto options_valid = validate_options(options);
+    if (!options_valid)
+    {
+      return fail("{}", options_valid.error());
+    }
+
+    const usize page_size = get_page_size(options);
+
+    // Plain segments keep the data right behind the header. Mirrored ones start it on a page boundary
+    // (mmap offsets must be page aligned), and the ring's ControlBlock shares the header page.
+    Mut<usize> data_offset = sizeof(SegmentHeader);
+    Mut<usize> total_size = round_up(sizeof(SegmentHeader) + data_size, page_size);
+    if (options.mirrored)
+    {
+      data_offset = round_up(sizeof(SegmentHeader) + sizeof(RingBufferView::ControlBlock), page_size);
+      total_size = data_offset + round_up(data_size, page_size);
+    }
+
+    Mut<SharedMemory> segment;
+
+#if IA_PLATFORM_WINDOWS
+    const DWORD protect = PAGE_READWRITE | (options.huge_pages ? (SEC_COMMIT | SEC_LARGE_PAGES) : 0);
+    *segment.m_handle.ptr() =
+        CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, protect,
+                           static_cast<DWORD>(static_cast<u64>(total_size) >> 32),
+                           static_cast<DWORD>(total_size & 0xFFFFFFFF), name.c_str());
+    if (segment.m_handle == shm::INVALID_NATIVE_HANDLE)
+    {
+      return fail("Failed to create shared memory segment '{}': {}", name, GetLastError());
+    }
+    if (GetLastError() == ERROR_ALREADY_EXISTS)
+    {
+      return fail("Shared memory segment '{}' already exists", name);
+    }
+
+    auto base = map_segment(segment.m_handle, total_size, options);
+#elif IA_PLATFORM_UNIX
+    *segment.m_handle.ptr() = open_segment(name, O_CREAT | O_EXCL | O_RDWR, options);
+    if (segment.m_handle == shm::INVALID_NATIVE_HANDLE)
+    {
+      return fail("Failed to create shared memory segment '{}': {}", name, std::strerror(errno));
+    }
+
+    if (ftruncate(segment.m_handle, static_cast<off_t>(total_size)) != 0)
+    {
+      const i32 error = errno;
+      (void) unlink(name, options);
+      return fail("Failed to resize shared memory segment '{}': {}", name, std::strerror(error));
+    }
+
+    auto base = map_segment(segment.m_handle, total_size, data_offset, true, options);
+    if (!base)
+    {
+      (void) unlink(name, options);
+    }
+#else
+    AU_UNUSED(data_offset);
+    AU_UNUSED(total_size);
+    AU_UNUSED(segment);
+    return fail("Shared memory is not supported on this platform");
+#endif
+
+#if IA_PLATFORM_WINDOWS || IA_PLATFORM_UNIX
+    if (!base)
+    {
+      return fail("Failed to map shared memory segment '{}': {}", name, base.error());
+    }
+
+    segment.m_base = *base;
+    segment.m_mirrored = options.mirrored;
+    segment.m_mapped_size = options.mirrored ? 2 * total_size - data_offset : total_size;
+
+    Mut<SegmentHeader *> header = segment.get_header();
+    header->version = SEGMENT_VERSION;
+    header->data_size = total_size - data_offset;
+    header->data_offset = data_offset;
+    header->flags = options.mirrored ? SEGMENT_FLAG_MIRRORED : 0;
+    header->magic.store(SEGMENT_MAGIC, std::memory_order_release);
+
+    return segment;
+#endif
+  }
+
+  auto SharedMemory::open(Ref<String> name, Ref<Options> options) -> Result<SharedMemory>
+  {
+    if (name.empty())
+    {
+      return fail("Shared memory name cannot be empty");
+    }
+
+    auto options_valid = validate_options(options);
+    if (!options_valid)
+    {
+      return fail("{}", options_valid.error());
+    }
+
+    Mut<SharedMemory> segment;
+
+#if IA_PLATFORM_WINDOWS
+    *segment.m_handle.ptr() = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+    if (segment.m_handle == shm::INVALID_NATIVE_HANDLE)
+    {
+      return fail("Failed to open shared memory segment '{}': {}", name, GetLastError());
+    }
+
+    // Map the whole section, its size is only known once it is mapped
+    auto base = map_segment(segment.m_handle, 0, options);
+    if (!base)
+    {
+      return fail("Failed to map shared memory segment '{}': {}", name, base.error());
+    }
+
+    Mut<MEMORY_BASIC_INFORMATION> info{};
+    VirtualQuery(*base, &info, sizeof(info));
+
+    segment.m_base = *base;
+    segment.m_mapped_size = static_cast<usize>(info.RegionSize);
+#elif IA_PLATFORM_UNIX
+    *segment.m_handle.ptr() = open_segment(name, O_RDWR, options);
+    if (segment.m_handle == shm::INVALID_NATIVE_HANDLE)
+    {
+      return fail("Failed to open shared memory segment '{}': {}", name, std::strerror(errno));
+    }
+
+    Mut<struct stat> st{};
+    if (fstat(segment.m_handle, &st) != 0)
+    {
+      return fail("Failed to stat shared memory segment '{}': {}", name, std::strerror(errno));
+    }
+
+    const usize total_size = static_cast<usize>(st.st_size);
+    if (total_size < sizeof(SegmentHeader))
+    {
+      return fail("Shared memory segment '{}' is not initialized", name);
+    }
+
+    // The layout is only known once the header is readable, a mirrored mapping is set up after validation
+    auto base = map_segment(segment.m_handle, total_size, false, options.mirrored ? Options{} : options);
+    if (!base)
+    {
+      return fail("Failed to map shared memory segment '{}': {}", name, base.error());
+    }
+
+    segment.m_base = *base;
+    segment.m_mapped_size = total_size;
+#else
+    AU_UNUSED(options);
+    AU_UNUSED(segment);
+    return fail("Shared memory is not supported on this platform");
+#endif
+
+#if IA_PLATFORM_WINDOWS || IA_PLATFORM_UNIX
+    const SegmentHeader *header = segment.get_header();
+
+    if (header->magic.load(std::memory_order_acquire) != SEGMENT_MAGIC)
+    {
+      return fail("Shared memory segment '{}' is not an IACrux segment (or not initialized yet)", name);
+    }
+    if (header->version != SEGMENT_VERSION)
+    {
+      return fail("Shared memory segment '{}' version mismatch: expected {}, found {}", name, SEGMENT_VERSION,
+                  header->version);
+    }
+    if (header->data_offset < sizeof(SegmentHeader) || header->data_offset + header->data_size > segment.m_mapped_size)
+    {
+      return fail("Shared memory segment '{}' is truncated", name);
+    }
+
+    if (options.mirrored)
+    {
+      if ((header->flags & SEGMENT_FLAG_MIRRORED) == 0)
+      {
+        return fail("Shared memory segment '{}' was not created mirrored", name);
+      }
+
+#  if IA_PLATFORM_LINUX
+      const usize data_offset = header->data_offset;
+      const usize data_size = header->data_size;
+
+      segment.unmap();
+
+      auto mirrored_base = map_mirrored_segment(segment.m_handle, data_offset, data_size, false, options);
+      if (!mirrored_base)
+      {
+        return fail("Failed to map shared memory segment '{}': {}", name, mirrored_base.error());
+      }
+
+      segment.m_base = *mirrored_base;
+      segment.m_mapped_size = data_offset + 2 * data_size;
+      segment.m_mirrored = true;
+#  endif
+    }
+
+    return segment;
+#endif
+  }
+
+  auto SharedMemory::unlink(Ref<String> name, Ref<Options> options) -> Result<void>
+  {
+#if IA_PLATFORM_UNIX
+    const String path = get_segment_path(name, options);
+    const i32 result = options.huge_pages ? ::unlink(path.c_str()) : shm_unlink(path.c_str());
+    if (result != 0)
+    {
+      return fail("Failed to unlink shared memory segment '{}': {}", name, std::strerror(errno));
+    }
+#else
+    AU_UNUSED(name);
+    AU_UNUSED(options);
+#endif
+    return {};
+  }
+
+  auto SharedMemory::create_ring_buffer(const bool is_owner, const u32 flags) -> Result<RingBufferView>
+  {
+    if (!is_valid())
+    {
+      return fail("Shared memory segment is not mapped");
+    }
+
+    if (get_header()->flags & SEGMENT_FLAG_MIRRORED)
+    {
+      auto *control_block = reinterpret_cast<RingBufferView::ControlBlock *>(m_base + sizeof(SegmentHeader));
+      if (m_mirrored)
+      {
+        return RingBufferView::create_mirrored(control_block, get_data(), is_owner, flags);
+      }
+      return RingBufferView::create(control_block, get_data(), is_owner, flags);
+    }
+
+    return RingBufferView::create(get_data(), is_owner, flags);
+  }
+
+  auto SharedMemory::get_data() -> Span<u8>
+  {
+    if (!is_valid())
+    {
+      return {};
+    }
+
+    const SegmentHeader *header = get_header();
+    return Span<u8>(m_base + header->data_offset, header->data_size);
+  }
+
+  auto SharedMemory::get_header() -> SegmentHeader *
+  {
+    return reinterpret_cast<SegmentHeader *>(m_base);
+  }
+
+  [[nodiscard]] auto SharedMemory::is_valid() const -> bool
+  {
+    return m_base != nullptr;
+  }
+
+  auto SharedMemory::unmap() -> void
+  {
+    if (m_base == nullptr)
+    {
+      return;
+    }
+
+#if IA_PLATFORM_WINDOWS
+    UnmapViewOfFile(m_base);
+#elif IA_PLATFORM_UNIX
+    munmap(m_base, m_mapped_size);
+#endif
+
+    m_base = nullptr;
+    m_mapped_size = 0;
+    m_mirrored = false;
+  }
+} // namespace ia
@@ -13,6 +13,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <crux/platform.hpp>
 #include <crux/utils.hpp>
 
 #include <thread>
@@ -25,6 +26,14 @@
 #  include <arm_acle.h>
 #endif
 
+#if IA_PLATFORM_LINUX
+#  include <climits>
+#  include <ctime>
+#  include <linux/futex.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
 namespace ia::utils
 {
   namespace
@@ -159,6 +168,59 @@ namespace ia::utils
 #endif
     return crc32_software_slice8(data);
   }
+
+#if IA_ARCH_X64
+  inline auto copy_non_temporal_avx2(u8 *dst, const u8 *src, usize size) -> void
+  {
+    // Streaming stores need an aligned destination, copy the head normally
+    const usize head = std::min<usize>((32 - reinterpret_cast<usize>(dst) % 32) % 32, size);
+    std::memcpy(dst, src, head);
+    dst += head;
+    src += head;
+    size -= head;
+
+    while (size >= 128)
+    {
+      const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+      const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 32));
+      const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 64));
+      const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 96));
+      _mm256_stream_si256(reinterpret_cast<__m256i *>(dst), a);
+      _mm256_stream_si256(reinterpret_cast<__m256i *>(dst + 32), b);
+      _mm256_stream_si256(reinterpret_cast<__m256i *>(dst + 64), c);
+      _mm256_stream_si256(reinterpret_cast<__m256i *>(dst + 96), d);
+      dst += 128;
+      src += 128;
+      size -= 128;
+    }
+
+    while (size >= 32)
+    {
+      _mm256_stream_si256(reinterpret_cast<__m256i *>(dst),
+                          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src)));
+      dst += 32;
+      src += 32;
+      size -= 32;
+    }
+
+    std::memcpy(dst, src, size);
+
+    // Streaming stores are weakly ordered, make them visible before any later release store
+    _mm_sfence();
+  }
+#endif
+
+  auto copy_non_temporal(void *dst, const void *src, const usize size) -> void
+  {
+#if IA_ARCH_X64
+    if (platform::get_capabilities().has_avx2)
+    {
+      copy_non_temporal_avx2(static_cast<u8 *>(dst), static_cast<const u8 *>(src), size);
+      return;
+    }
+#endif
+    std::memcpy(dst, src, size);
+  }
 } // namespace ia::utils
 
 namespace ia::utils
@@ -333,6 +395,42 @@ namespace ia::utils
     std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
   }
 
+  auto spin_pause() -> void
+  {
+#if IA_ARCH_X64
+    _mm_pause();
+#elif IA_ARCH_ARM64
+    __yield();
+#else
+    std::this_thread::yield();
+#endif
+  }
+
+  auto wait_on_address(MutRef<std::atomic<u32>> word, const u32 expected, const u64 timeout_us) -> void
+  {
+#if IA_PLATFORM_LINUX
+    // No FUTEX_PRIVATE_FLAG: the word may be shared with other processes
+    Mut<timespec> timeout{};
+    timeout.tv_sec = static_cast<time_t>(timeout_us / 1000000);
+    timeout.tv_nsec = static_cast<long>((timeout_us % 1000000) * 1000);
+    syscall(SYS_futex, reinterpret_cast<u32 *>(&word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+#else
+    if (word.load(std::memory_order_acquire) == expected)
+    {
+      std::this_thread::sleep_for(std::chrono::microseconds(std::min<u64>(timeout_us, 1000)));
+    }
+#endif
+  }
+
+  auto wake_by_address(MutRef<std::atomic<u32>> word) -> void
+  {
+#if IA_PLATFORM_LINUX
+    syscall(SYS_futex, reinterpret_cast<u32 *>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#else
+    AU_UNUSED(word);
+#endif
+  }
+
   auto binary_to_hex_string(const Span<const u8> data) -> String
   {
     static constexpr const char LUT[17] = "0123456789ABCDEF";
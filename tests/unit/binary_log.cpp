@@ -0,0 +1,155 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <crux/binary_log.hpp>
+#include <iatest/iatest.hpp>
+
+#include <cstdio>
+
+#if IA_PLATFORM_UNIX
+#  include <unistd.h>
+#endif
+
+using namespace ia;
+
+IAT_BEGIN_BLOCK(Core, BinaryLog)
+
+#if IA_PLATFORM_UNIX
+static auto get_test_prefix(Ref<String> name) -> String
+{
+  return std::format("/tmp/iacrux_test_binlog_{}_{}", name, getpid());
+}
+
+static auto remove_log(Ref<String> prefix) -> void
+{
+  for (Mut<u32> i = 0; std::remove(journal::get_segment_path(prefix, i).c_str()) == 0; i++)
+  {
+  }
+}
+
+auto test_write_read() -> bool
+{
+  const String prefix = get_test_prefix("write_read");
+
+  auto writer = BinaryLogWriter::create(prefix);
+  IAT_CHECK(writer.has_value());
+
+  logger::set_record_sink(BinaryLogWriter::sink, &*writer);
+  IAT_CHECK(logger::start_async().has_value());
+
+  for (Mut<i32> i = 0; i < 50; i++)
+  {
+    IA_LOG_INFO_DEFERRED("tick {} at {:.1f}", i, i * 0.5);
+  }
+  IA_LOG_ERROR_DEFERRED("done with {}", "ticks");
+
+  logger::stop_async();
+  logger::set_record_sink(nullptr, nullptr);
+
+  IAT_CHECK_EQ(writer->get_failed_count(), static_cast<u64>(0));
+  writer->close();
+
+  // Decoding only needs the file: the call sites travel with it
+  auto reader = BinaryLogReader::open(prefix);
+  IAT_CHECK(reader.has_value());
+
+  auto records = reader->read_all();
+  IAT_CHECK(records.has_value());
+  IAT_CHECK_EQ(records->size(), static_cast<usize>(51));
+
+  IAT_CHECK_EQ((*records)[0].message, String("tick 0 at 0.0"));
+  IAT_CHECK_EQ((*records)[49].message, String("tick 49 at 24.5"));
+  IAT_CHECK((*records)[0].level == logger::Level::Info);
+  IAT_CHECK((*records)[0].file.ends_with("binary_log.cpp"));
+
+  IAT_CHECK_EQ(records->back().message, String("done with ticks"));
+  IAT_CHECK(records->back().level == logger::Level::Error);
+  IAT_CHECK((*records)[0].line != records->back().line);
+
+  for (Mut<usize> i = 1; i < records->size(); i++)
+  {
+    IAT_CHECK((*records)[i - 1].timestamp_ns <= (*records)[i].timestamp_ns);
+  }
+
+  remove_log(prefix);
+
+  return true;
+}
+
+auto test_call_site_limits() -> bool
+{
+  const String prefix = get_test_prefix("limits");
+
+  static constexpr const logger::ArgType ARG_TYPES[] = {logger::ArgType::Int};
+  const i64 value = 42;
+  const Span<const u8> args(reinterpret_cast<const u8 *>(&value), sizeof(value));
+
+  {
+    Mut<BinaryLogWriter> writer = std::move(*BinaryLogWriter::create(prefix));
+
+    // A format string that does not fit the call site header is refused instead of being stored truncated
+    const String long_format = "{}" + String(70000, 'x');
+    Mut<logger::CallSite> too_long{1, logger::Level::Info, long_format, "limits.cpp", 1, ARG_TYPES};
+    IAT_CHECK_NOT(writer.append(too_long, 1, args).has_value());
+
+    // Process-wide ids are renumbered densely in the file
+    Mut<logger::CallSite> site{1000, logger::Level::Warn, "value {}", "limits.cpp", 2, ARG_TYPES};
+    IAT_CHECK(writer.append(site, 2, args).has_value());
+  }
+
+  auto reader = BinaryLogReader::open(prefix);
+  IAT_CHECK(reader.has_value());
+  auto records = reader->read_all();
+  IAT_CHECK(records.has_value());
+  IAT_CHECK_EQ(records->size(), static_cast<usize>(1));
+  IAT_CHECK_EQ(records->front().message, String("value 42"));
+
+  remove_log(prefix);
+
+  // A damaged call site id is rejected rather than used to size the call site table
+  {
+    Mut<JournalWriter> journal = std::move(*JournalWriter::create(prefix));
+    const binary_log::CallSiteHeader header{0xFFFFFFF0u, 1, 0, 0, 0, 0, 0};
+    IAT_CHECK(journal
+                  .append(binary_log::PACKET_ID_CALL_SITE,
+                          Span<const u8>(reinterpret_cast<const u8 *>(&header), sizeof(header)), 1)
+                  .has_value());
+  }
+  IAT_CHECK_NOT(BinaryLogReader::open(prefix).has_value());
+
+  remove_log(prefix);
+
+  return true;
+}
+#endif
+
+auto test_missing_log() -> bool
+{
+  IAT_CHECK_NOT(BinaryLogReader::open("/tmp/iacrux_test_binlog_does_not_exist").has_value());
+
+  return true;
+}
+
+IAT_BEGIN_TEST_LIST()
+#if IA_PLATFORM_UNIX
+IAT_ADD_TEST(test_write_read);
+IAT_ADD_TEST(test_call_site_limits);
+#endif
+IAT_ADD_TEST(test_missing_log);
+IAT_END_TEST_LIST()
+
+IAT_END_BLOCK()
+
+IAT_REGISTER_ENTRY(Core, BinaryLog)
@@ -0,0 +1,197 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <crux/adt/broadcast_ring_buffer.hpp>
+#include <iatest/iatest.hpp>
+
+#include <thread>
+
+using namespace ia;
+
+IAT_BEGIN_BLOCK(Core, BroadcastRingBuffer)
+
+static constexpr const usize BUFFER_SIZE = sizeof(BroadcastRingBufferView::ControlBlock) + 64;
+
+auto test_fan_out() -> bool
+{
+  Mut<Vec<u8>> memory(BUFFER_SIZE);
+  auto rb_res = BroadcastRingBufferView::create(Span<u8>(memory), true);
+  IAT_CHECK(rb_res.has_value());
+  Mut<BroadcastRingBufferView> rb = *rb_res;
+
+  auto reader_a = rb.attach();
+  auto reader_b = rb.attach();
+  IAT_CHECK(reader_a.has_value() && reader_b.has_value());
+  IAT_CHECK_NEQ(reader_a->get_slot_index(), reader_b->get_slot_index());
+
+  // Readers become active once the producer accepts them on its next write
+  IAT_CHECK_NOT(reader_a->is_active());
+
+  const u8 payload[] = {1, 2, 3};
+  IAT_CHECK(rb.push(5, payload).has_value());
+  IAT_CHECK(reader_a->is_active());
+
+  Mut<BroadcastRingBufferView::PacketHeader> header;
+  Mut<u8> out[16] = {};
+
+  for (auto *reader : {&*reader_a, &*reader_b})
+  {
+    const auto pop_res = reader->pop(header, out);
+    IAT_CHECK(pop_res.has_value() && pop_res->has_value());
+    IAT_CHECK_EQ(header.id, static_cast<u16>(5));
+    IAT_CHECK_EQ(out[2], static_cast<u8>(3));
+
+    const auto empty_res = reader->pop(header, out);
+    IAT_CHECK(empty_res.has_value());
+    IAT_CHECK_NOT(empty_res->has_value());
+  }
+
+  return true;
+}
+
+auto test_slowest_reader_and_detach() -> bool
+{
+  Mut<Vec<u8>> memory(BUFFER_SIZE);
+  Mut<BroadcastRingBufferView> rb = *BroadcastRingBufferView::create(Span<u8>(memory), true);
+
+  auto fast = rb.attach();
+  auto slow = rb.attach();
+  IAT_CHECK(fast.has_value() && slow.has_value());
+
+  // 24 byte records, two of them fill most of the 64 byte data region
+  const u8 payload[20] = {};
+  IAT_CHECK(rb.push(1, payload).has_value());
+  IAT_CHECK(rb.push(2, payload).has_value());
+
+  IAT_CHECK_EQ(fast->consume_all([](Ref<BroadcastRingBufferView::PacketView>) {}), static_cast<usize>(2));
+
+  // The slow reader still holds both packets
+  IAT_CHECK_NOT(rb.push(3, payload).has_value());
+
+  slow->detach();
+  IAT_CHECK(rb.push(3, payload).has_value());
+
+  Mut<Vec<u16>> ids;
+  fast->consume_all([&](Ref<BroadcastRingBufferView::PacketView> packet) { ids.push_back(packet.header.id); });
+  IAT_CHECK(ids == (Vec<u16>{3}));
+
+  // A late reader only sees packets published after it was accepted
+  auto late = rb.attach();
+  IAT_CHECK(late.has_value());
+  IAT_CHECK(rb.push(4, payload).has_value());
+
+  ids.clear();
+  late->consume_all([&](Ref<BroadcastRingBufferView::PacketView> packet) { ids.push_back(packet.header.id); });
+  IAT_CHECK(ids == (Vec<u16>{4}));
+
+  return true;
+}
+
+auto test_reader_releases_slot() -> bool
+{
+  Mut<Vec<u8>> memory(BUFFER_SIZE);
+  Mut<BroadcastRingBufferView> rb = *BroadcastRingBufferView::create(Span<u8>(memory), true);
+
+  const u8 payload[20] = {};
+  Mut<u32> slot_index = 0;
+  {
+    auto attached = rb.attach();
+    IAT_CHECK(attached.has_value());
+    IAT_CHECK(rb.push(1, payload).has_value());
+
+    // Moving hands the slot over, the moved-from Reader releases nothing
+    Mut<BroadcastRingBufferView::Reader> reader = std::move(*attached);
+    slot_index = reader.get_slot_index();
+    IAT_CHECK(reader.is_active());
+    IAT_CHECK_EQ(rb.get_control_block()->consumers[slot_index].state.load(),
+                 BroadcastRingBufferView::SLOT_STATE_ACTIVE);
+
+    IAT_CHECK(rb.push(2, payload).has_value());
+    IAT_CHECK_NOT(rb.push(3, payload).has_value());
+  }
+
+  // The dropped Reader no longer pins the producer
+  IAT_CHECK_EQ(rb.get_control_block()->consumers[slot_index].state.load(), BroadcastRingBufferView::SLOT_STATE_FREE);
+  IAT_CHECK(rb.push(3, payload).has_value());
+  IAT_CHECK_NOT(rb.push(BroadcastRingBufferView::PACKET_ID_SKIP, payload).has_value());
+
+  return true;
+}
+
+auto test_concurrent_readers() -> bool
+{
+  static constexpr const u32 READER_COUNT = 3;
+  static constexpr const u32 PACKET_COUNT = 20000;
+
+  Mut<Vec<u8>> memory(sizeof(BroadcastRingBufferView::ControlBlock) + 1024);
+  Mut<BroadcastRingBufferView> rb = *BroadcastRingBufferView::create(Span<u8>(memory), true);
+
+  Mut<Vec<BroadcastRingBufferView::Reader>> readers;
+  for (Mut<u32> i = 0; i < READER_COUNT; i++)
+  {
+    readers.push_back(*rb.attach());
+  }
+
+  Mut<std::atomic<u32>> failures{0};
+  Mut<Vec<std::thread>> threads;
+
+  for (auto &reader : readers)
+  {
+    threads.emplace_back([&reader, &failures]() {
+      Mut<u32> expected = 0;
+      while (expected < PACKET_COUNT)
+      {
+        reader.consume_all([&](Ref<BroadcastRingBufferView::PacketView> packet) {
+          Mut<u32> value = 0;
+          std::memcpy(&value, packet.first.data(), sizeof(value));
+          if (value != expected)
+          {
+            failures.fetch_add(1);
+          }
+          expected++;
+        });
+      }
+    });
+  }
+
+  for (Mut<u32> i = 0; i < PACKET_COUNT;)
+  {
+    const auto data = Span<const u8>(reinterpret_cast<const u8 *>(&i), sizeof(i));
+    if (rb.push(1, data).has_value())
+    {
+      i++;
+    }
+  }
+
+  for (auto &t : threads)
+  {
+    t.join();
+  }
+
+  IAT_CHECK_EQ(failures.load(), static_cast<u32>(0));
+
+  return true;
+}
+
+IAT_BEGIN_TEST_LIST()
+IAT_ADD_TEST(test_fan_out);
+IAT_ADD_TEST(test_slowest_reader_and_detach);
+IAT_ADD_TEST(test_reader_releases_slot);
+IAT_ADD_TEST(test_concurrent_readers);
+IAT_END_TEST_LIST()
+
+IAT_END_BLOCK()
+
+IAT_REGISTER_ENTRY(Core, BroadcastRingBuffer)
@@ -0,0 +1,193 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <crux/adt/channel.hpp>
+#include <iatest/iatest.hpp>
+
+#include <thread>
+
+using namespace ia;
+
+IAT_BEGIN_BLOCK(Core, Channel)
+
+struct Ping
+{
+  Mut<u32> sequence{};
+};
+
+struct alignas(8) Position
+{
+  Mut<f64> x{};
+  Mut<f64> y{};
+  Mut<u8> layer{};
+};
+
+struct alignas(16) Transform
+{
+  Mut<f32> m[16]{};
+};
+
+using TestChannel = Channel<Ping, Position, Transform>;
+
+static constexpr const usize BUFFER_SIZE = sizeof(RingBufferView::ControlBlock) + 1024;
+
+struct Counter
+{
+  Mut<u32> pings = 0;
+  Mut<u32> positions = 0;
+  Mut<u32> transforms = 0;
+  Mut<u32> last_sequence = 0;
+  Mut<bool> aligned = true;
+
+  auto operator()(Ref<Ping> ping) -> void
+  {
+    pings++;
+    last_sequence = ping.sequence;
+    aligned = aligned && reinterpret_cast<usize>(&ping) % alignof(Ping) == 0;
+  }
+
+  auto operator()(Ref<Position> position) -> void
+  {
+    positions++;
+    aligned = aligned && reinterpret_cast<usize>(&position) % alignof(Position) == 0 && position.x == 1.5 &&
+              position.layer == 3;
+  }
+
+  auto operator()(Ref<Transform> transform) -> void
+  {
+    transforms++;
+    aligned = aligned && reinterpret_cast<usize>(&transform) % alignof(Transform) == 0 && transform.m[15] == 2.0f;
+  }
+};
+
+auto test_ids() -> bool
+{
+  IAT_CHECK_EQ(TestChannel::get_id<Ping>(), static_cast<u16>(1));
+  IAT_CHECK_EQ(TestChannel::get_id<Position>(), static_cast<u16>(2));
+  IAT_CHECK_EQ(TestChannel::get_id<Transform>(), static_cast<u16>(3));
+
+  return true;
+}
+
+auto test_dispatch() -> bool
+{
+  Mut<Vec<u8>> memory(BUFFER_SIZE);
+  Mut<RingBufferView> rb = *RingBufferView::create(Span<u8>(memory), true);
+  auto channel_res = TestChannel::create(rb);
+  IAT_CHECK(channel_res.has_value());
+  Mut<TestChannel> channel = *channel_res;
+
+  Mut<Counter> counter;
+
+  // Enough rounds to wrap the ring several times, so alignment is checked across skip records
+  for (Mut<u32> round = 0; round < 50; round++)
+  {
+    IAT_CHECK(channel.push(Ping{round}).has_value());
+    IAT_CHECK(channel.emplace<Position>(1.5, 2.5, static_cast<u8>(3)).has_value());
+
+    Mut<Transform> transform{};
+    transform.m[15] = 2.0f;
+    IAT_CHECK(channel.push(transform).has_value());
+
+    IAT_CHECK_EQ(channel.dispatch(counter), static_cast<usize>(3));
+  }
+
+  IAT_CHECK_EQ(counter.pings, static_cast<u32>(50));
+  IAT_CHECK_EQ(counter.positions, static_cast<u32>(50));
+  IAT_CHECK_EQ(counter.transforms, static_cast<u32>(50));
+  IAT_CHECK_EQ(counter.last_sequence, static_cast<u32>(49));
+  IAT_CHECK(counter.aligned);
+
+  return true;
+}
+
+auto test_unknown_ids_skipped() -> bool
+{
+  Mut<Vec<u8>> memory(BUFFER_SIZE);
+  Mut<RingBufferView> rb = *RingBufferView::create(Span<u8>(memory), true);
+  Mut<TestChannel> channel = *TestChannel::create(rb);
+
+  const u8 raw[] = {0, 0, 0, 0};
+  IAT_CHECK(channel.get_ring().push(100, raw).has_value());
+  IAT_CHECK(channel.push(Ping{7}).has_value());
+
+  Mut<Counter> counter;
+  IAT_CHECK_EQ(channel.dispatch(counter), static_cast<usize>(2));
+  IAT_CHECK_EQ(counter.pings, static_cast<u32>(1));
+  IAT_CHECK_EQ(counter.last_sequence, static_cast<u32>(7));
+
+  return true;
+}
+
+auto test_capacity_check() -> bool
+{
+  Mut<Vec<u8>> memory(BUFFER_SIZE + 3);
+  Mut<RingBufferView> rb = *RingBufferView::create(Span<u8>(memory), true);
+  IAT_CHECK_NOT(TestChannel::create(rb).has_value());
+
+  return true;
+}
+
+auto test_threaded() -> bool
+{
+  static constexpr const u32 MESSAGE_COUNT = 20000;
+
+  Mut<Vec<u8>> memory(BUFFER_SIZE);
+  Mut<RingBufferView> producer_rb = *RingBufferView::create(Span<u8>(memory), true);
+  Mut<RingBufferView> consumer_rb = *RingBufferView::create(Span<u8>(memory), false);
+  Mut<TestChannel> producer = *TestChannel::create(producer_rb);
+  Mut<TestChannel> consumer = *TestChannel::create(consumer_rb);
+
+  Mut<std::thread> producer_thread([&]() {
+    for (Mut<u32> i = 0; i < MESSAGE_COUNT; i++)
+    {
+      while (!producer.push(Ping{i}))
+      {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  Mut<u32> received = 0;
+  Mut<bool> in_order = true;
+  while (received < MESSAGE_COUNT)
+  {
+    consumer.dispatch([&](Ref<auto> message) {
+      if constexpr (std::is_same_v<std::remove_cvref_t<decltype(message)>, Ping>)
+      {
+        in_order = in_order && message.sequence == received;
+        received++;
+      }
+    });
+  }
+
+  producer_thread.join();
+
+  IAT_CHECK(in_order);
+
+  return true;
+}
+
+IAT_BEGIN_TEST_LIST()
+IAT_ADD_TEST(test_ids);
+IAT_ADD_TEST(test_dispatch);
+IAT_ADD_TEST(test_unknown_ids_skipped);
+IAT_ADD_TEST(test_capacity_check);
+IAT_ADD_TEST(test_threaded);
+IAT_END_TEST_LIST()
+
+IAT_END_BLOCK()
+
+IAT_REGISTER_ENTRY(Core, Channel)
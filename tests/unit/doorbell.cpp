@@ -0,0 +1,168 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <crux/adt/ring_buffer.hpp>
+#include <crux/doorbell.hpp>
+#include <iatest/iatest.hpp>
+
+#include <thread>
+
+#if IA_PLATFORM_LINUX
+#  include <sys/epoll.h>
+#  include <unistd.h>
+#endif
+
+using namespace ia;
+
+IAT_BEGIN_BLOCK(Core, Doorbell)
+
+#if IA_PLATFORM_LINUX
+static constexpr const usize BUFFER_SIZE = sizeof(RingBufferView::ControlBlock) + 256;
+
+auto test_signal_drain() -> bool
+{
+  auto doorbell_res = Doorbell::create();
+  IAT_CHECK(doorbell_res.has_value());
+  Mut<Doorbell> doorbell = std::move(*doorbell_res);
+  IAT_CHECK(doorbell.is_valid());
+
+  IAT_CHECK_EQ(doorbell.drain(), static_cast<u64>(0));
+
+  doorbell.signal();
+  doorbell.signal();
+  IAT_CHECK_EQ(doorbell.drain(), static_cast<u64>(2));
+  IAT_CHECK_EQ(doorbell.drain(), static_cast<u64>(0));
+
+  return true;
+}
+
+auto test_empty_to_non_empty() -> bool
+{
+  Mut<Doorbell> doorbell = std::move(*Doorbell::create());
+
+  Mut<Vec<u8>> memory(BUFFER_SIZE);
+  Mut<RingBufferView> producer = *RingBufferView::create(Span<u8>(memory), true, RingBufferView::FLAG_WAITABLE);
+  Mut<RingBufferView> consumer = *RingBufferView::create(Span<u8>(memory), false);
+  IAT_CHECK(producer.set_doorbell(doorbell.get_fd()).has_value());
+  IAT_CHECK(consumer.set_doorbell(doorbell.get_fd()).has_value());
+
+  const u8 payload[] = {1, 2, 3};
+
+  // Not armed, nothing rings
+  IAT_CHECK(producer.push(1, payload).has_value());
+  IAT_CHECK_EQ(doorbell.drain(), static_cast<u64>(0));
+
+  // Arming a non-empty ring is refused
+  IAT_CHECK_NOT(consumer.arm_doorbell());
+
+  Mut<RingBufferView::PacketHeader> header;
+  Mut<u8> out[16]{};
+  IAT_CHECK(consumer.pop(header, Span<u8>(out)).has_value());
+
+  // Armed: only the first publish rings
+  IAT_CHECK(consumer.arm_doorbell());
+  IAT_CHECK(producer.push(2, payload).has_value());
+  IAT_CHECK(producer.push(3, payload).has_value());
+  IAT_CHECK_EQ(doorbell.drain(), static_cast<u64>(1));
+
+  // Without FLAG_WAITABLE the producer never rings, so arming is refused
+  Mut<Vec<u8>> plain_memory(BUFFER_SIZE);
+  Mut<RingBufferView> plain = *RingBufferView::create(Span<u8>(plain_memory), true);
+  IAT_CHECK_NOT(plain.arm_doorbell());
+
+  return true;
+}
+
+auto test_epoll_loop() -> bool
+{
+  static constexpr const u32 PACKET_COUNT = 2000;
+
+  Mut<Doorbell> doorbell = std::move(*Doorbell::create());
+
+  Mut<Vec<u8>> memory(BUFFER_SIZE);
+  Mut<RingBufferView> producer = *RingBufferView::create(Span<u8>(memory), true, RingBufferView::FLAG_WAITABLE);
+  Mut<RingBufferView> consumer = *RingBufferView::create(Span<u8>(memory), false);
+  (void) producer.set_doorbell(doorbell.get_fd());
+  (void) consumer.set_doorbell(doorbell.get_fd());
+
+  const i32 epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  IAT_CHECK(epoll_fd != -1);
+  Mut<epoll_event> event{};
+  event.events = EPOLLIN;
+  IAT_CHECK_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, doorbell.get_fd(), &event), 0);
+
+  Mut<std::thread> producer_thread([&]() {
+    for (Mut<u32> i = 0; i < PACKET_COUNT; i++)
+    {
+      const u32 value = i;
+      const Span<const u8> data(reinterpret_cast<const u8 *>(&value), sizeof(value));
+      (void) producer.push_wait(1, data, 5000);
+    }
+  });
+
+  Mut<u32> received = 0;
+  Mut<bool> in_order = true;
+  Mut<bool> timed_out = false;
+
+  while (received < PACKET_COUNT && !timed_out)
+  {
+    consumer.consume_all([&](Ref<RingBufferView::PacketView> packet) {
+      Mut<u32> value = 0;
+      std::memcpy(&value, packet.first.data(), packet.first.size());
+      std::memcpy(reinterpret_cast<u8 *>(&value) + packet.first.size(), packet.second.data(), packet.second.size());
+      in_order = in_order && value == received;
+      received++;
+    });
+
+    if (received < PACKET_COUNT && consumer.arm_doorbell())
+    {
+      Mut<epoll_event> ready{};
+      timed_out = epoll_wait(epoll_fd, &ready, 1, 5000) != 1;
+      doorbell.drain();
+    }
+  }
+
+  producer_thread.join();
+  close(epoll_fd);
+
+  IAT_CHECK_NOT(timed_out);
+  IAT_CHECK(in_order);
+  IAT_CHECK_EQ(received, PACKET_COUNT);
+
+  return true;
+}
+#endif
+
+auto test_requires_waitable() -> bool
+{
+  Mut<Vec<u8>> memory(sizeof(RingBufferView::ControlBlock) + 64);
+  Mut<RingBufferView> rb = *RingBufferView::create(Span<u8>(memory), true);
+  IAT_CHECK_NOT(rb.set_doorbell(3).has_value());
+
+  return true;
+}
+
+IAT_BEGIN_TEST_LIST()
+#if IA_PLATFORM_LINUX
+IAT_ADD_TEST(test_signal_drain);
+IAT_ADD_TEST(test_empty_to_non_empty);
+IAT_ADD_TEST(test_epoll_loop);
+#endif
+IAT_ADD_TEST(test_requires_waitable);
+IAT_END_TEST_LIST()
+
+IAT_END_BLOCK()
+
+IAT_REGISTER_ENTRY(Core, Doorbell)
@@ -0,0 +1,391 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <crux/journal.hpp>
+#include <iatest/iatest.hpp>
+
+#include <cstdio>
+#include <thread>
+
+#if IA_PLATFORM_UNIX
+#  include <unistd.h>
+#endif
+
+using namespace ia;
+
+IAT_BEGIN_BLOCK(Core, Journal)
+
+#if IA_PLATFORM_UNIX
+static auto get_test_prefix(Ref<String> name) -> String
+{
+  return std::format("/tmp/iacrux_test_{}_{}", name, getpid());
+}
+
+static auto remove_journal(Ref<String> prefix) -> void
+{
+  for (Mut<u32> i = 0; std::remove(journal::get_segment_path(prefix, i).c_str()) == 0; i++)
+  {
+  }
+}
+
+auto test_append_read() -> bool
+{
+  const String prefix = get_test_prefix("append_read");
+
+  {
+    auto writer_res = JournalWriter::create(prefix);
+    IAT_CHECK(writer_res.has_value());
+    Mut<JournalWriter> writer = std::move(*writer_res);
+
+    const u8 payload[] = {1, 2, 3, 4, 5};
+    IAT_CHECK(writer.append(10, Span<const u8>(payload), 1000).has_value());
+    IAT_CHECK(writer.append(11, Span<const u8>(), 2000).has_value());
+  }
+
+  auto reader_res = JournalReader::open(prefix);
+  IAT_CHECK(reader_res.has_value());
+  IAT_CHECK_EQ(reader_res->get_record_count(), static_cast<u64>(2));
+
+  const auto first = reader_res->get_entry(0);
+  IAT_CHECK(first.has_value());
+  IAT_CHECK_EQ(first->id, static_cast<u16>(10));
+  IAT_CHECK_EQ(first->timestamp_ns, static_cast<u64>(1000));
+  IAT_CHECK_EQ(first->data.size(), static_cast<usize>(5));
+  IAT_CHECK_EQ(first->data[4], static_cast<u8>(5));
+
+  const auto second = reader_res->get_entry(1);
+  IAT_CHECK(second.has_value());
+  IAT_CHECK_EQ(second->id, static_cast<u16>(11));
+  IAT_CHECK(second->data.empty());
+
+  IAT_CHECK_NOT(reader_res->get_entry(2).has_value());
+
+  remove_journal(prefix);
+  return true;
+}
+
+auto test_rotation() -> bool
+{
+  const String prefix = get_test_prefix("rotation");
+
+  Mut<JournalWriter::Options> options;
+  options.segment_size = 256;
+  options.index_capacity = 4;
+
+  static constexpr const u32 RECORD_COUNT = 20;
+  {
+    Mut<JournalWriter> writer = std::move(*JournalWriter::create(prefix, options));
+    for (Mut<u32> i = 0; i < RECORD_COUNT; i++)
+    {
+      const u32 value = i;
+      IAT_CHECK(writer.append(static_cast<u16>(i + 1), Span<const u8>(reinterpret_cast<const u8 *>(&value), 4), i)
+                    .has_value());
+    }
+    IAT_CHECK_EQ(writer.get_segment_count(), RECORD_COUNT / 4);
+
+    // A record that can never fit in a segment is rejected outright
+    Mut<Vec<u8>> too_large(512);
+    IAT_CHECK_NOT(writer.append(1, Span<const u8>(too_large)).has_value());
+  }
+
+  auto reader_res = JournalReader::open(prefix);
+  IAT_CHECK(reader_res.has_value());
+  IAT_CHECK_EQ(reader_res->get_record_count(), static_cast<u64>(RECORD_COUNT));
+
+  Mut<bool> in_order = true;
+  for (Mut<u32> i = 0; i < RECORD_COUNT; i++)
+  {
+    const auto entry = reader_res->get_entry(i);
+    Mut<u32> value = 0;
+    std::memcpy(&value, entry->data.data(), sizeof(value));
+    in_order = in_order && entry->id == i + 1 && value == i;
+  }
+  IAT_CHECK(in_order);
+
+  remove_journal(prefix);
+  return true;
+}
+
+auto test_crc_mismatch() -> bool
+{
+  const String prefix = get_test_prefix("crc");
+
+  Mut<JournalWriter::Options> options;
+  options.segment_size = 4096;
+  options.crc32 = true;
+
+  const u8 payload[] = {0xAA, 0xBB, 0xCC};
+  {
+    Mut<JournalWriter> writer = std::move(*JournalWriter::create(prefix, options));
+    IAT_CHECK(writer.append(1, Span<const u8>(payload), 1).has_value());
+  }
+
+  IAT_CHECK(JournalReader::open(prefix).has_value());
+
+  // Flip the last payload byte behind the reader's back
+  const String path = journal::get_segment_path(prefix, 0);
+  const usize record_offset = sizeof(journal::SegmentHeader) + (4096 / 64) * sizeof(journal::IndexEntry);
+  FILE *file = std::fopen(path.c_str(), "r+b");
+  IAT_CHECK(file != nullptr);
+  std::fseek(file, static_cast<long>(record_offset + sizeof(RingBufferView::PacketHeader) + 2), SEEK_SET);
+  std::fputc(0x00, file);
+  std::fclose(file);
+
+  IAT_CHECK_NOT(JournalReader::open(prefix).has_value());
+
+  remove_journal(prefix);
+  return true;
+}
+
+auto test_stale_segments() -> bool
+{
+  const String prefix = get_test_prefix("stale");
+
+  Mut<JournalWriter::Options> options;
+  options.segment_size = 256;
+  options.index_capacity = 4;
+
+  {
+    Mut<JournalWriter> writer = std::move(*JournalWriter::create(prefix, options));
+    for (Mut<u32> i = 0; i < 20; i++)
+    {
+      IAT_CHECK(writer.append(1, Span<const u8>(), i).has_value());
+    }
+    IAT_CHECK_EQ(writer.get_segment_count(), 5u);
+  }
+
+  // A shorter second run must not be followed by the first run's later segments
+  {
+    Mut<JournalWriter> writer = std::move(*JournalWriter::create(prefix, options));
+    IAT_CHECK(writer.append(2, Span<const u8>(), 100).has_value());
+    IAT_CHECK(writer.append(2, Span<const u8>(), 200).has_value());
+  }
+
+  auto reader_res = JournalReader::open(prefix);
+  IAT_CHECK(reader_res.has_value());
+  IAT_CHECK_EQ(reader_res->get_record_count(), static_cast<u64>(2));
+  IAT_CHECK_EQ(reader_res->get_entry(1)->id, static_cast<u16>(2));
+
+  remove_journal(prefix);
+  return true;
+}
+
+auto test_corrupt_index() -> bool
+{
+  const String prefix = get_test_prefix("corrupt_index");
+
+  const u8 payload[] = {1, 2, 3, 4};
+  {
+    Mut<JournalWriter> writer = std::move(*JournalWriter::create(prefix));
+    IAT_CHECK(writer.append(1, Span<const u8>(payload), 1).has_value());
+    IAT_CHECK(writer.append(2, Span<const u8>(payload), 2).has_value());
+  }
+
+  IAT_CHECK(JournalReader::open(prefix).has_value());
+
+  // Point the second index entry past the end of the records
+  const String path = journal::get_segment_path(prefix, 0);
+  const u64 bad_offset = 4096;
+  FILE *file = std::fopen(path.c_str(), "r+b");
+  IAT_CHECK(file != nullptr);
+  std::fseek(file,
+             static_cast<long>(sizeof(journal::SegmentHeader) + sizeof(journal::IndexEntry) +
+                               offsetof(journal::IndexEntry, offset)),
+             SEEK_SET);
+  std::fwrite(&bad_offset, sizeof(bad_offset), 1, file);
+  std::fclose(file);
+
+  IAT_CHECK_NOT(JournalReader::open(prefix).has_value());
+
+  remove_journal(prefix);
+  return true;
+}
+
+auto test_seek() -> bool
+{
+  const String prefix = get_test_prefix("seek");
+
+  {
+    Mut<JournalWriter> writer = std::move(*JournalWriter::create(prefix));
+    for (Mut<u64> i = 0; i < 10; i++)
+    {
+      IAT_CHECK(writer.append(1, Span<const u8>(), (i + 1) * 100).has_value());
+    }
+  }
+
+  const JournalReader reader = std::move(*JournalReader::open(prefix));
+  IAT_CHECK_EQ(reader.seek(0), static_cast<u64>(0));
+  IAT_CHECK_EQ(reader.seek(100), static_cast<u64>(0));
+  IAT_CHECK_EQ(reader.seek(450), static_cast<u64>(4));
+  IAT_CHECK_EQ(reader.seek(500), static_cast<u64>(4));
+  IAT_CHECK_EQ(reader.seek(5000), static_cast<u64>(10));
+
+  remove_journal(prefix);
+
+  // A clock stepping backwards must not unsort the index: the late record keeps its predecessor's timestamp
+  const String stepped_prefix = get_test_prefix("seek_stepped");
+  {
+    Mut<JournalWriter> writer = std::move(*JournalWriter::create(stepped_prefix));
+    for (const u64 timestamp : {100ull, 200ull, 300ull, 150ull, 400ull})
+    {
+      IAT_CHECK(writer.append(1, Span<const u8>(), timestamp).has_value());
+    }
+  }
+
+  const JournalReader stepped = std::move(*JournalReader::open(stepped_prefix));
+  IAT_CHECK_EQ(stepped.get_entry(3)->timestamp_ns, static_cast<u64>(300));
+  IAT_CHECK_EQ(stepped.seek(250), static_cast<u64>(2));
+  IAT_CHECK_EQ(stepped.seek(301), static_cast<u64>(4));
+
+  remove_journal(stepped_prefix);
+  return true;
+}
+
+auto test_replay() -> bool
+{
+  const String prefix = get_test_prefix("replay");
+
+  static constexpr const u32 RECORD_COUNT = 64;
+  {
+    Mut<JournalWriter> writer = std::move(*JournalWriter::create(prefix));
+    for (Mut<u32> i = 0; i < RECORD_COUNT; i++)
+    {
+      const u32 value = i;
+      // 1ms apart, so a replay at 1000x takes about 64us
+      IAT_CHECK(writer.append(7, Span<const u8>(reinterpret_cast<const u8 *>(&value), 4), i * 1000000ull).has_value());
+    }
+  }
+
+  const JournalReader reader = std::move(*JournalReader::open(prefix));
+
+  // The ring is far smaller than the journal, so replay has to wait for the consumer
+  Mut<Vec<u8>> memory(sizeof(RingBufferView::ControlBlock) + 128);
+  Mut<RingBufferView> producer = *RingBufferView::create(Span<u8>(memory), true, RingBufferView::FLAG_WAITABLE);
+  Mut<RingBufferView> consumer = *RingBufferView::create(Span<u8>(memory), false);
+
+  for (const f64 speed : {0.0, 1000.0})
+  {
+    Mut<u32> received = 0;
+    Mut<bool> in_order = true;
+    std::jthread reader_thread([&] {
+      Mut<RingBufferView::PacketHeader> header;
+      Mut<u32> value = 0;
+      while (received < RECORD_COUNT)
+      {
+        auto res = consumer.pop_wait(header, Span<u8>(reinterpret_cast<u8 *>(&value), 4), 1000);
+        if (!res || !*res)
+        {
+          break;
+        }
+        in_order = in_order && header.id == 7 && value == received;
+        received++;
+      }
+    });
+
+    auto replayed = reader.replay(producer, speed);
+    reader_thread.join();
+
+    IAT_CHECK(replayed.has_value());
+    IAT_CHECK_EQ(*replayed, static_cast<u64>(RECORD_COUNT));
+    IAT_CHECK_EQ(received, RECORD_COUNT);
+    IAT_CHECK(in_order);
+  }
+
+  // Replaying from a seek position only pushes the tail
+  Mut<Vec<u8>> large_memory(sizeof(RingBufferView::ControlBlock) + 4096);
+  Mut<RingBufferView> large = *RingBufferView::create(Span<u8>(large_memory), true);
+  auto tail = reader.replay(large, 0.0, reader.seek(60 * 1000000ull));
+  IAT_CHECK(tail.has_value());
+  IAT_CHECK_EQ(*tail, static_cast<u64>(4));
+
+  // A timestamp that steps backwards is stored as the previous one and pushed right away
+  const String stepped_prefix = get_test_prefix("replay_stepped");
+  {
+    Mut<JournalWriter> writer = std::move(*JournalWriter::create(stepped_prefix));
+    IAT_CHECK(writer.append(1, Span<const u8>(), 5000000000ull).has_value());
+    IAT_CHECK(writer.append(2, Span<const u8>(), 1000).has_value());
+  }
+
+  const JournalReader stepped = std::move(*JournalReader::open(stepped_prefix));
+  Mut<RingBufferView> stepped_ring = *RingBufferView::create(Span<u8>(large_memory), true);
+  const auto replay_start = std::chrono::steady_clock::now();
+  auto stepped_res = stepped.replay(stepped_ring, 1.0);
+  IAT_CHECK(stepped_res.has_value());
+  IAT_CHECK_EQ(*stepped_res, static_cast<u64>(2));
+  IAT_CHECK(std::chrono::steady_clock::now() - replay_start < std::chrono::seconds(1));
+
+  remove_journal(stepped_prefix);
+
+  // Packets a plain ring can never take fail at once with the real reason, and a blocked push is counted once
+  const String invalid_prefix = get_test_prefix("replay_invalid");
+  {
+    Mut<JournalWriter> writer = std::move(*JournalWriter::create(invalid_prefix));
+    IAT_CHECK(writer.append(RingBufferView::PACKET_ID_FRAGMENT, Span<const u8>(), 0).has_value());
+    const Vec<u8> oversized(200, 0xAB);
+    IAT_CHECK(writer.append(3, oversized, 0).has_value());
+  }
+
+  const JournalReader invalid = std::move(*JournalReader::open(invalid_prefix));
+  Mut<Vec<u8>> small_memory(sizeof(RingBufferView::ControlBlock) + 128);
+  Mut<RingBufferView> small = *RingBufferView::create(Span<u8>(small_memory), true, RingBufferView::FLAG_STATS);
+
+  for (const u64 first : {0ull, 1ull})
+  {
+    const auto invalid_start = std::chrono::steady_clock::now();
+    auto invalid_res = invalid.replay(small, 0.0, first, 5000);
+    IAT_CHECK_NOT(invalid_res.has_value());
+    IAT_CHECK(invalid_res.error().find("full") == String::npos);
+    IAT_CHECK(std::chrono::steady_clock::now() - invalid_start < std::chrono::seconds(1));
+  }
+
+  // Fill the ring, then replay into it: the timeout is reported as full, counted as a single rejection
+  const Vec<u8> filler(100, 0);
+  IAT_CHECK(small.push(9, filler).has_value());
+  const JournalReader tail_reader = std::move(*JournalReader::open(prefix));
+  auto full_res = tail_reader.replay(small, 0.0, 0, 20);
+  IAT_CHECK_NOT(full_res.has_value());
+  IAT_CHECK(full_res.error().find("full") != String::npos);
+  IAT_CHECK_EQ(small.get_stats().full_rejections, static_cast<u64>(1));
+
+  remove_journal(invalid_prefix);
+
+  remove_journal(prefix);
+  return true;
+}
+#endif
+
+auto test_missing_journal() -> bool
+{
+  IAT_CHECK_NOT(JournalReader::open("/tmp/iacrux_test_does_not_exist").has_value());
+
+  return true;
+}
+
+IAT_BEGIN_TEST_LIST()
+#if IA_PLATFORM_UNIX
+IAT_ADD_TEST(test_append_read);
+IAT_ADD_TEST(test_rotation);
+IAT_ADD_TEST(test_crc_mismatch);
+IAT_ADD_TEST(test_stale_segments);
+IAT_ADD_TEST(test_corrupt_index);
+IAT_ADD_TEST(test_seek);
+IAT_ADD_TEST(test_replay);
+#endif
+IAT_ADD_TEST(test_missing_journal);
+IAT_END_TEST_LIST()
+
+IAT_END_BLOCK()
+
+IAT_REGISTER_ENTRY(Core, Journal)
@@ -0,0 +1,291 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <crux/log_file.hpp>
+#include <iatest/iatest.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#if IA_PLATFORM_UNIX
+#  include <unistd.h>
+#endif
+
+using namespace ia;
+
+IAT_BEGIN_BLOCK(Core, LogFile)
+
+#if IA_PLATFORM_UNIX
+static auto get_test_prefix(Ref<String> name) -> String
+{
+  return std::format("/tmp/iacrux_test_log_{}_{}", name, getpid());
+}
+
+static auto remove_logs(Ref<String> prefix) -> void
+{
+  for (Mut<u32> i = 0; i < 64; i++)
+  {
+    std::remove(RotatingFileSink::get_file_path(prefix, i).c_str());
+  }
+  std::remove(RotatingFileSink::get_lock_path(prefix).c_str());
+}
+
+static auto read_file(Ref<String> path) -> String
+{
+  Mut<std::ifstream> file(path, std::ios::binary);
+  Mut<std::stringstream> contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+static auto get_small_options() -> RotatingFileSink::Options
+{
+  Mut<RotatingFileSink::Options> options;
+  options.file_size = 4096;
+  return options;
+}
+
+auto test_write_and_close() -> bool
+{
+  const String prefix = get_test_prefix("close");
+
+  auto sink = RotatingFileSink::create(prefix, get_small_options());
+  IAT_CHECK(sink.has_value());
+
+  (*sink)->write(logger::Level::Info, "first line", "main.cpp", 10);
+  (*sink)->write(logger::Level::Error, "second line", "net.cpp", 2000);
+  (*sink)->close();
+
+  // The preallocated tail is cut off, only the lines remain
+  const String contents = read_file(RotatingFileSink::get_file_path(prefix, 0));
+  IAT_CHECK(contents.find(" [INFO] [main.cpp:10] first line\n") != String::npos);
+  IAT_CHECK(contents.ends_with(" [ERRO] [net.cpp:2000] second line\n"));
+  IAT_CHECK_EQ(std::count(contents.begin(), contents.end(), '\n'), static_cast<std::ptrdiff_t>(2));
+  IAT_CHECK_EQ(contents.find('\0'), String::npos);
+
+  // The file prepared ahead is deleted, and later lines are dropped
+  IAT_CHECK_NOT(std::filesystem::exists(RotatingFileSink::get_file_path(prefix, 1)));
+  (*sink)->write(logger::Level::Info, "too late", "main.cpp", 11);
+  IAT_CHECK_EQ((*sink)->get_dropped_count(), static_cast<u64>(1));
+
+  remove_logs(prefix);
+
+  return true;
+}
+
+auto test_size_rotation() -> bool
+{
+  const String prefix = get_test_prefix("size");
+
+  Mut<RotatingFileSink::Options> options;
+  options.file_size = 512;
+  options.max_files = 3;
+
+  auto sink = RotatingFileSink::create(prefix, options);
+  IAT_CHECK(sink.has_value());
+
+  for (Mut<u32> i = 0; i < 100; i++)
+  {
+    (*sink)->write(logger::Level::Info, std::format("message number {:03}", i), "rotate.cpp", i);
+  }
+
+  const u32 current = (*sink)->get_current_index();
+  (*sink)->close();
+
+  IAT_CHECK(current >= 3);
+
+  // Only the newest max_files survive, and every line sits whole in one of them
+  IAT_CHECK_NOT(std::filesystem::exists(RotatingFileSink::get_file_path(prefix, current - 3)));
+  IAT_CHECK(std::filesystem::exists(RotatingFileSink::get_file_path(prefix, current - 2)));
+
+  const String last = read_file(RotatingFileSink::get_file_path(prefix, current));
+  IAT_CHECK(last.ends_with("] message number 099\n"));
+  IAT_CHECK(std::filesystem::file_size(RotatingFileSink::get_file_path(prefix, current - 1)) <= 512);
+
+  remove_logs(prefix);
+
+  return true;
+}
+
+auto test_time_rotation() -> bool
+{
+  const String prefix = get_test_prefix("time");
+
+  Mut<RotatingFileSink::Options> options = get_small_options();
+  options.max_age_ms = 200;
+
+  auto sink = RotatingFileSink::create(prefix, options);
+  IAT_CHECK(sink.has_value());
+
+  // Compared by index, so a slow start that already rotated "before" does not matter
+  (*sink)->write(logger::Level::Info, "before", "time.cpp", 1);
+  const u32 before_index = (*sink)->get_current_index();
+  std::this_thread::sleep_for(std::chrono::milliseconds(400));
+  (*sink)->write(logger::Level::Info, "after", "time.cpp", 2);
+  const u32 after_index = (*sink)->get_current_index();
+
+  IAT_CHECK_EQ(after_index, before_index + 1);
+  (*sink)->close();
+
+  IAT_CHECK(read_file(RotatingFileSink::get_file_path(prefix, before_index)).ends_with("before\n"));
+  IAT_CHECK(read_file(RotatingFileSink::get_file_path(prefix, after_index)).ends_with("after\n"));
+
+  remove_logs(prefix);
+
+  return true;
+}
+
+auto test_restart() -> bool
+{
+  const String prefix = get_test_prefix("restart");
+
+  // Two sinks on the same prefix, one after the other: the second carries on after the first
+  for (const StringView run : {"first run", "second run"})
+  {
+    auto sink = RotatingFileSink::create(prefix, get_small_options());
+    IAT_CHECK(sink.has_value());
+    (*sink)->write(logger::Level::Info, run, "restart.cpp", 1);
+  }
+
+  IAT_CHECK(read_file(RotatingFileSink::get_file_path(prefix, 0)).ends_with("] first run\n"));
+  IAT_CHECK(read_file(RotatingFileSink::get_file_path(prefix, 1)).ends_with("] second run\n"));
+
+  // max_files counts the earlier runs' files too
+  Mut<RotatingFileSink::Options> options = get_small_options();
+  options.max_files = 2;
+  {
+    auto sink = RotatingFileSink::create(prefix, options);
+    IAT_CHECK(sink.has_value());
+    IAT_CHECK_EQ((*sink)->get_current_index(), 2u);
+  }
+
+  IAT_CHECK_NOT(std::filesystem::exists(RotatingFileSink::get_file_path(prefix, 0)));
+  IAT_CHECK(std::filesystem::exists(RotatingFileSink::get_file_path(prefix, 1)));
+
+  remove_logs(prefix);
+
+  return true;
+}
+
+auto test_crash_recovery() -> bool
+{
+  const String prefix = get_test_prefix("crash");
+
+  // What a killed process leaves behind: a live file with its zero-filled tail, and the next one prepared
+  {
+    Mut<std::ofstream> live(RotatingFileSink::get_file_path(prefix, 4), std::ios::binary);
+    live << "last line\n" << String(1000, '\0');
+    Mut<std::ofstream> prepared(RotatingFileSink::get_file_path(prefix, 5), std::ios::binary);
+    prepared << String(1000, '\0');
+  }
+
+  auto sink = RotatingFileSink::create(prefix, get_small_options());
+  IAT_CHECK(sink.has_value());
+  IAT_CHECK_EQ((*sink)->get_current_index(), 5u);
+  (*sink)->close();
+
+  IAT_CHECK_EQ(read_file(RotatingFileSink::get_file_path(prefix, 4)), String("last line\n"));
+
+  remove_logs(prefix);
+
+  return true;
+}
+
+auto test_prefix_in_use() -> bool
+{
+  const String prefix = get_test_prefix("in_use");
+
+  auto first = RotatingFileSink::create(prefix, get_small_options());
+  IAT_CHECK(first.has_value());
+  (*first)->write(logger::Level::Info, "still live", "first.cpp", 1);
+
+  // A second sink would trim the live file (and delete the prepared one) under the first sink's mapping
+  IAT_CHECK_NOT(RotatingFileSink::create(prefix, get_small_options()).has_value());
+
+  IAT_CHECK((*first)->rotate().has_value());
+  (*first)->write(logger::Level::Info, "after rotation", "first.cpp", 2);
+  IAT_CHECK_EQ((*first)->get_dropped_count(), static_cast<u64>(0));
+  (*first)->close();
+
+  // Closing releases the prefix
+  auto second = RotatingFileSink::create(prefix, get_small_options());
+  IAT_CHECK(second.has_value());
+  IAT_CHECK_EQ((*second)->get_current_index(), 2u);
+  (*second)->close();
+
+  IAT_CHECK(read_file(RotatingFileSink::get_file_path(prefix, 0)).ends_with("] still live\n"));
+  IAT_CHECK(read_file(RotatingFileSink::get_file_path(prefix, 1)).ends_with("] after rotation\n"));
+
+  remove_logs(prefix);
+
+  return true;
+}
+
+auto test_logger_sink() -> bool
+{
+  const String prefix = get_test_prefix("logger");
+
+  auto sink = RotatingFileSink::create(prefix, get_small_options());
+  IAT_CHECK(sink.has_value());
+
+  logger::set_handler(logger::null_handler, nullptr);
+  auto id = logger::add_sink(RotatingFileSink::handler, sink->get(), logger::Level::Warn);
+  IAT_CHECK(id.has_value());
+
+  IA_LOG_INFO("filtered {}", 1);
+  IA_LOG_ERROR("kept {}", 2);
+
+  IAT_CHECK(logger::remove_sink(*id));
+  logger::set_handler(nullptr, nullptr);
+  (*sink)->close();
+
+  const String contents = read_file(RotatingFileSink::get_file_path(prefix, 0));
+  IAT_CHECK_EQ(contents.find("filtered"), String::npos);
+  IAT_CHECK(contents.find("[log_file.cpp:") != String::npos);
+  IAT_CHECK(contents.ends_with("] kept 2\n"));
+
+  remove_logs(prefix);
+
+  return true;
+}
+#endif
+
+auto test_bad_options() -> bool
+{
+  Mut<RotatingFileSink::Options> options;
+  options.file_size = 16;
+  IAT_CHECK_NOT(RotatingFileSink::create("/tmp/iacrux_test_log_bad", options).has_value());
+
+  return true;
+}
+
+IAT_BEGIN_TEST_LIST()
+#if IA_PLATFORM_UNIX
+IAT_ADD_TEST(test_write_and_close);
+IAT_ADD_TEST(test_size_rotation);
+IAT_ADD_TEST(test_time_rotation);
+IAT_ADD_TEST(test_restart);
+IAT_ADD_TEST(test_crash_recovery);
+IAT_ADD_TEST(test_prefix_in_use);
+IAT_ADD_TEST(test_logger_sink);
+#endif
+IAT_ADD_TEST(test_bad_options);
+IAT_END_TEST_LIST()
+
+IAT_END_BLOCK()
+
+IAT_REGISTER_ENTRY(Core, LogFile)
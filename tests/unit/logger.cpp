@@ -13,13 +13,26 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <crux/env.hpp>
 #include <crux/logger.hpp>
 #include <iatest/iatest.hpp>
 
+#include <csignal>
 #include <fstream>
+#include <thread>
+
+#if IA_PLATFORM_UNIX
+#  include <unistd.h>
+#endif
 
 using namespace ia;
 
+// Heap allocations made by the calling thread so far, counted by the operator new replacement in main.cpp
+auto get_thread_allocation_count() -> u64;
+
+IA_LOG_CATEGORY(TestNet);
+IA_LOG_CATEGORY(TestStorage);
+
 IAT_BEGIN_BLOCK(Core, Logger)
 
 static constexpr const char *LOG_FILE = "iacore_test_log.txt";
@@ -178,11 +191,801 @@ auto test_formatting() -> bool
   return true;
 }
 
+struct AsyncCapture
+{
+  Mut<Vec<String>> messages{};
+  Mut<std::thread::id> handler_thread{};
+};
+
+static auto capture_handler(void *user_data, logger::Level level, StringView message, StringView file, u32 line) -> void
+{
+  auto capture = reinterpret_cast<AsyncCapture *>(user_data);
+
+  AU_UNUSED(level);
+  AU_UNUSED(file);
+  AU_UNUSED(line);
+
+  capture->messages.emplace_back(message);
+  capture->handler_thread = std::this_thread::get_id();
+}
+
+auto test_async_logging() -> bool
+{
+  static constexpr const u32 THREAD_COUNT = 2;
+  static constexpr const u32 MESSAGE_COUNT = 2000;
+
+  Mut<AsyncCapture> capture;
+  logger::set_handler(capture_handler, &capture);
+
+  Mut<logger::AsyncOptions> options;
+  options.buffer_size = 4096;
+  options.overflow_policy = logger::OverflowPolicy::Block;
+  IAT_CHECK(logger::start_async(options).has_value());
+  IAT_CHECK(logger::is_async());
+  IAT_CHECK_NOT(logger::start_async(options).has_value());
+
+  const u64 dropped_before = logger::get_dropped_count();
+
+  Mut<Vec<std::thread>> threads;
+  for (Mut<u32> t = 0; t < THREAD_COUNT; t++)
+  {
+    threads.emplace_back([t] {
+      for (Mut<u32> i = 0; i < MESSAGE_COUNT; i++)
+      {
+        IA_LOG_INFO("{}:{}", t, i);
+      }
+    });
+  }
+  for (MutRef<std::thread> thread : threads)
+  {
+    thread.join();
+  }
+
+  logger::flush();
+
+  IAT_CHECK_EQ(capture.messages.size(), static_cast<usize>(THREAD_COUNT * MESSAGE_COUNT));
+  IAT_CHECK_EQ(logger::get_dropped_count(), dropped_before);
+  IAT_CHECK(capture.handler_thread != std::this_thread::get_id());
+
+  // The merge must keep every thread's records in the order they were logged
+  Mut<Vec<u32>> next_index(THREAD_COUNT, 0);
+  for (Ref<String> message : capture.messages)
+  {
+    const usize separator = message.find(':');
+    const u32 thread_index = static_cast<u32>(std::stoul(message.substr(0, separator)));
+    const u32 message_index = static_cast<u32>(std::stoul(message.substr(separator + 1)));
+
+    IAT_CHECK(thread_index < THREAD_COUNT);
+    IAT_CHECK_EQ(message_index, next_index[thread_index]);
+    next_index[thread_index]++;
+  }
+
+  logger::stop_async();
+  IAT_CHECK_NOT(logger::is_async());
+
+  // Back to synchronous dispatch: the handler runs before dispatch returns
+  capture.messages.clear();
+  IA_LOG_INFO("{}", "sync");
+  IAT_CHECK_EQ(capture.messages.size(), static_cast<usize>(1));
+  IAT_CHECK(capture.handler_thread == std::this_thread::get_id());
+
+  logger::set_handler(nullptr, nullptr);
+
+  return true;
+}
+
+auto test_async_overflow() -> bool
+{
+  static constexpr const u32 MESSAGE_COUNT = 5000;
+
+  Mut<AsyncCapture> capture;
+  logger::set_handler(capture_handler, &capture);
+
+  Mut<logger::AsyncOptions> bad_options;
+  bad_options.buffer_size = 16;
+  IAT_CHECK_NOT(logger::start_async(bad_options).has_value());
+
+  Mut<logger::AsyncOptions> options;
+  options.buffer_size = 1024;
+  options.overflow_policy = logger::OverflowPolicy::Drop;
+  IAT_CHECK(logger::start_async(options).has_value());
+
+  const u64 dropped_before = logger::get_dropped_count();
+
+  const String long_message(4096, 'x');
+  for (Mut<u32> i = 0; i < MESSAGE_COUNT; i++)
+  {
+    logger::dispatch(logger::Level::Info, long_message);
+  }
+
+  logger::stop_async();
+
+  // Every record is either delivered (truncated to fit the buffer) or counted as dropped
+  const u64 dropped = logger::get_dropped_count() - dropped_before;
+  IAT_CHECK_EQ(capture.messages.size() + dropped, static_cast<u64>(MESSAGE_COUNT));
+  IAT_CHECK(!capture.messages.empty());
+  IAT_CHECK(capture.messages.front().size() < long_message.size());
+
+  logger::set_handler(nullptr, nullptr);
+
+  return true;
+}
+
+static auto count_handler(void *user_data, logger::Level, StringView, StringView, u32) -> void
+{
+  reinterpret_cast<std::atomic<u64> *>(user_data)->fetch_add(1, std::memory_order_relaxed);
+}
+
+auto test_async_stop_race() -> bool
+{
+  static constexpr const u32 THREAD_COUNT = 3;
+  static constexpr const u32 MESSAGE_COUNT = 2000;
+
+  Mut<std::atomic<u64>> received{0};
+  logger::set_handler(count_handler, &received);
+
+  Mut<logger::AsyncOptions> options;
+  options.buffer_size = 4096;
+  IAT_CHECK(logger::start_async(options).has_value());
+
+  const u64 dropped_before = logger::get_dropped_count();
+
+  // Stop while the threads are logging: whatever they committed must still be handled or counted
+  Mut<std::atomic<u32>> started{0};
+  Mut<Vec<std::thread>> threads;
+  for (Mut<u32> t = 0; t < THREAD_COUNT; t++)
+  {
+    threads.emplace_back([&started] {
+      started.fetch_add(1);
+      for (Mut<u32> i = 0; i < MESSAGE_COUNT; i++)
+      {
+        logger::dispatch(logger::Level::Info, "racing stop_async");
+      }
+    });
+  }
+
+  while (started.load() < THREAD_COUNT)
+  {
+    std::this_thread::yield();
+  }
+  logger::stop_async();
+
+  for (auto &t : threads)
+  {
+    t.join();
+  }
+
+  const u64 dropped = logger::get_dropped_count() - dropped_before;
+  IAT_CHECK_EQ(received.load() + dropped, static_cast<u64>(THREAD_COUNT * MESSAGE_COUNT));
+
+  logger::set_handler(nullptr, nullptr);
+
+  return true;
+}
+
+// Hands the CPU to the logging thread after every record, so the buffer refills while the worker drains it
+static auto yielding_count_handler(void *user_data, logger::Level level, StringView message, StringView file,
+                                   u32 line) -> void
+{
+  count_handler(user_data, level, message, file, line);
+  std::this_thread::yield();
+}
+
+auto test_flush_under_load() -> bool
+{
+  static constexpr const u32 FLUSH_COUNT = 20;
+
+  Mut<std::atomic<u64>> received{0};
+  logger::set_handler(yielding_count_handler, &received);
+
+  Mut<logger::AsyncOptions> options;
+  options.buffer_size = 4096;
+  IAT_CHECK(logger::start_async(options).has_value());
+
+  const u64 dropped_before = logger::get_dropped_count();
+
+  // The writer never pauses, so the buffer is almost never empty: flush() must still return
+  Mut<std::atomic<bool>> stop{false};
+  Mut<std::atomic<u64>> logged{0};
+  Mut<std::thread> writer([&stop, &logged] {
+    while (!stop.load(std::memory_order_relaxed))
+    {
+      logger::dispatch(logger::Level::Info, "steady load");
+      logged.fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+
+  while (logged.load() == 0)
+  {
+    std::this_thread::yield();
+  }
+
+  // Every record logged before a flush() call is handled (or counted as dropped) by the time it returns
+  Mut<u32> flushes = 0;
+  Mut<bool> complete = true;
+  for (; flushes < FLUSH_COUNT; flushes++)
+  {
+    const u64 logged_before = logged.load();
+    logger::flush();
+    complete = complete && received.load() + (logger::get_dropped_count() - dropped_before) >= logged_before;
+  }
+
+  stop.store(true);
+  writer.join();
+  logger::stop_async();
+
+  IAT_CHECK_EQ(flushes, FLUSH_COUNT);
+  IAT_CHECK(complete);
+  IAT_CHECK(received.load() > 0);
+
+  logger::set_handler(nullptr, nullptr);
+
+  return true;
+}
+
+auto test_deferred_formatting() -> bool
+{
+  Mut<AsyncCapture> capture;
+  logger::set_handler(capture_handler, &capture);
+
+  const String name = "IACrux";
+  const char *c_name = "ring";
+  const i32 negative = -42;
+  const u16 mask = 0xBEEF;
+
+  IA_LOG_INFO_DEFERRED("{} {} {:x} {:.2f} {} {} {}", name, negative, mask, 3.14159, true, 'z', c_name);
+  IA_LOG_WARN_DEFERRED("{1}-{0}", 1, 2);
+  IA_LOG_ERROR_DEFERRED("no arguments {{}}");
+
+  IAT_CHECK_EQ(capture.messages.size(), static_cast<usize>(3));
+  IAT_CHECK_EQ(capture.messages[0], String("IACrux -42 beef 3.14 true z ring"));
+  IAT_CHECK_EQ(capture.messages[1], String("2-1"));
+  IAT_CHECK_EQ(capture.messages[2], String("no arguments {}"));
+
+  // Strings longer than MAX_DEFERRED_STRING_SIZE are cut short
+  const String long_text(logger::MAX_DEFERRED_STRING_SIZE * 2, 'y');
+  IA_LOG_INFO_DEFERRED("{}", long_text);
+  IAT_CHECK_EQ(capture.messages.back().size(), logger::MAX_DEFERRED_STRING_SIZE);
+
+  // Formatted on the async worker instead
+  IAT_CHECK(logger::start_async().has_value());
+  for (Mut<i32> i = 0; i < 100; i++)
+  {
+    IA_LOG_INFO_DEFERRED("async {}", i);
+  }
+  logger::flush();
+
+  IAT_CHECK_EQ(capture.messages.size(), static_cast<usize>(104));
+  IAT_CHECK_EQ(capture.messages.back(), String("async 99"));
+  IAT_CHECK(capture.handler_thread != std::this_thread::get_id());
+
+  logger::stop_async();
+  logger::set_handler(nullptr, nullptr);
+
+  return true;
+}
+
+struct SinkCapture
+{
+  Mut<const logger::CallSite *> call_site{};
+  Mut<Vec<u8>> args{};
+  Mut<u32> count{};
+};
+
+auto test_record_sink() -> bool
+{
+  Mut<SinkCapture> capture;
+  logger::set_record_sink(
+      [](void *user_data, Ref<logger::CallSite> call_site, u64 timestamp_ns, Span<const u8> args) {
+        auto sink_capture = reinterpret_cast<SinkCapture *>(user_data);
+
+        AU_UNUSED(timestamp_ns);
+
+        sink_capture->call_site = &call_site;
+        sink_capture->args.assign(args.begin(), args.end());
+        sink_capture->count++;
+      },
+      &capture);
+
+  for (Mut<u32> i = 0; i < 2; i++)
+  {
+    IA_LOG_WARN_DEFERRED("slot {} of {}", i, "queue");
+  }
+
+  logger::set_record_sink(nullptr, nullptr);
+
+  IAT_CHECK_EQ(capture.count, 2u);
+  IAT_CHECK(capture.call_site != nullptr);
+
+  // One descriptor per call site, registered once
+  Ref<logger::CallSite> call_site = *capture.call_site;
+  IAT_CHECK(logger::get_call_site(call_site.id) == &call_site);
+  IAT_CHECK(call_site.level == logger::Level::Warn);
+  IAT_CHECK_EQ(call_site.format, StringView("slot {} of {}"));
+  IAT_CHECK_EQ(call_site.arg_types.size(), static_cast<usize>(2));
+  IAT_CHECK(call_site.arg_types[0] == logger::ArgType::UInt);
+  IAT_CHECK(call_site.arg_types[1] == logger::ArgType::String);
+
+  const auto message = logger::format_encoded(call_site.format, call_site.arg_types, capture.args);
+  IAT_CHECK(message.has_value());
+  IAT_CHECK_EQ(*message, String("slot 1 of queue"));
+
+  // A block that does not match the descriptor is rejected
+  const Span<const u8> truncated(capture.args.data(), capture.args.size() - 1);
+  IAT_CHECK_NOT(logger::format_encoded(call_site.format, call_site.arg_types, truncated).has_value());
+
+  return true;
+}
+
+auto test_zero_allocation() -> bool
+{
+  Mut<u64> handled = 0;
+  logger::set_handler(
+      [](void *user_data, logger::Level level, StringView message, StringView file, u32 line) {
+        AU_UNUSED(level);
+        AU_UNUSED(file);
+        AU_UNUSED(line);
+
+        *reinterpret_cast<u64 *>(user_data) += message.size();
+      },
+      &handled);
+
+  const String long_text(logger::INLINE_FORMAT_SIZE * 4, 'x');
+
+  // The first long message grows the thread's format buffer, after that it is reused
+  IA_LOG_INFO("warm up {}", long_text);
+
+  const u64 allocations_before = get_thread_allocation_count();
+
+  for (Mut<i32> i = 0; i < 1000; i++)
+  {
+    IA_LOG_INFO("short {} {}", i, "message");
+    IA_LOG_WARN("long {} {}", i, long_text);
+  }
+
+  const u64 allocations = get_thread_allocation_count() - allocations_before;
+
+  logger::set_handler(nullptr, nullptr);
+
+  IAT_CHECK_EQ(allocations, static_cast<u64>(0));
+  IAT_CHECK(handled > long_text.size() * 1000);
+
+  return true;
+}
+
+auto test_nested_formatting() -> bool
+{
+  Mut<AsyncCapture> capture;
+
+  // A handler that logs itself must not clobber the message it was given
+  logger::set_handler(
+      [](void *user_data, logger::Level level, StringView message, StringView file, u32 line) {
+        auto nested_capture = reinterpret_cast<AsyncCapture *>(user_data);
+
+        AU_UNUSED(file);
+        AU_UNUSED(line);
+
+        if (level == logger::Level::Error)
+        {
+          IA_LOG_INFO("nested {}", String(logger::INLINE_FORMAT_SIZE, 'n'));
+        }
+        nested_capture->messages.emplace_back(message);
+      },
+      &capture);
+
+  const String long_text(logger::INLINE_FORMAT_SIZE, 'o');
+  IA_LOG_ERROR("outer {}", long_text);
+
+  logger::set_handler(nullptr, nullptr);
+
+  IAT_CHECK_EQ(capture.messages.size(), static_cast<usize>(2));
+  IAT_CHECK(capture.messages[0].starts_with("nested "));
+  IAT_CHECK_EQ(capture.messages[1], "outer " + long_text);
+
+  return true;
+}
+
+inline static Mut<u32> s_evaluations = 0;
+
+static auto count_evaluation() -> u32
+{
+  return ++s_evaluations;
+}
+
+auto test_level_threshold() -> bool
+{
+  Mut<AsyncCapture> capture;
+  logger::set_handler(capture_handler, &capture);
+
+  logger::set_level(logger::Level::Warn);
+  IAT_CHECK(logger::get_level() == logger::Level::Warn);
+
+  // Filtered records never evaluate their arguments
+  s_evaluations = 0;
+  IA_LOG_INFO("hidden {}", count_evaluation());
+  IA_LOG_INFO_DEFERRED("hidden {}", count_evaluation());
+  IAT_CHECK_EQ(s_evaluations, 0u);
+  IAT_CHECK(capture.messages.empty());
+
+  IA_LOG_WARN("shown {}", count_evaluation());
+  IA_LOG_ERROR_DEFERRED("shown {}", count_evaluation());
+  IAT_CHECK_EQ(s_evaluations, 2u);
+  IAT_CHECK_EQ(capture.messages.size(), static_cast<usize>(2));
+
+  logger::set_level(logger::Level::Trace);
+  logger::set_handler(nullptr, nullptr);
+
+  return true;
+}
+
+auto test_categories() -> bool
+{
+  Mut<AsyncCapture> capture;
+  logger::set_handler(capture_handler, &capture);
+
+  IAT_CHECK(logger::find_category("TestNet") == &TestNet);
+  IAT_CHECK(logger::find_category("TestStorage") == &TestStorage);
+  IAT_CHECK(logger::find_category("NoSuchCategory") == nullptr);
+
+  // Categories follow the global threshold until given their own
+  logger::set_level(logger::Level::Error);
+  IAT_CHECK_NOT(TestNet.get_level().has_value());
+  IA_LOG_INFO_CAT(TestNet, "net {}", 1);
+  IAT_CHECK(capture.messages.empty());
+
+  TestNet.set_level(logger::Level::Debug);
+  s_evaluations = 0;
+  IA_LOG_INFO_CAT(TestNet, "net {}", count_evaluation());
+  IA_LOG_INFO_CAT(TestStorage, "storage {}", count_evaluation());
+  IAT_CHECK_EQ(s_evaluations, 1u);
+  IAT_CHECK_EQ(capture.messages.size(), static_cast<usize>(1));
+  IAT_CHECK_EQ(capture.messages[0], String("net 1"));
+
+  TestNet.reset_level();
+  IA_LOG_INFO_CAT(TestNet, "net {}", 2);
+  IAT_CHECK_EQ(capture.messages.size(), static_cast<usize>(1));
+
+  logger::set_level(logger::Level::Trace);
+  logger::set_handler(nullptr, nullptr);
+
+  return true;
+}
+
+auto test_configure() -> bool
+{
+  IAT_CHECK(logger::configure("warn, TestNet=trace ,TestStorage=ERROR").has_value());
+  IAT_CHECK(logger::get_level() == logger::Level::Warn);
+  IAT_CHECK(TestNet.get_level() == logger::Level::Trace);
+  IAT_CHECK(TestStorage.get_level() == logger::Level::Error);
+
+  // Invalid specs change nothing
+  IAT_CHECK_NOT(logger::configure("info,TestNet=loud").has_value());
+  IAT_CHECK_NOT(logger::configure("info,Missing=debug").has_value());
+  IAT_CHECK_NOT(logger::configure("verbose").has_value());
+  IAT_CHECK(logger::get_level() == logger::Level::Warn);
+  IAT_CHECK(TestNet.get_level() == logger::Level::Trace);
+
+  IAT_CHECK(logger::configure("TestNet=default").has_value());
+  IAT_CHECK_NOT(TestNet.get_level().has_value());
+
+  IAT_CHECK(ia::env::set("IACRUX_TEST_LOG_LEVEL", "error,TestStorage=info").has_value());
+  IAT_CHECK(logger::configure_from_env("IACRUX_TEST_LOG_LEVEL").has_value());
+  IAT_CHECK(logger::get_level() == logger::Level::Error);
+  IAT_CHECK(TestStorage.get_level() == logger::Level::Info);
+  IAT_CHECK(ia::env::unset("IACRUX_TEST_LOG_LEVEL").has_value());
+
+  // Unset variables leave the configuration alone
+  IAT_CHECK(logger::configure_from_env("IACRUX_TEST_LOG_LEVEL").has_value());
+  IAT_CHECK(logger::get_level() == logger::Level::Error);
+
+  TestStorage.reset_level();
+  logger::set_level(logger::Level::Trace);
+
+  return true;
+}
+
+auto test_sinks() -> bool
+{
+  Mut<AsyncCapture> all;
+  Mut<AsyncCapture> errors;
+
+  logger::set_handler(logger::null_handler, nullptr);
+
+  auto all_id = logger::add_sink(capture_handler, &all);
+  auto errors_id = logger::add_sink(capture_handler, &errors, logger::Level::Error);
+  IAT_CHECK(all_id.has_value());
+  IAT_CHECK(errors_id.has_value());
+  IAT_CHECK(*all_id != *errors_id);
+
+  IA_LOG_INFO("info {}", 1);
+  IA_LOG_ERROR("error {}", 2);
+  IAT_CHECK_EQ(all.messages.size(), static_cast<usize>(2));
+  IAT_CHECK_EQ(errors.messages.size(), static_cast<usize>(1));
+  IAT_CHECK_EQ(errors.messages[0], String("error 2"));
+
+  IAT_CHECK(logger::set_sink_level(*all_id, logger::Level::Fatal));
+  IA_LOG_ERROR("error {}", 3);
+  IAT_CHECK_EQ(all.messages.size(), static_cast<usize>(2));
+  IAT_CHECK_EQ(errors.messages.size(), static_cast<usize>(2));
+
+  IAT_CHECK(logger::remove_sink(*errors_id));
+  IAT_CHECK_NOT(logger::remove_sink(*errors_id));
+  IAT_CHECK_NOT(logger::set_sink_level(*errors_id, logger::Level::Trace));
+  IA_LOG_FATAL("fatal {}", 4);
+  IAT_CHECK_EQ(all.messages.size(), static_cast<usize>(3));
+  IAT_CHECK_EQ(errors.messages.size(), static_cast<usize>(2));
+
+  // The registry is bounded
+  Mut<Vec<logger::SinkId>> extra;
+  while (true)
+  {
+    auto id = logger::add_sink(logger::null_handler, nullptr);
+    if (!id)
+    {
+      break;
+    }
+    extra.push_back(*id);
+  }
+  IAT_CHECK_EQ(extra.size(), static_cast<usize>(logger::MAX_SINKS - 1));
+
+  for (const logger::SinkId id : extra)
+  {
+    IAT_CHECK(logger::remove_sink(id));
+  }
+  IAT_CHECK(logger::remove_sink(*all_id));
+  logger::set_handler(nullptr, nullptr);
+
+  return true;
+}
+
+struct SlowSink
+{
+  Mut<std::atomic<u32>> inside{0};
+  Mut<std::atomic<u32>> calls{0};
+};
+
+static auto slow_sink_handler(void *user_data, logger::Level, StringView, StringView, u32) -> void
+{
+  auto sink = reinterpret_cast<SlowSink *>(user_data);
+  sink->inside.fetch_add(1);
+  sink->calls.fetch_add(1);
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  sink->inside.fetch_sub(1);
+}
+
+auto test_remove_sink_waits() -> bool
+{
+  Mut<SlowSink> sink;
+  logger::set_handler(logger::null_handler, nullptr);
+
+  auto id = logger::add_sink(slow_sink_handler, &sink);
+  IAT_CHECK(id.has_value());
+
+  Mut<std::atomic<bool>> running{true};
+  std::jthread writer([&running] {
+    while (running.load())
+    {
+      logger::dispatch(logger::Level::Info, "slow");
+    }
+  });
+
+  while (sink.calls.load() < 3)
+  {
+    std::this_thread::yield();
+  }
+
+  // Once remove_sink() returns, no call is left inside the sink and none starts
+  const bool removed = logger::remove_sink(*id);
+  const u32 inside = sink.inside.load();
+  const u32 calls = sink.calls.load();
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+  running.store(false);
+  writer.join();
+  logger::set_handler(nullptr, nullptr);
+
+  IAT_CHECK(removed);
+  IAT_CHECK_EQ(inside, 0u);
+  IAT_CHECK_EQ(sink.calls.load(), calls);
+
+  return true;
+}
+
+static auto log_limited(Mut<u32> &evaluated) -> void
+{
+  IA_LOG_WARN_ONCE("once {}", ++evaluated);
+}
+
+auto test_rate_limiting() -> bool
+{
+  Mut<AsyncCapture> capture;
+  logger::set_handler(capture_handler, &capture);
+
+  // Below the threshold the limiter is not consumed
+  Mut<u32> evaluated = 0;
+  logger::set_level(logger::Level::Error);
+  log_limited(evaluated);
+  logger::set_level(logger::Level::Trace);
+  IAT_CHECK(capture.messages.empty());
+
+  for (Mut<u32> i = 0; i < 10; i++)
+  {
+    log_limited(evaluated);
+  }
+  IAT_CHECK_EQ(evaluated, 1u);
+  IAT_CHECK_EQ(capture.messages.size(), static_cast<usize>(1));
+  IAT_CHECK_EQ(capture.messages[0], String("once 1"));
+
+  capture.messages.clear();
+  for (Mut<u32> i = 0; i < 7; i++)
+  {
+    IA_LOG_INFO_EVERY_N(3, "every {}", i);
+  }
+  IAT_CHECK_EQ(capture.messages.size(), static_cast<usize>(3));
+  IAT_CHECK_EQ(capture.messages[2], String("every 6"));
+
+  capture.messages.clear();
+  for (Mut<u32> i = 0; i < 100; i++)
+  {
+    IA_LOG_ERROR_RATE(5, "rate {}", i);
+  }
+  IAT_CHECK(capture.messages.size() >= 5);
+  IAT_CHECK(capture.messages.size() < 20);
+  IAT_CHECK_EQ(capture.messages[4], String("rate 4"));
+
+  logger::set_handler(nullptr, nullptr);
+
+  // Windows and the suppressed count, on a synthetic clock
+  constexpr u64 SECOND = logger::RateLimiter::WINDOW_NS;
+  Mut<logger::RateLimiter> limiter;
+  IAT_CHECK_EQ(limiter.try_acquire(2, 10 * SECOND), Option<u64>(0));
+  IAT_CHECK_EQ(limiter.try_acquire(2, 10 * SECOND + 1), Option<u64>(0));
+  IAT_CHECK_NOT(limiter.try_acquire(2, 10 * SECOND + 2).has_value());
+  IAT_CHECK_NOT(limiter.try_acquire(2, 10 * SECOND + 3).has_value());
+  IAT_CHECK_NOT(limiter.try_acquire(2, 11 * SECOND - 1).has_value());
+  IAT_CHECK_EQ(limiter.try_acquire(2, 11 * SECOND), Option<u64>(3));
+  IAT_CHECK_EQ(limiter.try_acquire(2, 11 * SECOND + 5), Option<u64>(0));
+
+  return true;
+}
+
+auto test_suppressed_summary() -> bool
+{
+  Mut<AsyncCapture> capture;
+  logger::set_handler(capture_handler, &capture);
+
+  logger::dispatch_limited(logger::Level::Warn, logger::make_site(), 0, "first");
+  logger::dispatch_limited(logger::Level::Warn, logger::make_site(), 41, "again {}", 2);
+
+  logger::set_handler(nullptr, nullptr);
+
+  IAT_CHECK_EQ(capture.messages.size(), static_cast<usize>(3));
+  IAT_CHECK_EQ(capture.messages[0], String("first"));
+  IAT_CHECK_EQ(capture.messages[1], String("suppressed 41 messages"));
+  IAT_CHECK_EQ(capture.messages[2], String("again 2"));
+
+  return true;
+}
+
+struct SiteCapture
+{
+  Mut<String> file{};
+  Mut<u32> line{};
+};
+
+auto test_compile_time_site() -> bool
+{
+  static_assert(logger::get_basename("/a/b/c.cpp") == "c.cpp");
+  static_assert(logger::get_basename("a\\b.cpp") == "b.cpp");
+  static_assert(logger::get_basename("plain.cpp") == "plain.cpp");
+
+  static constexpr logger::Site SITE = logger::make_site();
+  static_assert(SITE.file == "logger.cpp");
+
+  Mut<SiteCapture> capture;
+  logger::set_handler(
+      [](void *user_data, logger::Level level, StringView message, StringView file, u32 line) {
+        auto site_capture = reinterpret_cast<SiteCapture *>(user_data);
+
+        AU_UNUSED(level);
+        AU_UNUSED(message);
+
+        site_capture->file = String(file);
+        site_capture->line = line;
+      },
+      &capture);
+
+  const u32 expected_line = logger::make_site().line + 1;
+  IA_LOG_INFO("where {}", "am I");
+  IAT_CHECK_EQ(capture.file, String("logger.cpp"));
+  IAT_CHECK_EQ(capture.line, expected_line);
+
+  // Direct dispatch() calls get the basename too
+  logger::dispatch(logger::Level::Info, "direct");
+  IAT_CHECK_EQ(capture.file, String("logger.cpp"));
+
+  logger::set_handler(nullptr, nullptr);
+
+  return true;
+}
+
+#if IA_PLATFORM_UNIX
+auto test_console_output() -> bool
+{
+  Mut<int> pipe_fds[2];
+  IAT_CHECK_EQ(pipe(pipe_fds), 0);
+
+  std::cout.flush();
+  const int saved_stdout = dup(STDOUT_FILENO);
+  IAT_CHECK(saved_stdout >= 0);
+  IAT_CHECK(dup2(pipe_fds[1], STDOUT_FILENO) >= 0);
+
+  logger::set_handler(nullptr, nullptr);
+  IA_LOG_WARN("console {}", 42);
+
+  dup2(saved_stdout, STDOUT_FILENO);
+  close(saved_stdout);
+  close(pipe_fds[1]);
+
+  Mut<char> buffer[256];
+  const ssize_t size = read(pipe_fds[0], buffer, sizeof(buffer));
+  close(pipe_fds[0]);
+
+  IAT_CHECK(size > 0);
+  const StringView line(buffer, static_cast<usize>(size));
+
+  // The whole line arrives in one write
+  IAT_CHECK(line.find("[WARN] ") != StringView::npos);
+  IAT_CHECK(line.find("[logger.cpp:") != StringView::npos);
+  IAT_CHECK(line.ends_with("] console 42\n"));
+
+  return true;
+}
+
+auto test_verbosity_signal() -> bool
+{
+  IAT_CHECK(logger::install_verbosity_signal(SIGUSR1).has_value());
+
+  logger::set_level(logger::Level::Warn);
+
+  std::raise(SIGUSR1);
+  IAT_CHECK(logger::get_level() == logger::Level::Trace);
+
+  std::raise(SIGUSR1);
+  IAT_CHECK(logger::get_level() == logger::Level::Warn);
+
+  std::signal(SIGUSR1, SIG_DFL);
+  logger::set_level(logger::Level::Trace);
+
+  return true;
+}
+#endif
+
 IAT_BEGIN_TEST_LIST()
 
 IAT_ADD_TEST(test_file_logging);
 IAT_ADD_TEST(test_log_levels);
 IAT_ADD_TEST(test_formatting);
+IAT_ADD_TEST(test_zero_allocation);
+IAT_ADD_TEST(test_nested_formatting);
+IAT_ADD_TEST(test_async_logging);
+IAT_ADD_TEST(test_async_overflow);
+IAT_ADD_TEST(test_async_stop_race);
+IAT_ADD_TEST(test_flush_under_load);
+IAT_ADD_TEST(test_deferred_formatting);
+IAT_ADD_TEST(test_record_sink);
+IAT_ADD_TEST(test_level_threshold);
+IAT_ADD_TEST(test_categories);
+IAT_ADD_TEST(test_configure);
+IAT_ADD_TEST(test_sinks);
+IAT_ADD_TEST(test_remove_sink_waits);
+IAT_ADD_TEST(test_rate_limiting);
+IAT_ADD_TEST(test_suppressed_summary);
+IAT_ADD_TEST(test_compile_time_site);
+#if IA_PLATFORM_UNIX
+IAT_ADD_TEST(test_console_output);
+IAT_ADD_TEST(test_verbosity_signal);
+#endif
 
 IAT_END_TEST_LIST()
 
@@ -17,8 +17,57 @@
 
 #include <iatest/iatest.hpp>
 
+#include <cstdlib>
+#include <new>
+
 using namespace ia;
 
+// Counts every thread's heap allocations, so tests can assert that a path never allocates. Lives in its own
+// translation unit so the compiler cannot see new/delete pairs through it.
+static thread_local Mut<u64> t_allocation_count = 0;
+
+auto get_thread_allocation_count() -> u64
+{
+  return t_allocation_count;
+}
+
+auto operator new(std::size_t size) -> void *
+{
+  t_allocation_count++;
+
+  void *ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr)
+  {
+    std::abort();
+  }
+  return ptr;
+}
+
+auto operator new[](std::size_t size) -> void *
+{
+  return operator new(size);
+}
+
+auto operator delete(void *ptr) noexcept -> void
+{
+  std::free(ptr);
+}
+
+auto operator delete[](void *ptr) noexcept -> void
+{
+  operator delete(ptr);
+}
+
+auto operator delete(void *ptr, std::size_t) noexcept -> void
+{
+  operator delete(ptr);
+}
+
+auto operator delete[](void *ptr, std::size_t) noexcept -> void
+{
+  operator delete(ptr);
+}
+
 int main(int argc, char *argv[])
 {
   AU_UNUSED(argc);
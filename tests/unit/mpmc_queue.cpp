@@ -0,0 +1,154 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <crux/adt/mpmc_queue.hpp>
+#include <iatest/iatest.hpp>
+
+#include <memory>
+#include <thread>
+
+using namespace ia;
+
+IAT_BEGIN_BLOCK(Core, MpmcQueue)
+
+auto test_push_pop() -> bool
+{
+  Mut<MpmcQueue<u32, 4>> queue;
+  IAT_CHECK(queue.is_empty());
+  IAT_CHECK_NOT(queue.pop().has_value());
+
+  for (Mut<u32> lap = 0; lap < 3; lap++)
+  {
+    for (Mut<u32> i = 0; i < 4; i++)
+    {
+      IAT_CHECK(queue.push(lap * 4 + i));
+    }
+    IAT_CHECK_NOT(queue.push(99));
+    IAT_CHECK_EQ(queue.get_size(), static_cast<usize>(4));
+
+    for (Mut<u32> i = 0; i < 4; i++)
+    {
+      IAT_CHECK_EQ(*queue.pop(), lap * 4 + i);
+    }
+    IAT_CHECK_NOT(queue.pop().has_value());
+  }
+
+  return true;
+}
+
+auto test_move_only() -> bool
+{
+  Mut<MpmcQueue<std::unique_ptr<u32>, 2>> queue;
+
+  IAT_CHECK(queue.push(std::make_unique<u32>(7)));
+  IAT_CHECK(queue.emplace(new u32(8)));
+
+  Mut<std::unique_ptr<u32>> rejected = std::make_unique<u32>(9);
+  IAT_CHECK_NOT(queue.push(std::move(rejected)));
+  IAT_CHECK(rejected != nullptr);
+
+  const auto first = queue.pop();
+  IAT_CHECK(first.has_value());
+  IAT_CHECK_EQ(**first, static_cast<u32>(7));
+
+  return true;
+}
+
+auto test_concurrent() -> bool
+{
+  static constexpr const u32 PRODUCER_COUNT = 4;
+  static constexpr const u32 CONSUMER_COUNT = 4;
+  static constexpr const u32 ITEMS_PER_PRODUCER = 50000;
+
+  Mut<MpmcQueue<u64, 1024>> queue;
+
+  Mut<Vec<std::thread>> threads;
+  for (Mut<u32> p = 0; p < PRODUCER_COUNT; p++)
+  {
+    threads.emplace_back([&queue, p]() {
+      for (Mut<u32> i = 0; i < ITEMS_PER_PRODUCER;)
+      {
+        if (queue.push((static_cast<u64>(p) << 32) | i))
+        {
+          i++;
+        }
+      }
+    });
+  }
+
+  // Every consumer sees each producer's items in order, and the sums prove nothing was lost or duplicated
+  Mut<std::atomic<u32>> received{0};
+  Mut<std::atomic<u64>> sum{0};
+  Mut<std::atomic<bool>> in_order{true};
+
+  for (Mut<u32> c = 0; c < CONSUMER_COUNT; c++)
+  {
+    threads.emplace_back([&]() {
+      Mut<i64> last_seen[PRODUCER_COUNT];
+      for (auto &last : last_seen)
+      {
+        last = -1;
+      }
+
+      while (received.load() < PRODUCER_COUNT * ITEMS_PER_PRODUCER)
+      {
+        const auto value = queue.pop();
+        if (!value.has_value())
+        {
+          continue;
+        }
+
+        const u32 producer = static_cast<u32>(*value >> 32);
+        const i64 index = static_cast<i64>(*value & 0xFFFFFFFF);
+        if (producer >= PRODUCER_COUNT || index <= last_seen[producer])
+        {
+          in_order = false;
+        }
+        else
+        {
+          last_seen[producer] = index;
+        }
+
+        sum += static_cast<u64>(index);
+        received++;
+      }
+    });
+  }
+
+  for (auto &t : threads)
+  {
+    t.join();
+  }
+
+  const u64 expected_sum =
+      static_cast<u64>(PRODUCER_COUNT) * (static_cast<u64>(ITEMS_PER_PRODUCER) * (ITEMS_PER_PRODUCER - 1) / 2);
+
+  IAT_CHECK(in_order.load());
+  IAT_CHECK_EQ(received.load(), PRODUCER_COUNT * ITEMS_PER_PRODUCER);
+  IAT_CHECK_EQ(sum.load(), expected_sum);
+  IAT_CHECK(queue.is_empty());
+
+  return true;
+}
+
+IAT_BEGIN_TEST_LIST()
+IAT_ADD_TEST(test_push_pop);
+IAT_ADD_TEST(test_move_only);
+IAT_ADD_TEST(test_concurrent);
+IAT_END_TEST_LIST()
+
+IAT_END_BLOCK()
+
+IAT_REGISTER_ENTRY(Core, MpmcQueue)
@@ -0,0 +1,181 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <crux/adt/mpsc_ring_buffer.hpp>
+#include <iatest/iatest.hpp>
+
+#include <thread>
+
+using namespace ia;
+
+IAT_BEGIN_BLOCK(Core, MpscRingBuffer)
+
+auto make_memory(const usize capacity) -> Vec<u64>
+{
+  // u64 storage keeps the data region 8 byte aligned
+  return Vec<u64>((sizeof(MpscRingBufferView::ControlBlock) + capacity) / sizeof(u64));
+}
+
+auto as_bytes(MutRef<Vec<u64>> memory) -> Span<u8>
+{
+  return Span<u8>(reinterpret_cast<u8 *>(memory.data()), memory.size() * sizeof(u64));
+}
+
+auto test_push_pop() -> bool
+{
+  Mut<Vec<u64>> memory = make_memory(64);
+  auto rb_res = MpscRingBufferView::create(as_bytes(memory), true);
+  IAT_CHECK(rb_res.has_value());
+  Mut<MpscRingBufferView> rb = *rb_res;
+
+  const u8 payload[] = {1, 2, 3, 4, 5};
+  IAT_CHECK(rb.push(9, payload).has_value());
+
+  Mut<MpscRingBufferView::PacketHeader> header;
+  Mut<u8> out[16] = {};
+  const auto pop_res = rb.pop(header, out);
+  IAT_CHECK(pop_res.has_value() && pop_res->has_value());
+  IAT_CHECK_EQ(**pop_res, static_cast<usize>(5));
+  IAT_CHECK_EQ(header.id, static_cast<u16>(9));
+  IAT_CHECK_EQ(out[4], static_cast<u8>(5));
+
+  // pop() skips PACKET_ID_SKIP records, so the id is refused up front
+  IAT_CHECK_NOT(rb.push(MpscRingBufferView::PACKET_ID_SKIP, payload).has_value());
+
+  const auto empty_res = rb.pop(header, out);
+  IAT_CHECK(empty_res.has_value());
+  IAT_CHECK_NOT(empty_res->has_value());
+
+  return true;
+}
+
+auto test_uncommitted_blocks_consumer() -> bool
+{
+  Mut<Vec<u64>> memory = make_memory(128);
+  Mut<MpscRingBufferView> rb = *MpscRingBufferView::create(as_bytes(memory), true);
+
+  const auto first = rb.reserve(1, 4);
+  IAT_CHECK(first.has_value());
+
+  const u8 payload[] = {7, 7};
+  IAT_CHECK(rb.push(2, payload).has_value());
+
+  // The second packet is committed, but sits behind a claimed, unfinished record
+  IAT_CHECK_EQ(rb.consume_all([](Ref<MpscRingBufferView::PacketView>) {}), static_cast<usize>(0));
+
+  rb.commit(*first);
+
+  Mut<Vec<u16>> ids;
+  rb.consume_all([&](Ref<MpscRingBufferView::PacketView> packet) { ids.push_back(packet.header.id); });
+  IAT_CHECK(ids == (Vec<u16>{1, 2}));
+
+  return true;
+}
+
+auto test_wrap_and_full() -> bool
+{
+  Mut<Vec<u64>> memory = make_memory(64);
+  Mut<MpscRingBufferView> rb = *MpscRingBufferView::create(as_bytes(memory), true);
+
+  Mut<MpscRingBufferView::PacketHeader> header;
+  Mut<u8> out[64] = {};
+  const u8 payload[24] = {};
+
+  // Records of 32 and 24 bytes leave an 8 byte tail
+  IAT_CHECK(rb.push(1, payload).has_value());
+  IAT_CHECK(rb.push(2, Span<const u8>(payload).first(16)).has_value());
+  IAT_CHECK_NOT(rb.push(3, Span<const u8>(payload).first(8)).has_value());
+
+  IAT_CHECK(rb.pop(header, out).has_value());
+  IAT_CHECK_EQ(header.id, static_cast<u16>(1));
+
+  // The next record does not fit in the tail, so the tail is padded and the record starts over at offset 0
+  const auto reservation = rb.reserve(3, 8);
+  IAT_CHECK(reservation.has_value());
+  IAT_CHECK_EQ(reservation->offset, static_cast<u32>(0));
+  rb.commit(*reservation);
+
+  IAT_CHECK(rb.pop(header, out).has_value());
+  IAT_CHECK_EQ(header.id, static_cast<u16>(2));
+  IAT_CHECK(rb.pop(header, out).has_value());
+  IAT_CHECK_EQ(header.id, static_cast<u16>(3));
+
+  const auto empty_res = rb.pop(header, out);
+  IAT_CHECK(empty_res.has_value());
+  IAT_CHECK_NOT(empty_res->has_value());
+
+  return true;
+}
+
+auto test_concurrent_producers() -> bool
+{
+  static constexpr const u32 PRODUCER_COUNT = 4;
+  static constexpr const u32 PACKETS_PER_PRODUCER = 20000;
+
+  Mut<Vec<u64>> memory = make_memory(4096);
+  Mut<MpscRingBufferView> rb = *MpscRingBufferView::create(as_bytes(memory), true);
+
+  Mut<Vec<std::thread>> producers;
+  for (Mut<u32> p = 0; p < PRODUCER_COUNT; p++)
+  {
+    producers.emplace_back([&rb, p]() {
+      for (Mut<u32> i = 0; i < PACKETS_PER_PRODUCER;)
+      {
+        const u32 value = i;
+        const auto data = Span<const u8>(reinterpret_cast<const u8 *>(&value), sizeof(value));
+        if (rb.push(static_cast<u16>(p + 1), data).has_value())
+        {
+          i++;
+        }
+      }
+    });
+  }
+
+  Mut<u32> next_expected[PRODUCER_COUNT] = {};
+  Mut<u32> received = 0;
+  Mut<bool> in_order = true;
+
+  while (received < PRODUCER_COUNT * PACKETS_PER_PRODUCER)
+  {
+    received += static_cast<u32>(rb.consume_all([&](Ref<MpscRingBufferView::PacketView> packet) {
+      Mut<u32> value = 0;
+      std::memcpy(&value, packet.first.data(), sizeof(value));
+
+      const u32 producer = packet.header.id - 1u;
+      in_order = in_order && producer < PRODUCER_COUNT && value == next_expected[producer];
+      next_expected[producer % PRODUCER_COUNT]++;
+    }));
+  }
+
+  for (auto &t : producers)
+  {
+    t.join();
+  }
+
+  IAT_CHECK(in_order);
+
+  return true;
+}
+
+IAT_BEGIN_TEST_LIST()
+IAT_ADD_TEST(test_push_pop);
+IAT_ADD_TEST(test_uncommitted_blocks_consumer);
+IAT_ADD_TEST(test_wrap_and_full);
+IAT_ADD_TEST(test_concurrent_producers);
+IAT_END_TEST_LIST()
+
+IAT_END_BLOCK()
+
+IAT_REGISTER_ENTRY(Core, MpscRingBuffer)
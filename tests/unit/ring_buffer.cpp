@@ -0,0 +1,692 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <crux/adt/ring_buffer.hpp>
+#include <iatest/iatest.hpp>
+
+#include <thread>
+
+using namespace ia;
+
+IAT_BEGIN_BLOCK(Core, RingBuffer)
+
+static constexpr const usize BUFFER_SIZE = sizeof(RingBufferView::ControlBlock) + 64;
+
+auto make_payload(const usize size, const u8 seed) -> Vec<u8>
+{
+  Mut<Vec<u8>> data(size);
+  for (Mut<usize> i = 0; i < size; i++)
+  {
+    data[i] = static_cast<u8>(seed + i);
+  }
+  return data;
+}
+
+auto test_push_pop() -> bool
+{
+  Mut<Vec<u8>> memory(BUFFER_SIZE);
+  auto rb_res = RingBufferView::create(Span<u8>(memory), true);
+  IAT_CHECK(rb_res.has_value());
+  Mut<RingBufferView> rb = *rb_res;
+
+  const Vec<u8> payload = make_payload(10, 1);
+  IAT_CHECK(rb.push(7, payload).has_value());
+
+  Mut<RingBufferView::PacketHeader> header;
+  Mut<Vec<u8>> out(64);
+  const auto pop_res = rb.pop(header, Span<u8>(out));
+  IAT_CHECK(pop_res.has_value());
+  IAT_CHECK(pop_res->has_value());
+  IAT_CHECK_EQ(**pop_res, static_cast<usize>(10));
+  IAT_CHECK_EQ(header.id, static_cast<u16>(7));
+  IAT_CHECK(std::equal(payload.begin(), payload.end(), out.begin()));
+
+  const auto empty_res = rb.pop(header, Span<u8>(out));
+  IAT_CHECK(empty_res.has_value());
+  IAT_CHECK_NOT(empty_res->has_value());
+
+  return true;
+}
+
+auto test_reserve_commit() -> bool
+{
+  Mut<Vec<u8>> memory(BUFFER_SIZE);
+  Mut<RingBufferView> rb = *RingBufferView::create(Span<u8>(memory), true);
+
+  Mut<RingBufferView::PacketHeader> header;
+  Mut<Vec<u8>> out(64);
+
+  const auto span_res = rb.reserve(3, 8);
+  IAT_CHECK(span_res.has_value());
+  std::memset(span_res->data(), 0xAB, span_res->size());
+
+  // Nothing is visible until the reservation is committed
+  const auto hidden_res = rb.pop(header, Span<u8>(out));
+  IAT_CHECK(hidden_res.has_value());
+  IAT_CHECK_NOT(hidden_res->has_value());
+
+  rb.commit();
+
+  const auto pop_res = rb.pop(header, Span<u8>(out));
+  IAT_CHECK(pop_res.has_value() && pop_res->has_value());
+  IAT_CHECK_EQ(header.id, static_cast<u16>(3));
+  IAT_CHECK_EQ(**pop_res, static_cast<usize>(8));
+  IAT_CHECK_EQ(out[7], static_cast<u8>(0xAB));
+
+  return true;
+}
+
+auto test_reserve_wrap_is_contiguous() -> bool
+{
+  Mut<Vec<u8>> memory(BUFFER_SIZE);
+  Mut<RingBufferView> rb = *RingBufferView::create(Span<u8>(memory), true);
+
+  Mut<RingBufferView::PacketHeader> header;
+  Mut<Vec<u8>> out(64);
+
+  // Move the cursors close to the end of the 64 byte data region
+  const Vec<u8> filler = make_payload(46, 0);
+  IAT_CHECK(rb.push(1, filler).has_value());
+  IAT_CHECK(rb.pop(header, Span<u8>(out)).has_value());
+
+  const auto span_res = rb.reserve(2, 20);
+  IAT_CHECK(span_res.has_value());
+
+  const u8 *data_begin = memory.data() + sizeof(RingBufferView::ControlBlock);
+  IAT_CHECK(span_res->data() + span_res->size() <= data_begin + 64);
+
+  const Vec<u8> payload = make_payload(20, 9);
+  std::memcpy(span_res->data(), payload.data(), payload.size());
+  rb.commit();
+
+  const auto pop_res = rb.pop(header, Span<u8>(out));
+  IAT_CHECK(pop_res.has_value() && pop_res->has_value());
+  IAT_CHECK_EQ(header.id, static_cast<u16>(2));
+  IAT_CHECK(std::equal(payload.begin(), payload.end(), out.begin()));
+
+  return true;
+}
+
+auto test_peek_consume() -> bool
+{
+  Mut<Vec<u8>> memory(BUFFER_SIZE);
+  Mut<RingBufferView> rb = *RingBufferView::create(Span<u8>(memory), true);
+
+  const Vec<u8> first = make_payload(6, 1);
+  const Vec<u8> second = make_payload(3, 50);
+  IAT_CHECK(rb.push(4, first).has_value());
+  IAT_CHECK(rb.push(5, second).has_value());
+
+  const auto packet_a = rb.peek();
+  IAT_CHECK(packet_a.has_value());
+  IAT_CHECK_EQ(packet_a->header.id, static_cast<u16>(4));
+  IAT_CHECK_EQ(packet_a->first.size(), static_cast<usize>(6));
+  IAT_CHECK(packet_a->second.empty());
+  IAT_CHECK(std::equal(first.begin(), first.end(), packet_a->first.begin()));
+
+  const auto packet_b = rb.peek();
+  IAT_CHECK(packet_b.has_value());
+  IAT_CHECK_EQ(packet_b->header.id, static_cast<u16>(5));
+
+  IAT_CHECK_NOT(rb.peek().has_value());
+
+  // Nothing is released until consume(), so the producer still sees the ring as occupied
+  const u64 read_before = rb.get_control_block()->consumer.read_offset.load();
+  IAT_CHECK_EQ(read_before, static_cast<u64>(0));
+
+  rb.consume();
+  IAT_CHECK_EQ(rb.get_control_block()->consumer.read_offset.load(),
+               rb.get_control_block()->producer.write_offset.load());
+
+  return true;
+}
+
+auto test_peek_wrapped_payload() -> bool
+{
+  Mut<Vec<u8>> memory(BUFFER_SIZE);
+  Mut<RingBufferView> rb = *RingBufferView::create(Span<u8>(memory), true);
+
+  Mut<RingBufferView::PacketHeader> header;
+  Mut<Vec<u8>> out(64);
+
+  const Vec<u8> filler = make_payload(50, 0);
+  IAT_CHECK(rb.push(1, filler).has_value());
+  IAT_CHECK(rb.pop(header, Span<u8>(out)).has_value());
+
+  // push() keeps the legacy wrapped framing, so this payload straddles the end of the buffer
+  const Vec<u8> payload = make_payload(20, 7);
+  IAT_CHECK(rb.push(2, payload).has_value());
+
+  const auto packet = rb.peek();
+  IAT_CHECK(packet.has_value());
+  IAT_CHECK_NOT(packet->second.empty());
+  IAT_CHECK_EQ(packet->first.size() + packet->second.size(), static_cast<usize>(20));
+
+  Mut<Vec<u8>> joined(packet->first.begin(), packet->first.end());
+  joined.insert(joined.end(), packet->second.begin(), packet->second.end());
+  IAT_CHECK(joined == payload);
+
+  rb.consume();
+  IAT_CHECK_NOT(rb.peek().has_value());
+
+  return true;
+}
+
+auto test_batch() -> bool
+{
+  Mut<Vec<u8>> memory(BUFFER_SIZE);
+  Mut<RingBufferView> rb = *RingBufferView::create(Span<u8>(memory), true);
+
+  const Vec<u8> payload = make_payload(12, 3);
+  const RingBufferView::Packet packets[] = {{1, payload}, {2, payload}, {3, payload}, {4, payload}, {5, payload}};
+
+  // Only three 16 byte records fit into the 64 byte data region
+  const auto push_res = rb.push_batch(packets);
+  IAT_CHECK(push_res.has_value());
+  IAT_CHECK_EQ(*push_res, static_cast<usize>(3));
+
+  Mut<Vec<u16>> ids;
+  Mut<usize> total_bytes = 0;
+  const usize consumed = rb.consume_all([&](Ref<RingBufferView::PacketView> packet) {
+    ids.push_back(packet.header.id);
+    total_bytes += packet.first.size() + packet.second.size();
+  });
+
+  IAT_CHECK_EQ(consumed, static_cast<usize>(3));
+  IAT_CHECK(ids == (Vec<u16>{1, 2, 3}));
+  IAT_CHECK_EQ(total_bytes, payload.size() * 3);
+
+  const auto rest_res = rb.push_batch(Span<const RingBufferView::Packet>(packets).subspan(3));
+  IAT_CHECK(rest_res.has_value());
+  IAT_CHECK_EQ(*rest_res, static_cast<usize>(2));
+  IAT_CHECK_EQ(rb.consume_all([](Ref<RingBufferView::PacketView>) {}, 1), static_cast<usize>(1));
+  IAT_CHECK_EQ(rb.consume_all([](Ref<RingBufferView::PacketView>) {}), static_cast<usize>(1));
+  IAT_CHECK_EQ(rb.consume_all([](Ref<RingBufferView::PacketView>) {}), static_cast<usize>(0));
+
+  return true;
+}
+
+auto test_cached_cursors() -> bool
+{
+  Mut<Vec<u8>> memory(BUFFER_SIZE);
+  Mut<RingBufferView> rb = *RingBufferView::create(Span<u8>(memory), true);
+  Mut<RingBufferView::ControlBlock *> cb = rb.get_control_block();
+
+  Mut<RingBufferView::PacketHeader> header;
+  Mut<Vec<u8>> out(64);
+
+  const Vec<u8> payload = make_payload(20, 0);
+  IAT_CHECK(rb.push(1, payload).has_value());
+  IAT_CHECK(rb.pop(header, Span<u8>(out)).has_value());
+
+  // The consumer refreshed its copy of write_offset only because its old copy said the ring was empty
+  IAT_CHECK_EQ(cb->consumer.cached_write_offset, cb->producer.write_offset.load());
+
+  // There was room without looking at read_offset, so the producer's copy is still stale
+  IAT_CHECK(rb.push(2, payload).has_value());
+  IAT_CHECK_EQ(cb->producer.cached_read_offset, static_cast<u64>(0));
+
+  // Running out of known free space forces a reload, after which the push fits
+  IAT_CHECK(rb.push(3, payload).has_value());
+  IAT_CHECK_EQ(cb->producer.cached_read_offset, cb->consumer.read_offset.load());
+
+  return true;
+}
+
+auto test_threaded_transfer() -> bool
+{
+  static constexpr const u32 PACKET_COUNT = 100000;
+
+  Mut<Vec<u8>> memory(sizeof(RingBufferView::ControlBlock) + 1024);
+  Mut<RingBufferView> producer = *RingBufferView::create(Span<u8>(memory), true);
+  Mut<RingBufferView> consumer = *RingBufferView::create(Span<u8>(memory), false);
+
+  Mut<std::thread> producer_thread([&]() {
+    for (Mut<u32> i = 0; i < PACKET_COUNT;)
+    {
+      const u32 value = i;
+      const auto data = Span<const u8>(reinterpret_cast<const u8 *>(&value), sizeof(value));
+      if (producer.push(static_cast<u16>(1 + (i % 100)), data).has_value())
+      {
+        i++;
+      }
+    }
+  });
+
+  Mut<u32> expected = 0;
+  Mut<bool> in_order = true;
+  Mut<RingBufferView::PacketHeader> header;
+  Mut<u32> value = 0;
+
+  while (expected < PACKET_COUNT)
+  {
+    const auto res = consumer.pop(header, Span<u8>(reinterpret_cast<u8 *>(&value), sizeof(value)));
+    if (!res.has_value() || !res->has_value())
+    {
+      continue;
+    }
+
+    in_order = in_order && (value == expected) && (header.id == 1 + (expected % 100));
+    expected++;
+  }
+
+  producer_thread.join();
+
+  IAT_CHECK(in_order);
+
+  return true;
+}
+
+auto test_wait() -> bool
+{
+  Mut<Vec<u8>> memory(BUFFER_SIZE);
+  Mut<RingBufferView> producer = *RingBufferView::create(Span<u8>(memory), true, RingBufferView::FLAG_WAITABLE);
+  Mut<RingBufferView> consumer = *RingBufferView::create(Span<u8>(memory), false);
+
+  Mut<RingBufferView::PacketHeader> header;
+  Mut<Vec<u8>> out(64);
+
+  // Times out on an empty ring
+  const auto timeout_res = consumer.pop_wait(header, Span<u8>(out), 1);
+  IAT_CHECK(timeout_res.has_value());
+  IAT_CHECK_NOT(timeout_res->has_value());
+
+  // Wakes up when the producer publishes
+  Mut<std::thread> producer_thread([&]() {
+    utils::sleep(20);
+    const u8 payload[] = {42};
+    (void) producer.push(8, payload);
+  });
+
+  const auto pop_res = consumer.pop_wait(header, Span<u8>(out), 5000);
+  producer_thread.join();
+
+  IAT_CHECK(pop_res.has_value() && pop_res->has_value());
+  IAT_CHECK_EQ(header.id, static_cast<u16>(8));
+  IAT_CHECK_EQ(out[0], static_cast<u8>(42));
+
+  // A full ring makes the producer wait for the consumer
+  const Vec<u8> payload = make_payload(40, 0);
+  IAT_CHECK(producer.push(1, payload).has_value());
+  IAT_CHECK_NOT(producer.push_wait(2, payload, 1).has_value());
+
+  Mut<std::thread> consumer_thread([&]() {
+    utils::sleep(20);
+    (void) consumer.pop(header, Span<u8>(out));
+  });
+
+  const auto push_res = producer.push_wait(2, payload, 5000);
+  consumer_thread.join();
+  IAT_CHECK(push_res.has_value());
+
+  return true;
+}
+
+auto test_wait_requires_flag() -> bool
+{
+  Mut<Vec<u8>> memory(BUFFER_SIZE);
+  Mut<RingBufferView> rb = *RingBufferView::create(Span<u8>(memory), true);
+
+  Mut<RingBufferView::PacketHeader> header;
+  Mut<Vec<u8>> out(64);
+  IAT_CHECK_NOT(rb.pop_wait(header, Span<u8>(out), 1).has_value());
+
+  return true;
+}
+
+auto test_reserved_ids() -> bool
+{
+  Mut<Vec<u8>> memory(BUFFER_SIZE);
+  Mut<RingBufferView> rb = *RingBufferView::create(Span<u8>(memory), true);
+
+  const Vec<u8> payload = make_payload(8, 0);
+  for (const u16 id : {RingBufferView::PACKET_ID_SKIP, RingBufferView::PACKET_ID_FRAGMENT})
+  {
+    IAT_CHECK_NOT(rb.push(id, payload).has_value());
+    IAT_CHECK_NOT(rb.reserve(id, 8).has_value());
+
+    const RingBufferView::Packet packets[] = {{1, payload}, {id, payload}};
+    IAT_CHECK_NOT(rb.push_batch(packets).has_value());
+  }
+
+  // Nothing was written
+  Mut<RingBufferView::PacketHeader> header;
+  Mut<Vec<u8>> out(64);
+  const auto pop_res = rb.pop(header, Span<u8>(out));
+  IAT_CHECK(pop_res.has_value());
+  IAT_CHECK_NOT(pop_res->has_value());
+
+  return true;
+}
+
+auto test_full() -> bool
+{
+  Mut<Vec<u8>> memory(BUFFER_SIZE);
+  Mut<RingBufferView> rb = *RingBufferView::create(Span<u8>(memory), true);
+
+  const Vec<u8> payload = make_payload(40, 0);
+  IAT_CHECK(rb.push(1, payload).has_value());
+  IAT_CHECK_NOT(rb.push(1, payload).has_value());
+  IAT_CHECK_NOT(rb.reserve(1, 40).has_value());
+
+  return true;
+}
+
+auto test_large_transfer() -> bool
+{
+  static constexpr const usize MESSAGE_SIZE = 300000;
+
+  // Far smaller than the message, which has to stream through
+  Mut<Vec<u8>> memory(sizeof(RingBufferView::ControlBlock) + 1024);
+  Mut<RingBufferView> producer = *RingBufferView::create(Span<u8>(memory), true, RingBufferView::FLAG_WAITABLE);
+  Mut<RingBufferView> consumer = *RingBufferView::create(Span<u8>(memory), false);
+
+  const Vec<u8> message = make_payload(MESSAGE_SIZE, 9);
+
+  Mut<std::thread> producer_thread([&]() { (void) producer.push_large(12, message, 5000); });
+
+  Mut<Vec<u8>> received(MESSAGE_SIZE);
+  Mut<usize> fragments = 0;
+  Mut<bool> ids_match = true;
+  const auto pop_res = consumer.pop_large(
+      [&](Ref<RingBufferView::Fragment> fragment) {
+        ids_match = ids_match && fragment.id == 12 && fragment.total_size == MESSAGE_SIZE;
+        std::memcpy(received.data() + fragment.offset, fragment.data.data(), fragment.data.size());
+        fragments++;
+      },
+      5000);
+
+  producer_thread.join();
+
+  IAT_CHECK(pop_res.has_value());
+  IAT_CHECK(pop_res->has_value());
+  IAT_CHECK_EQ(**pop_res, static_cast<u32>(MESSAGE_SIZE));
+  IAT_CHECK(ids_match);
+  IAT_CHECK(fragments > 1);
+  IAT_CHECK(received == message);
+
+  // Small messages go out as plain packets
+  const Vec<u8> small = make_payload(100, 1);
+  IAT_CHECK(producer.push_large(13, small, 0).has_value());
+
+  Mut<RingBufferView::PacketHeader> header;
+  Mut<Vec<u8>> out(128);
+  const auto small_res = consumer.pop(header, Span<u8>(out));
+  IAT_CHECK(small_res.has_value() && small_res->has_value());
+  IAT_CHECK_EQ(header.id, static_cast<u16>(13));
+
+  IAT_CHECK_NOT(producer.push_large(RingBufferView::PACKET_ID_FRAGMENT, small, 0).has_value());
+
+  return true;
+}
+
+auto test_large_truncated() -> bool
+{
+  Mut<Vec<u8>> memory(sizeof(RingBufferView::ControlBlock) + 1024);
+  Mut<RingBufferView> producer = *RingBufferView::create(Span<u8>(memory), true, RingBufferView::FLAG_WAITABLE);
+  Mut<RingBufferView> consumer = *RingBufferView::create(Span<u8>(memory), false);
+
+  // Nobody reads, so only the first fragments make it in
+  const Vec<u8> message = make_payload(4000, 0);
+  IAT_CHECK_NOT(producer.push_large(3, message, 1).has_value());
+
+  Mut<usize> received = 0;
+  const auto on_fragment = [&](Ref<RingBufferView::Fragment> fragment) { received += fragment.data.size(); };
+
+  IAT_CHECK_NOT(consumer.pop_large(on_fragment, 1).has_value());
+  IAT_CHECK(received > 0);
+  IAT_CHECK(received < message.size());
+
+  // The next message comes through whole
+  const u8 payload[] = {1, 2, 3};
+  IAT_CHECK(producer.push(4, payload).has_value());
+  received = 0;
+  const auto pop_res = consumer.pop_large(on_fragment, 1);
+  IAT_CHECK(pop_res.has_value() && pop_res->has_value());
+  IAT_CHECK_EQ(**pop_res, static_cast<u32>(3));
+  IAT_CHECK_EQ(received, static_cast<usize>(3));
+
+  return true;
+}
+
+auto test_aligned() -> bool
+{
+  Mut<Vec<u8>> memory(sizeof(RingBufferView::ControlBlock) + 256);
+  auto rb_res = RingBufferView::create(Span<u8>(memory), true, RingBufferView::FLAG_ALIGNED);
+  IAT_CHECK(rb_res.has_value());
+  Mut<RingBufferView> rb = *rb_res;
+  Mut<RingBufferView> consumer = *RingBufferView::create(Span<u8>(memory), false);
+  Mut<RingBufferView::ControlBlock *> cb = rb.get_control_block();
+
+  Mut<RingBufferView::PacketHeader> header;
+  Mut<Vec<u8>> out(64);
+  Mut<bool> aligned = true;
+
+  // Odd sizes through every write path, wrapping the ring many times
+  for (Mut<u32> i = 0; i < 200; i++)
+  {
+    const Vec<u8> data = make_payload(1 + (i * 5) % 37, static_cast<u8>(i));
+
+    if (i % 2 == 0)
+    {
+      IAT_CHECK(rb.push(static_cast<u16>(i + 1), data).has_value());
+      aligned = aligned && cb->producer.write_offset.load() % RingBufferView::ALIGNED_RECORD_ALIGNMENT == 0;
+
+      const auto pop_res = consumer.pop(header, Span<u8>(out));
+      IAT_CHECK(pop_res.has_value() && pop_res->has_value());
+      IAT_CHECK_EQ(header.id, static_cast<u16>(i + 1));
+      IAT_CHECK(std::equal(data.begin(), data.end(), out.begin()));
+    }
+    else
+    {
+      const auto span_res = rb.reserve(static_cast<u16>(i + 1), data.size());
+      IAT_CHECK(span_res.has_value());
+      std::memcpy(span_res->data(), data.data(), data.size());
+      rb.commit();
+
+      const auto packet = consumer.peek();
+      IAT_CHECK(packet.has_value());
+      IAT_CHECK_EQ(packet->header.id, static_cast<u16>(i + 1));
+      IAT_CHECK(std::equal(data.begin(), data.end(), packet->first.begin()));
+      const usize address = reinterpret_cast<usize>(packet->first.data());
+      aligned = aligned && address % RingBufferView::ALIGNED_RECORD_ALIGNMENT == 0;
+      consumer.consume();
+    }
+  }
+
+  IAT_CHECK(aligned);
+
+  // Copied payloads that would run past the end of the buffer start over at offset 0 too
+  Mut<Vec<u8>> wrap_memory(sizeof(RingBufferView::ControlBlock) + 256);
+  Mut<RingBufferView> wrap_rb = *RingBufferView::create(Span<u8>(wrap_memory), true, RingBufferView::FLAG_ALIGNED);
+  Mut<RingBufferView> wrap_consumer = *RingBufferView::create(Span<u8>(wrap_memory), false);
+
+  Mut<Vec<u8>> wrap_out(256);
+  for (Mut<u16> id = 1; id <= 2; id++)
+  {
+    IAT_CHECK(wrap_rb.push(id, make_payload(100, static_cast<u8>(id))).has_value());
+    const auto pop_res = wrap_consumer.pop(header, Span<u8>(wrap_out));
+    IAT_CHECK(pop_res.has_value() && pop_res->has_value());
+  }
+
+  const Vec<u8> wrapped = make_payload(64, 2);
+  IAT_CHECK(wrap_rb.push(3, wrapped).has_value());
+
+  const auto wrapped_packet = wrap_consumer.peek();
+  IAT_CHECK(wrapped_packet.has_value());
+  IAT_CHECK_EQ(wrapped_packet->header.id, static_cast<u16>(3));
+  IAT_CHECK_EQ(wrapped_packet->first.size(), wrapped.size());
+  IAT_CHECK(wrapped_packet->second.empty());
+  IAT_CHECK(std::equal(wrapped.begin(), wrapped.end(), wrapped_packet->first.begin()));
+  wrap_consumer.consume();
+
+  // A payload that could never be placed contiguously once the ring has drained is refused up front
+  IAT_CHECK_EQ(wrap_rb.get_max_payload(), 120u);
+  IAT_CHECK_NOT(wrap_rb.push(4, make_payload(121, 4)).has_value());
+
+  Mut<Vec<u8>> odd_memory(sizeof(RingBufferView::ControlBlock) + 252);
+  IAT_CHECK_NOT(RingBufferView::create(Span<u8>(odd_memory), true, RingBufferView::FLAG_ALIGNED).has_value());
+
+  return true;
+}
+
+auto test_streaming_copy() -> bool
+{
+  Mut<Vec<u8>> memory(sizeof(RingBufferView::ControlBlock) + 32768);
+  Mut<RingBufferView> rb = *RingBufferView::create(Span<u8>(memory), true, RingBufferView::FLAG_STREAMING_COPY);
+
+  Mut<RingBufferView::PacketHeader> header;
+  Mut<Vec<u8>> out(20000);
+
+  for (Mut<u32> i = 0; i < 10; i++)
+  {
+    const Vec<u8> data = make_payload(RingBufferView::STREAMING_COPY_THRESHOLD + i * 1111, static_cast<u8>(i));
+    IAT_CHECK(rb.push(1, data).has_value());
+
+    const auto pop_res = rb.pop(header, Span<u8>(out));
+    IAT_CHECK(pop_res.has_value() && pop_res->has_value());
+    IAT_CHECK(std::equal(data.begin(), data.end(), out.begin()));
+  }
+
+  return true;
+}
+
+auto test_monotonic() -> bool
+{
+  Mut<Vec<u8>> memory(BUFFER_SIZE);
+  auto rb_res = RingBufferView::create(Span<u8>(memory), true, RingBufferView::FLAG_MONOTONIC);
+  IAT_CHECK(rb_res.has_value());
+  Mut<RingBufferView> rb = *rb_res;
+
+  // Other views pick the layout up from the ControlBlock
+  Mut<RingBufferView> consumer = *RingBufferView::create(Span<u8>(memory), false);
+  Mut<RingBufferView::ControlBlock *> cb = rb.get_control_block();
+
+  Mut<RingBufferView::PacketHeader> header;
+  Mut<Vec<u8>> out(64);
+
+  // The whole capacity is usable, no byte is kept free
+  const Vec<u8> payload = make_payload(64 - sizeof(RingBufferView::PacketHeader), 3);
+  IAT_CHECK(rb.push(1, payload).has_value());
+  IAT_CHECK_NOT(rb.push(2, Span<const u8>()).has_value());
+
+  IAT_CHECK(consumer.pop(header, Span<u8>(out)).has_value());
+  IAT_CHECK(std::equal(payload.begin(), payload.end(), out.begin()));
+
+  // Cursors keep counting past the capacity
+  IAT_CHECK_EQ(cb->producer.write_offset.load(), static_cast<u64>(64));
+  IAT_CHECK_EQ(cb->consumer.read_offset.load(), static_cast<u64>(64));
+
+  for (Mut<u32> i = 0; i < 100; i++)
+  {
+    const Vec<u8> data = make_payload(1 + i % 40, static_cast<u8>(i));
+    IAT_CHECK(rb.push(static_cast<u16>(i + 1), data).has_value());
+
+    const auto pop_res = consumer.pop(header, Span<u8>(out));
+    IAT_CHECK(pop_res.has_value());
+    IAT_CHECK(pop_res->has_value());
+    IAT_CHECK_EQ(header.id, static_cast<u16>(i + 1));
+    IAT_CHECK(std::equal(data.begin(), data.end(), out.begin()));
+  }
+
+  const auto span_res = rb.reserve(7, 30);
+  IAT_CHECK(span_res.has_value());
+  rb.commit();
+  const auto packet = consumer.peek();
+  IAT_CHECK(packet.has_value());
+  IAT_CHECK_EQ(packet->first.size(), static_cast<usize>(30));
+  consumer.consume();
+
+  IAT_CHECK_EQ(cb->consumer.read_offset.load(), cb->producer.write_offset.load());
+  IAT_CHECK(cb->producer.write_offset.load() > 64);
+
+  return true;
+}
+
+auto test_monotonic_requires_power_of_two() -> bool
+{
+  Mut<Vec<u8>> memory(BUFFER_SIZE + 8);
+  IAT_CHECK_NOT(RingBufferView::create(Span<u8>(memory), true, RingBufferView::FLAG_MONOTONIC).has_value());
+  IAT_CHECK(RingBufferView::create(Span<u8>(memory), true).has_value());
+
+  return true;
+}
+
+auto test_stats() -> bool
+{
+  Mut<Vec<u8>> memory(BUFFER_SIZE);
+  Mut<RingBufferView> rb = *RingBufferView::create(Span<u8>(memory), true, RingBufferView::FLAG_STATS);
+
+  const Vec<u8> payload = make_payload(10, 0);
+  IAT_CHECK(rb.push(1, payload).has_value());
+
+  // Two reservations published by one commit
+  IAT_CHECK(rb.reserve(2, 6).has_value());
+  IAT_CHECK(rb.reserve(3, 2).has_value());
+  rb.commit();
+
+  const Vec<u8> large = make_payload(40, 0);
+  IAT_CHECK_NOT(rb.push(4, large).has_value());
+
+  const auto pushed = rb.get_stats();
+  IAT_CHECK_EQ(pushed.packets_pushed, static_cast<u64>(3));
+  IAT_CHECK_EQ(pushed.bytes_pushed, static_cast<u64>(14 + 10 + 6));
+  IAT_CHECK_EQ(pushed.high_water_mark, static_cast<u64>(30));
+  IAT_CHECK_EQ(pushed.full_rejections, static_cast<u64>(1));
+  IAT_CHECK_EQ(pushed.packets_popped, static_cast<u64>(0));
+  IAT_CHECK(pushed.last_push_ns > 0);
+
+  IAT_CHECK_EQ(rb.consume_all([](Ref<RingBufferView::PacketView>) {}), static_cast<usize>(3));
+
+  // A view that never pushes or pops reads the same counters
+  const RingBufferView observer = *RingBufferView::create(Span<u8>(memory), false);
+  const auto popped = observer.get_stats();
+  IAT_CHECK_EQ(popped.packets_popped, static_cast<u64>(3));
+  IAT_CHECK_EQ(popped.bytes_popped, static_cast<u64>(30));
+  IAT_CHECK(popped.last_pop_ns >= pushed.last_push_ns);
+
+  Mut<Vec<u8>> plain_memory(BUFFER_SIZE);
+  Mut<RingBufferView> plain = *RingBufferView::create(Span<u8>(plain_memory), true);
+  IAT_CHECK(plain.push(1, payload).has_value());
+  IAT_CHECK_EQ(plain.get_stats().packets_pushed, static_cast<u64>(0));
+
+  return true;
+}
+
+IAT_BEGIN_TEST_LIST()
+IAT_ADD_TEST(test_push_pop);
+IAT_ADD_TEST(test_reserve_commit);
+IAT_ADD_TEST(test_reserve_wrap_is_contiguous);
+IAT_ADD_TEST(test_peek_consume);
+IAT_ADD_TEST(test_peek_wrapped_payload);
+IAT_ADD_TEST(test_batch);
+IAT_ADD_TEST(test_cached_cursors);
+IAT_ADD_TEST(test_threaded_transfer);
+IAT_ADD_TEST(test_wait);
+IAT_ADD_TEST(test_wait_requires_flag);
+IAT_ADD_TEST(test_reserved_ids);
+IAT_ADD_TEST(test_full);
+IAT_ADD_TEST(test_large_transfer);
+IAT_ADD_TEST(test_large_truncated);
+IAT_ADD_TEST(test_aligned);
+IAT_ADD_TEST(test_streaming_copy);
+IAT_ADD_TEST(test_monotonic);
+IAT_ADD_TEST(test_monotonic_requires_power_of_two);
+IAT_ADD_TEST(test_stats);
+IAT_END_TEST_LIST()
+
+IAT_END_BLOCK()
+
+IAT_REGISTER_ENTRY(Core, RingBuffer)
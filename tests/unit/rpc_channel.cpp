@@ -0,0 +1,190 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <crux/adt/rpc_channel.hpp>
+#include <iatest/iatest.hpp>
+
+#include <thread>
+
+using namespace ia;
+
+IAT_BEGIN_BLOCK(Core, RpcChannel)
+
+static constexpr const u32 RING_CAPACITY = 256;
+
+auto make_memory() -> Vec<u64>
+{
+  // u64 storage keeps both ControlBlocks 8 byte aligned
+  return Vec<u64>(rpc::get_buffer_size(RING_CAPACITY) / sizeof(u64));
+}
+
+auto as_bytes(MutRef<Vec<u64>> memory) -> Span<u8>
+{
+  return Span<u8>(reinterpret_cast<u8 *>(memory.data()), memory.size() * sizeof(u64));
+}
+
+auto as_u32(Ref<rpc::Message> message) -> u32
+{
+  Mut<u32> value = 0;
+  std::memcpy(&value, message.data.data(), sizeof(value));
+  return value;
+}
+
+auto test_call_serve() -> bool
+{
+  Mut<Vec<u64>> memory = make_memory();
+  auto client_res = RpcClient::create(as_bytes(memory), true);
+  IAT_CHECK(client_res.has_value());
+  auto server_res = RpcServer::create(as_bytes(memory), false);
+  IAT_CHECK(server_res.has_value());
+
+  Mut<RpcClient> client = *client_res;
+  Mut<RpcServer> server = *server_res;
+
+  const u32 a = 20;
+  const u32 b = 22;
+  const auto first = client.call(1, Span<const u8>(reinterpret_cast<const u8 *>(&a), sizeof(a)));
+  const auto second = client.call(2, Span<const u8>(reinterpret_cast<const u8 *>(&b), sizeof(b)));
+  IAT_CHECK(first.has_value() && second.has_value());
+  IAT_CHECK_EQ(client.get_pending_count(), static_cast<u64>(2));
+
+  IAT_CHECK_NOT(client.poll(*first, [](Ref<rpc::Message>) {}));
+
+  // Echoes the method times the argument
+  Mut<u32> reply_value = 0;
+  const usize served = server.serve([&](Ref<rpc::Message> request) -> Span<const u8> {
+    reply_value = as_u32(request) * request.method;
+    return Span<const u8>(reinterpret_cast<const u8 *>(&reply_value), sizeof(reply_value));
+  });
+  IAT_CHECK_EQ(served, static_cast<usize>(2));
+
+  // Polling the second call hands over the first reply on the way
+  Mut<Vec<u32>> replies;
+  IAT_CHECK(client.poll(*second, [&](Ref<rpc::Message> reply) { replies.push_back(as_u32(reply)); }));
+  IAT_CHECK(replies == (Vec<u32>{20, 44}));
+  IAT_CHECK(client.poll(*first, [](Ref<rpc::Message>) {}));
+  IAT_CHECK_EQ(client.get_pending_count(), static_cast<u64>(0));
+
+  return true;
+}
+
+auto test_reserved_method() -> bool
+{
+  Mut<Vec<u64>> memory = make_memory();
+  Mut<RpcClient> client = *RpcClient::create(as_bytes(memory), true);
+
+  IAT_CHECK_NOT(client.call(RingBufferView::PACKET_ID_SKIP, {}).has_value());
+  IAT_CHECK_NOT(client.call(RingBufferView::PACKET_ID_FRAGMENT, {}).has_value());
+
+  Mut<Vec<u8>> odd(rpc::get_buffer_size(RING_CAPACITY) + 2);
+  IAT_CHECK_NOT(RpcClient::create(Span<u8>(odd), true).has_value());
+
+  return true;
+}
+
+auto test_backlog() -> bool
+{
+  Mut<Vec<u64>> memory = make_memory();
+  Mut<RpcClient> client = *RpcClient::create(as_bytes(memory), true);
+  Mut<RpcServer> server = *RpcServer::create(as_bytes(memory), false);
+
+  // Replies much larger than the requests overflow the response ring
+  static constexpr const u32 CALL_COUNT = 8;
+  for (Mut<u32> i = 0; i < CALL_COUNT; i++)
+  {
+    IAT_CHECK(client.call(1, Span<const u8>(reinterpret_cast<const u8 *>(&i), sizeof(i))).has_value());
+  }
+
+  Mut<u8> reply[64] = {};
+  const auto handler = [&](Ref<rpc::Message> request) -> Span<const u8> {
+    std::memcpy(reply, request.data.data(), sizeof(u32));
+    return Span<const u8>(reply);
+  };
+
+  IAT_CHECK_EQ(server.serve(handler), static_cast<usize>(CALL_COUNT));
+
+  Mut<Vec<u32>> received;
+  const auto collect = [&](Ref<rpc::Message> message) {
+    received.push_back(as_u32(message));
+  };
+
+  while (received.size() < CALL_COUNT)
+  {
+    const usize before = received.size();
+    client.poll_all(collect);
+    server.serve(handler);
+    IAT_CHECK(received.size() > before || client.get_pending_count() > 0);
+  }
+
+  for (Mut<u32> i = 0; i < CALL_COUNT; i++)
+  {
+    IAT_CHECK_EQ(received[i], i);
+  }
+
+  return true;
+}
+
+auto test_threaded_round_trips() -> bool
+{
+  static constexpr const u32 CALL_COUNT = 5000;
+
+  Mut<Vec<u64>> memory = make_memory();
+  Mut<RpcClient> client = *RpcClient::create(as_bytes(memory), true);
+  Mut<RpcServer> server = *RpcServer::create(as_bytes(memory), false);
+
+  Mut<std::atomic<bool>> running{true};
+  Mut<std::thread> server_thread([&]() {
+    Mut<u32> reply_value = 0;
+    server.serve_loop(
+        [&](Ref<rpc::Message> request) -> Span<const u8> {
+          reply_value = as_u32(request) + 1;
+          return Span<const u8>(reinterpret_cast<const u8 *>(&reply_value), sizeof(reply_value));
+        },
+        running);
+  });
+
+  Mut<bool> all_correct = true;
+  for (Mut<u32> i = 0; i < CALL_COUNT; i++)
+  {
+    const auto call = client.call(7, Span<const u8>(reinterpret_cast<const u8 *>(&i), sizeof(i)));
+    if (!call)
+    {
+      all_correct = false;
+      break;
+    }
+
+    Mut<u32> value = 0;
+    all_correct = all_correct && client.wait(*call, [&](Ref<rpc::Message> reply) { value = as_u32(reply); }, 5000);
+    all_correct = all_correct && value == i + 1;
+  }
+
+  running = false;
+  server_thread.join();
+
+  IAT_CHECK(all_correct);
+
+  return true;
+}
+
+IAT_BEGIN_TEST_LIST()
+IAT_ADD_TEST(test_call_serve);
+IAT_ADD_TEST(test_reserved_method);
+IAT_ADD_TEST(test_backlog);
+IAT_ADD_TEST(test_threaded_round_trips);
+IAT_END_TEST_LIST()
+
+IAT_END_BLOCK()
+
+IAT_REGISTER_ENTRY(Core, RpcChannel)
@@ -0,0 +1,200 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <crux/shared_memory.hpp>
+#include <iatest/iatest.hpp>
+
+using namespace ia;
+
+IAT_BEGIN_BLOCK(Core, SharedMemory)
+
+auto make_segment_name(Ref<String> tag) -> String
+{
+  const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+  return "iacrux_test_" + tag + "_" + std::to_string(now);
+}
+
+auto test_create_open() -> bool
+{
+  const String name = make_segment_name("create_open");
+
+  auto owner_res = SharedMemory::create(name, 1000);
+  IAT_CHECK(owner_res.has_value());
+  Mut<SharedMemory> owner = std::move(*owner_res);
+  IAT_CHECK(owner.is_valid());
+  IAT_CHECK(owner.get_data().size() >= 1000);
+
+  // Creating the same name twice must fail instead of silently sharing the segment
+  IAT_CHECK_NOT(SharedMemory::create(name, 1000).has_value());
+
+  auto peer_res = SharedMemory::open(name);
+  IAT_CHECK(peer_res.has_value());
+  Mut<SharedMemory> peer = std::move(*peer_res);
+  IAT_CHECK_EQ(peer.get_data().size(), owner.get_data().size());
+
+  owner.get_data()[0] = 0x5A;
+  IAT_CHECK_EQ(peer.get_data()[0], static_cast<u8>(0x5A));
+
+  IAT_CHECK(SharedMemory::unlink(name).has_value());
+  IAT_CHECK_NOT(SharedMemory::open(name).has_value());
+
+  // Mappings outlive the name
+  IAT_CHECK_EQ(peer.get_data()[0], static_cast<u8>(0x5A));
+
+  return true;
+}
+
+auto test_ring_across_mappings() -> bool
+{
+  const String name = make_segment_name("ring");
+
+  Mut<SharedMemory> owner = std::move(*SharedMemory::create(name, 4096));
+  Mut<SharedMemory> peer = std::move(*SharedMemory::open(name));
+
+  auto producer_res = owner.create_ring_buffer(true);
+  IAT_CHECK(producer_res.has_value());
+  auto consumer_res = peer.create_ring_buffer(false);
+  IAT_CHECK(consumer_res.has_value());
+
+  Mut<RingBufferView> producer = *producer_res;
+  Mut<RingBufferView> consumer = *consumer_res;
+
+  const u8 payload[] = {1, 2, 3, 4, 5};
+  IAT_CHECK(producer.push(9, Span<const u8>(payload)).has_value());
+
+  Mut<RingBufferView::PacketHeader> header;
+  Mut<u8> out[16]{};
+  const auto pop_res = consumer.pop(header, Span<u8>(out));
+  IAT_CHECK(pop_res.has_value());
+  IAT_CHECK(pop_res->has_value());
+  IAT_CHECK_EQ(**pop_res, sizeof(payload));
+  IAT_CHECK_EQ(header.id, static_cast<u16>(9));
+  IAT_CHECK(std::equal(std::begin(payload), std::end(payload), out));
+
+  IAT_CHECK(SharedMemory::unlink(name).has_value());
+
+  return true;
+}
+
+auto test_version_mismatch() -> bool
+{
+  const String name = make_segment_name("version");
+
+  Mut<SharedMemory> owner = std::move(*SharedMemory::create(name, 256));
+  owner.get_header()->version = SharedMemory::SEGMENT_VERSION + 1;
+
+  IAT_CHECK_NOT(SharedMemory::open(name).has_value());
+
+  IAT_CHECK(SharedMemory::unlink(name).has_value());
+
+  return true;
+}
+
+auto test_move() -> bool
+{
+  const String name = make_segment_name("move");
+
+  Mut<SharedMemory> a = std::move(*SharedMemory::create(name, 256));
+  Mut<SharedMemory> b = std::move(a);
+  IAT_CHECK_NOT(a.is_valid());
+  IAT_CHECK(b.is_valid());
+  IAT_CHECK(a.get_data().empty());
+
+  IAT_CHECK(SharedMemory::unlink(name).has_value());
+
+  return true;
+}
+
+#if IA_PLATFORM_LINUX
+auto test_mirrored() -> bool
+{
+  const String name = make_segment_name("mirrored");
+
+  Mut<SharedMemory::Options> options{};
+  options.mirrored = true;
+
+  auto owner_res = SharedMemory::create(name, 4000, options);
+  IAT_CHECK(owner_res.has_value());
+  Mut<SharedMemory> owner = std::move(*owner_res);
+  Mut<SharedMemory> mirrored_peer = std::move(*SharedMemory::open(name, options));
+  Mut<SharedMemory> plain_peer = std::move(*SharedMemory::open(name));
+
+  // The data region is rounded up to whole pages and shows up again right behind itself
+  const Span<u8> data = owner.get_data();
+  IAT_CHECK(data.size() >= 4000);
+  data[0] = 0x11;
+  IAT_CHECK_EQ(data.data()[data.size()], static_cast<u8>(0x11));
+  data.data()[data.size() + 1] = 0x22;
+  IAT_CHECK_EQ(data[1], static_cast<u8>(0x22));
+  IAT_CHECK_EQ(plain_peer.get_data()[1], static_cast<u8>(0x22));
+
+  Mut<RingBufferView> producer = *owner.create_ring_buffer(true);
+  Mut<RingBufferView> mirrored_consumer = *mirrored_peer.create_ring_buffer(false);
+  Mut<RingBufferView> plain_consumer = *plain_peer.create_ring_buffer(false);
+
+  // Move the cursors close to the end of the buffer
+  const usize capacity = data.size();
+  const Vec<u8> filler(capacity - 100, 0);
+  IAT_CHECK(producer.push(1, filler).has_value());
+  Mut<RingBufferView::PacketHeader> header;
+  Mut<Vec<u8>> out(capacity);
+  IAT_CHECK(mirrored_consumer.pop(header, Span<u8>(out)).has_value());
+
+  // A payload straddling the end needs no skip record and stays contiguous
+  const auto span_res = producer.reserve(2, 200);
+  IAT_CHECK(span_res.has_value());
+  for (Mut<usize> i = 0; i < span_res->size(); i++)
+  {
+    (*span_res)[i] = static_cast<u8>(i);
+  }
+  producer.commit();
+
+  const auto plain_packet = plain_consumer.peek();
+  IAT_CHECK(plain_packet.has_value());
+  IAT_CHECK_EQ(plain_packet->header.id, static_cast<u16>(2));
+  IAT_CHECK_NOT(plain_packet->second.empty());
+  IAT_CHECK_EQ(plain_packet->first.size() + plain_packet->second.size(), static_cast<usize>(200));
+
+  const auto mirrored_packet = mirrored_consumer.peek();
+  IAT_CHECK(mirrored_packet.has_value());
+  IAT_CHECK_EQ(mirrored_packet->first.size(), static_cast<usize>(200));
+  IAT_CHECK(mirrored_packet->second.empty());
+  IAT_CHECK_EQ(mirrored_packet->first[199], static_cast<u8>(199));
+
+  // Opening a plain segment mirrored is refused
+  const String plain_name = make_segment_name("not_mirrored");
+  Mut<SharedMemory> plain = std::move(*SharedMemory::create(plain_name, 256));
+  IAT_CHECK_NOT(SharedMemory::open(plain_name, options).has_value());
+
+  IAT_CHECK(SharedMemory::unlink(plain_name).has_value());
+  IAT_CHECK(SharedMemory::unlink(name).has_value());
+
+  return true;
+}
+#endif
+
+IAT_BEGIN_TEST_LIST()
+IAT_ADD_TEST(test_create_open);
+IAT_ADD_TEST(test_ring_across_mappings);
+IAT_ADD_TEST(test_version_mismatch);
+IAT_ADD_TEST(test_move);
+#if IA_PLATFORM_LINUX
+IAT_ADD_TEST(test_mirrored);
+#endif
+IAT_END_TEST_LIST()
+
+IAT_END_BLOCK()
+
+IAT_REGISTER_ENTRY(Core, SharedMemory)
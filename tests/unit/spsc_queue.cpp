@@ -0,0 +1,130 @@
+// IACrux; The Core Library for All IA Open Source Projects
+// Copyright (C) 2026 IAS (ias@iasoft.dev)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <crux/adt/spsc_queue.hpp>
+#include <iatest/iatest.hpp>
+
+#include <memory>
+#include <thread>
+
+using namespace ia;
+
+IAT_BEGIN_BLOCK(Core, SpscQueue)
+
+auto test_push_pop() -> bool
+{
+  Mut<SpscQueue<u32, 4>> queue;
+  IAT_CHECK(queue.is_empty());
+  IAT_CHECK_NOT(queue.pop().has_value());
+
+  IAT_CHECK(queue.push(1));
+  IAT_CHECK(queue.emplace(2u));
+  IAT_CHECK_EQ(queue.get_size(), static_cast<usize>(2));
+
+  IAT_CHECK_EQ(*queue.front(), static_cast<u32>(1));
+  IAT_CHECK_EQ(*queue.pop(), static_cast<u32>(1));
+  IAT_CHECK_EQ(*queue.pop(), static_cast<u32>(2));
+  IAT_CHECK_NOT(queue.pop().has_value());
+  IAT_CHECK(queue.front() == nullptr);
+
+  return true;
+}
+
+auto test_full_and_wrap() -> bool
+{
+  Mut<SpscQueue<u32, 4>> queue;
+
+  for (Mut<u32> lap = 0; lap < 3; lap++)
+  {
+    for (Mut<u32> i = 0; i < 4; i++)
+    {
+      IAT_CHECK(queue.push(lap * 4 + i));
+    }
+    IAT_CHECK_NOT(queue.push(99));
+
+    for (Mut<u32> i = 0; i < 4; i++)
+    {
+      IAT_CHECK_EQ(*queue.pop(), lap * 4 + i);
+    }
+  }
+
+  return true;
+}
+
+auto test_move_only() -> bool
+{
+  Mut<SpscQueue<std::unique_ptr<u32>, 2>> queue;
+
+  IAT_CHECK(queue.push(std::make_unique<u32>(7)));
+  IAT_CHECK(queue.emplace(new u32(8)));
+
+  // A failed push leaves the argument alone
+  Mut<std::unique_ptr<u32>> rejected = std::make_unique<u32>(9);
+  IAT_CHECK_NOT(queue.push(std::move(rejected)));
+  IAT_CHECK(rejected != nullptr);
+
+  const auto first = queue.pop();
+  IAT_CHECK(first.has_value());
+  IAT_CHECK_EQ(**first, static_cast<u32>(7));
+
+  // The destructor releases the element still in the queue
+  return true;
+}
+
+auto test_threaded() -> bool
+{
+  static constexpr const u32 COUNT = 200000;
+
+  Mut<SpscQueue<u32, 256>> queue;
+
+  Mut<std::thread> producer([&queue]() {
+    for (Mut<u32> i = 0; i < COUNT;)
+    {
+      if (queue.push(i))
+      {
+        i++;
+      }
+    }
+  });
+
+  Mut<bool> in_order = true;
+  for (Mut<u32> expected = 0; expected < COUNT;)
+  {
+    const auto value = queue.pop();
+    if (value.has_value())
+    {
+      in_order = in_order && *value == expected;
+      expected++;
+    }
+  }
+
+  producer.join();
+
+  IAT_CHECK(in_order);
+  IAT_CHECK(queue.is_empty());
+
+  return true;
+}
+
+IAT_BEGIN_TEST_LIST()
+IAT_ADD_TEST(test_push_pop);
+IAT_ADD_TEST(test_full_and_wrap);
+IAT_ADD_TEST(test_move_only);
+IAT_ADD_TEST(test_threaded);
+IAT_END_TEST_LIST()
+
+IAT_END_BLOCK()
+
+IAT_REGISTER_ENTRY(Core, SpscQueue)
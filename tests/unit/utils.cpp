@@ -13,6 +13,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <crux/platform.hpp>
 #include <crux/utils.hpp>
 #include <iatest/iatest.hpp>
 
@@ -153,6 +154,34 @@ auto test_hash_macro() -> bool
   return true;
 }
 
+auto test_copy_non_temporal() -> bool
+{
+  // Fills in platform::get_capabilities(), so the AVX2 path runs where the CPU has it
+  (void) platform::check_cpu();
+
+  Mut<Vec<u8>> src(5000);
+  for (Mut<usize> i = 0; i < src.size(); i++)
+  {
+    src[i] = static_cast<u8>(i * 7);
+  }
+
+  // Every destination misalignment, with sizes around the 32/128 byte steps
+  for (Mut<usize> offset = 0; offset < 33; offset++)
+  {
+    for (const usize size : {usize(0), usize(31), usize(32), usize(127), usize(128), usize(4099)})
+    {
+      Mut<Vec<u8>> dst(size + 64, 0xEE);
+      utils::copy_non_temporal(dst.data() + offset, src.data(), size);
+
+      IAT_CHECK(std::equal(src.begin(), src.begin() + size, dst.begin() + offset));
+      IAT_CHECK(offset == 0 || dst[offset - 1] == 0xEE);
+      IAT_CHECK_EQ(dst[offset + size], static_cast<u8>(0xEE));
+    }
+  }
+
+  return true;
+}
+
 IAT_BEGIN_TEST_LIST()
 IAT_ADD_TEST(test_hex_conversion);
 IAT_ADD_TEST(test_hex_errors);
@@ -160,6 +189,7 @@ IAT_ADD_TEST(test_sort);
 IAT_ADD_TEST(test_binary_search);
 IAT_ADD_TEST(test_hash_basics);
 IAT_ADD_TEST(test_hash_macro);
+IAT_ADD_TEST(test_copy_non_temporal);
 IAT_END_TEST_LIST()
 
 IAT_END_BLOCK()